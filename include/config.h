@@ -14,6 +14,32 @@
 // Set to 1 to scan for I2C address, 0 for normal operation
 #define I2C_SCAN_MODE       0
 
+// Set to 1 to measure HID, LCD, I2C, digitalRead and delay() timing and
+// print a BENCH,... summary on Serial instead of running a payload
+#define BENCH_MODE          0
+#define BENCH_HID_REPORTS   500         // Empty reports sent (nothing is typed)
+#define BENCH_LCD_SAMPLES   20
+#define BENCH_WIRE_SAMPLES  200
+#define BENCH_DELAY_SAMPLES 100
+
+// CHAIN MODE: Set to 1 so BIOS mode (D7 only removed) continues into
+// the Win10 install: after the password is cleared the device waits for
+// the target to reboot (USB re-enumeration) and starts spamming F12
+#define CHAIN_PAYLOADS      0
+#define CHAIN_REBOOT_TIMEOUT 120000     // Give up if no reboot within 2 min
+
+// PAYLOAD MENU: Set to 1 to pick payload and timing profile on the LCD
+// after removing D7 (tap D7 = next, hold 1s and let go = run) instead
+// of by the D10 wire. The last choice is remembered. Needs someone at
+// the device, so pick before the target starts its POST.
+#define PAYLOAD_MENU        0
+
+// BATCH MODE: Set to 1 to keep going after a payload. Unplug the
+// finished machine and plug into the next one; the same payload runs
+// again as soon as the new target enumerates us (wires must stay as
+// armed). Needs the Leonardo powered on its own, not only from USB.
+#define BATCH_MODE          0
+
 // DEMO MODE: Set to 1 to simulate without sending keystrokes
 // Shows all actions on LCD/Serial but keyboard is disabled
 #define DEMO_MODE           0
@@ -30,6 +56,14 @@
 // ===========================================
 #define ARM_HOLD_TIME       3000    // Hold button for 3 seconds to arm
 #define BUTTON_DEBOUNCE     50      // Debounce delay in ms
+#define SAFETY_RECONNECT_TIME 2000  // D7 held to GND this long = safety back on
+
+// ===========================================
+// Touch Gestures (D7 wire touched to GND once armed)
+// ===========================================
+#define TOUCH_DEBOUNCE      20      // Wire must be stable this long (ms)
+#define DOUBLE_TOUCH_WINDOW 400     // Second touch within this = double (ms)
+#define LONG_TOUCH_TIME     1000    // Held this long = long touch (ms)
 
 // ===========================================
 // I2C LCD Configuration (HW-061 Backpack)
@@ -46,6 +80,13 @@
 #define BOOT_KEY            KEY_F12     // Dell boot menu key
 #define BOOT_MENU_POSITION  2           // 3rd option (0-indexed: 2 = DOWN twice)
 
+// Adjustment windows (BIOS ADJUST / USB ADJUST)
+// The last confirmed extra-DOWN count is saved per payload and applied
+// right away next run; then only a short correction window opens.
+// Touch D7 = DOWN, long touch = UP, double touch = confirm now.
+#define ADJUST_CONFIRM_WINDOW   4       // Seconds to correct a learned position
+#define MAX_EXTRA_DOWNS         15      // Sanity limit for saved positions
+
 // ===========================================
 // Timing Configuration (milliseconds)
 // ===========================================
@@ -61,17 +102,164 @@
 #define OOBE_WAIT_TIME      1800        // Seconds to wait for OOBE (30 min for install)
 #define OOBE_SCREEN_DELAY   3000        // Delay between OOBE screens
 
+// Gaps inside the payloads
+#define NAV_KEY_GAP         300         // After a navigation key (BIOS, Setup)
+#define TYPE_SETTLE         200         // After typing the password
+#define SETUP_TAB_GAP       200         // Between Tabs on the Setup start screen
+#define LIST_STEP_GAP       80          // Moving to the top of the partition list
+#define LIST_FAST_GAP       60          // Moving to the other end between sweeps
+#define LIST_SETTLE         200         // After reaching the end of the list
+#define HEADER_SKIP_GAP     100         // After stepping past the drive header
+#define DELETE_KEY_GAP      400         // Tab / Right to the Delete link
+#define NEXT_TAB_GAP        120         // Tabbing to the Next button
+#define FINAL_ENTER_WAIT    500         // After the last Enter
+#define ADJUST_TOUCH_GAP    200         // After the key from a D7 touch
+#define ADJUST_DONE_WAIT    500         // Showing the adjustment result
+
+// The values above are only defaults: the device keeps its own copy in
+// EEPROM, changed with "get" / "set" on the Serial console (see
+// timing_config.h). "defaults" goes back to these.
+
+// ===========================================
+// Self-Tuning Waits (milliseconds)
+// ===========================================
+// Each step's length is learned and kept in EEPROM. A good run shrinks
+// every step it used by 1/TUNE_SHRINK_DIV. A run marked failed (double
+// touch D7 on the DONE screen) or holding D7 during a wait ("not ready
+// yet") grows the step by 1/TUNE_GROW_DIV. Never outside floor/ceiling.
+//                              default floor  ceiling
+#define TUNE_BIOS_LOAD          5000,   2000,  10000
+#define TUNE_BIOS_DIALOG        500,    250,   1500
+#define TUNE_SETUP_LOAD         30000,  12000, 60000   // Probe timeout
+#define TUNE_SETUP_SCREEN       30000,  8000,  60000
+#define TUNE_PARTITION_LOAD     4000,   1500,  10000
+#define TUNE_DELETE_CLICK       500,    250,   1500
+#define TUNE_DELETE_CONFIRM     600,    300,   2000
+#define TUNE_INSTALL_START      800,    400,   2500
+#define TUNE_SHRINK_DIV         32      // ~3% shorter after a good run
+#define TUNE_GROW_DIV           4       // 25% longer after a failure
+#define TUNE_GESTURE_MIN_WAIT   2000    // Shorter waits: no countdown/gesture
+#define RUN_OUTCOME_WINDOW      120000  // How long a run can be marked failed
+
+// ===========================================
+// Readiness Probing (milliseconds)
+// ===========================================
+// Instead of sleeping a fixed time while Windows Setup loads, press
+// Num Lock until the target echoes the LED change, then wait
+// READY_SETTLE_TIME and continue. Only echoes after WinPE has
+// enumerated the keyboard again count. The old fixed wait is kept as
+// the upper timeout.
+#define HOST_LED_CAPTURE        1       // 1 = add LED output report to HID
+#define HOST_LED_REPORT_ID      5       // Report ID for the LED collection
+#define READY_PROBE_INTERVAL    1000    // Num Lock press interval
+#define READY_SETTLE_TIME       1500    // Wait after the first echo
+#define READY_MIN_SETUP_LOAD    8000    // Skip the firmware/boot loader phase
+
+// ===========================================
+// Payload IDs
+// ===========================================
+#define PAYLOAD_BIOS        0           // BIOS password removal
+#define PAYLOAD_WIN10       1           // Windows 10 clean install
+#define PAYLOAD_CHAIN       2           // BIOS password, reboot, Win10 install
+#define PAYLOAD_SCRIPT      3           // Key script taught over Serial (see Teach Mode)
+#define PAYLOAD_COUNT       4
+
+// Timing profiles (picked in the payload menu)
+#define PROFILE_TUNED       0           // Learned waits (see Self-Tuning Waits)
+#define PROFILE_SAFE        1           // Config defaults, nothing learned
+#define PROFILE_SLOW        2           // Defaults x2 for old machines, nothing learned
+#define PROFILE_COUNT       3
+
+// ===========================================
+// EEPROM Layout (ATmega32u4: 1024 bytes)
+// ===========================================
+#define EEPROM_BOOT_POS_ADDR    0x000   // Learned boot positions (16 bytes)
+#define EEPROM_STATE_ADDR       0x010   // Chain stage, machine count, menu (16 bytes)
+#define EEPROM_TUNING_ADDR      0x020   // Learned wait lengths (32 bytes)
+#define EEPROM_CONFIG_ADDR      0x050   // Timing config (up to 112 bytes)
+#define EEPROM_SCRIPT_ADDR      0x0C0   // Uploaded/taught key script
+#define EEPROM_SCRIPT_SIZE      320     // 0x0C0 - 0x1FF
+#define EEPROM_TELEMETRY_ADDR   0x200   // Run records (TELEMETRY_SLOTS x 32 bytes)
+
+// ===========================================
+// Run Telemetry
+// ===========================================
+// Every run writes one record (payload, profile, phase times, keys,
+// touches, retries, outcome) to a ring of EEPROM slots. Each run uses
+// the next slot, so wear is spread over all of them.
+// Serial commands: 'T' = dump as CSV, 'B' = dump binary, 'X' = erase,
+// 'S' = SRAM use and stack high-water per phase of the last run
+#define TELEMETRY_ENABLED   1
+#define TELEMETRY_SLOTS     16          // 16 x 32 bytes = upper half of EEPROM
+
+// ===========================================
+// Serial Console
+// ===========================================
+// Line commands on Serial to arm and steer runs from a terminal:
+// "help" lists them. Runs still need the D7 wire removed.
+#define CONSOLE_ENABLED     1
+#define CONSOLE_ARM_TIMEOUT 30000       // How long an "arm" token stays valid (ms)
+#define CONSOLE_LINE_MAX    24          // Longest command line
+
+// ===========================================
+// Teach Mode
+// ===========================================
+// "teach" on the Serial console: keys typed as console lines go to the
+// target and are recorded into the EEPROM script area with the gap
+// that worked before each one, minus the technician's measured
+// reaction time. The script replays as PAYLOAD_SCRIPT.
+// Set to 0 to leave teach mode out (saves flash); a script uploaded
+// with FRAME_SCRIPT_WRITE still replays. Needs CONSOLE_ENABLED.
+#define TEACH_ENABLED           1
+#define TEACH_MIN_GAP           50      // Shortest gap between script keys (ms)
+#define TEACH_REACTION_TRIALS   3       // Reaction-time trials before teaching
+#define TEACH_REACTION_TIMEOUT  3000    // A trial without Enter by then is ignored (ms)
+#define TEACH_REACTION_DEFAULT  250     // Used when no trial was valid (ms)
+
 // ===========================================
 // Serial Configuration
 // ===========================================
 #define SERIAL_BAUD_RATE    115200
 
+// Log output is buffered in RAM and sent in idle time (see log_buffer.h)
+#define LOG_BUFFER_SIZE     192         // Bytes of SRAM
+#define LOG_IDLE_WAIT       50          // Max wait for the host when full, outside a run (ms)
+
+// ===========================================
+// Timing Probes
+// ===========================================
+// Set to 1 to measure pressKey, showStatus, LCD commands and the
+// adjustment loop in CPU cycles (uses Timer1). 'P' on Serial prints
+// the histograms. 0 = probes compile to nothing.
+#define TIMING_PROBES       0
+#define PROBE_BUCKETS       24          // log2 buckets: 2 us ... 8 s and over
+
+// ===========================================
+// Log Levels
+// ===========================================
+// Tokenized log calls (LOG_INFO etc.) above LOG_LEVEL compile to nothing.
+// DEBUG builds (env:leonardo_debug, native) log everything, including
+// the DEBUG_PRINT text; the default env:leonardo keeps INFO and above.
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+#ifndef LOG_LEVEL
+    #ifdef DEBUG
+        #define LOG_LEVEL   LOG_LEVEL_DEBUG
+    #else
+        #define LOG_LEVEL   LOG_LEVEL_INFO
+    #endif
+#endif
+
 // ===========================================
 // Debug Macros
 // ===========================================
-#ifdef DEBUG
-    #define DEBUG_PRINT(x)      Serial.print(x)
-    #define DEBUG_PRINTLN(x)    Serial.println(x)
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    #define DEBUG_PRINT(x)      Log.print(x)
+    #define DEBUG_PRINTLN(x)    Log.println(x)
 #else
     #define DEBUG_PRINT(x)
     #define DEBUG_PRINTLN(x)
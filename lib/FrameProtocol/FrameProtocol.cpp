@@ -0,0 +1,151 @@
+/**
+ * Frame Protocol Implementation
+ */
+
+#include "FrameProtocol.h"
+
+uint16_t frameCrc16(const uint8_t* data, size_t length, uint16_t crc) {
+    while (length--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t write = 1;
+    uint8_t code = 1;
+
+    for (size_t read = 0; read < length; read++) {
+        if (in[read] == 0) {
+            out[codeIndex] = code;
+            codeIndex = write++;
+            code = 1;
+        } else {
+            out[write++] = in[read];
+            code++;
+            if (code == 0xFF) {
+                // Block full: 254 data bytes, no implied zero
+                out[codeIndex] = code;
+                codeIndex = write++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    return write;
+}
+
+size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < length) {
+        uint8_t code = in[read];
+        if (code == 0 || read + code > length) {
+            return 0;   // Zero inside a frame, or block runs past the end
+        }
+        read++;
+        for (uint8_t i = 1; i < code; i++) {
+            out[write++] = in[read++];
+        }
+        // Every block but a full one and the last implies a zero
+        if (code != 0xFF && read < length) {
+            out[write++] = 0;
+        }
+    }
+    return write;
+}
+
+size_t encodeFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length,
+                   uint8_t* out, size_t outSize) {
+    if (length > FRAME_MAX_PAYLOAD) return 0;
+
+    size_t rawLength = FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE;
+    size_t needed = rawLength + rawLength / 254 + 1 + 2;
+    if (outSize < needed) return 0;
+
+    // Build the raw frame at the end of out, then COBS it to the front.
+    // COBS output never overtakes its input, so this is safe in place.
+    uint8_t* raw = out + outSize - rawLength;
+    raw[0] = type;
+    raw[1] = seq;
+    for (size_t i = 0; i < length; i++) {
+        raw[FRAME_HEADER_SIZE + i] = payload[i];
+    }
+    uint16_t crc = frameCrc16(raw, FRAME_HEADER_SIZE + length);
+    framePutU16(raw + FRAME_HEADER_SIZE + length, crc);
+
+    out[0] = FRAME_DELIMITER;
+    size_t encoded = cobsEncode(raw, rawLength, out + 1);
+    out[1 + encoded] = FRAME_DELIMITER;
+    return encoded + 2;
+}
+
+void frameDecoderReset(FrameDecoder& decoder) {
+    decoder.length = 0;
+    decoder.nextCode = 0;
+    decoder.inFrame = false;
+}
+
+FrameResult frameDecoderPush(FrameDecoder& decoder, uint8_t byte, Frame& frame) {
+    if (!decoder.inFrame) {
+        if (byte != FRAME_DELIMITER) return FRAME_TEXT;
+        decoder.inFrame = true;
+        decoder.length = 0;
+        decoder.nextCode = 0;
+        return FRAME_NONE;
+    }
+
+    if (byte != FRAME_DELIMITER) {
+        // A COBS code whose block runs past the largest frame: this was
+        // never a frame (a stray 0x00 before typed text - every printable
+        // byte is a code of 32 or more) or it got damaged. Back to text
+        // from this byte on, so a console line like "abort" gets through.
+        if (decoder.length == decoder.nextCode) {
+            if (decoder.nextCode + byte > FRAME_MAX_COBS) {
+                decoder.inFrame = false;
+                return FRAME_TEXT;
+            }
+            decoder.nextCode += byte;
+        }
+        if (decoder.length >= sizeof(decoder.buffer)) {
+            decoder.inFrame = false;
+            return FRAME_BAD;
+        }
+        decoder.buffer[decoder.length++] = byte;
+        return FRAME_NONE;
+    }
+
+    // Delimiter: back-to-back zeros are just an empty gap
+    if (decoder.length == 0) {
+        return FRAME_NONE;
+    }
+
+    // Whatever the outcome, the frame is over - a corrupt one must not
+    // keep swallowing the console bytes that follow
+    size_t encodedLength = decoder.length;
+    decoder.length = 0;
+    decoder.inFrame = false;
+
+    size_t rawLength = cobsDecode(decoder.buffer, encodedLength, decoder.buffer);
+    if (rawLength < FRAME_HEADER_SIZE + FRAME_CRC_SIZE ||
+        rawLength > FRAME_MAX_RAW) {
+        return FRAME_BAD;
+    }
+
+    size_t bodyLength = rawLength - FRAME_CRC_SIZE;
+    uint16_t crc = frameGetU16(decoder.buffer + bodyLength);
+    if (crc != frameCrc16(decoder.buffer, bodyLength)) {
+        return FRAME_BAD;
+    }
+
+    frame.type = decoder.buffer[0];
+    frame.seq = decoder.buffer[1];
+    frame.length = bodyLength - FRAME_HEADER_SIZE;
+    frame.payload = decoder.buffer + FRAME_HEADER_SIZE;
+    return FRAME_READY;
+}
@@ -0,0 +1,191 @@
+/**
+ * Frame Protocol
+ *
+ * Binary Serial protocol shared by the firmware and host tools.
+ * No Arduino dependencies and no heap: everything works on caller or
+ * fixed-size buffers, so the same code builds for the ATmega32u4 and
+ * for a PC.
+ *
+ * On the wire:  0x00, COBS( type, seq, payload..., crc16 LE ), 0x00
+ *  - COBS removes every 0x00 from the frame, so 0x00 only ever marks
+ *    frame boundaries and a receiver can resync at the next frame
+ *  - CRC-16/CCITT-FALSE over type, seq and payload
+ *  - Replies use the request type | FRAME_REPLY, or FRAME_NACK
+ * Bytes outside frames are text: one-letter commands from the host, and
+ * from the device the log, whose binary records (src/log_tokens.h) can
+ * hold any byte value. The device escapes 0x00 and FRAME_TEXT_ESCAPE in
+ * its log output (frameTextEscape()), so a log record is never read as
+ * a frame and a frame never as a record. (The one-letter 'B' telemetry
+ * dump is raw binary; hosts that speak frames use FRAME_TELEMETRY.)
+ */
+
+#ifndef FRAME_PROTOCOL_H
+#define FRAME_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAME_MAX_PAYLOAD   48
+#define FRAME_HEADER_SIZE   2       // type, seq
+#define FRAME_CRC_SIZE      2
+#define FRAME_MAX_RAW       (FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + FRAME_CRC_SIZE)
+#define FRAME_MAX_COBS      (FRAME_MAX_RAW + FRAME_MAX_RAW / 254 + 1)
+#define FRAME_MAX_ENCODED   (FRAME_MAX_COBS + 2)    // Plus both delimiters
+#define FRAME_DELIMITER     0x00
+#define FRAME_TEXT_ESCAPE   0x1E    // ASCII record separator, then byte ^ FRAME_TEXT_XOR
+#define FRAME_TEXT_XOR      0x20
+
+// ===========================================
+// Message types
+// ===========================================
+#define FRAME_REPLY             0x80    // Set in every reply type
+
+enum FrameType {
+    FRAME_STATUS            = 0x01,     // -> FrameStatus
+    FRAME_TELEMETRY         = 0x02,     // index u8 -> index u8, count u8, record (32 bytes)
+    FRAME_JOURNAL           = 0x03,     // max u8 -> dropped u16, whole log records
+    FRAME_SCRIPT_WRITE      = 0x04,     // offset u16, data -> offset u16, length u8
+    FRAME_SCRIPT_READ       = 0x05,     // offset u16, length u8 -> offset u16, data
+    FRAME_CONFIG_GET        = 0x06,     // id u8 -> id u8, value u32
+    FRAME_CONFIG_SET        = 0x07,     // id u8, value u32 -> id u8, value u32
+    FRAME_COMMAND           = 0x08,     // code u8, arg u8 -> code u8
+    FRAME_NACK              = 0xFF      // request type u8, error u8
+};
+
+enum FrameCommand {
+    FRAME_CMD_PING              = 0x00,
+    FRAME_CMD_ERASE_TELEMETRY   = 0x01,
+    FRAME_CMD_RESET_PROBES      = 0x02,
+    FRAME_CMD_RAW_LOG           = 0x03  // arg 0 = log only via FRAME_JOURNAL, 1 = raw text again
+};
+
+enum FrameError {
+    FRAME_ERR_UNKNOWN_TYPE  = 0x01,
+    FRAME_ERR_BAD_LENGTH    = 0x02,
+    FRAME_ERR_OUT_OF_RANGE  = 0x03,
+    FRAME_ERR_BUSY          = 0x04,     // Not while a payload runs
+    FRAME_ERR_UNSUPPORTED   = 0x05
+};
+
+// FRAME_STATUS reply payload (little-endian, packed)
+#define FRAME_STATUS_SIZE   14
+// uptime_ms u32, state u8, payload u8, profile u8, phase u8,
+// free_ram u16, log_dropped u16, runs u16
+enum FrameDeviceState {
+    FRAME_STATE_SAFE    = 0,            // D7 connected
+    FRAME_STATE_RUNNING = 1,            // Payload in progress
+    FRAME_STATE_DONE    = 2             // Payload finished, idle
+};
+
+// ===========================================
+// Building blocks
+// ===========================================
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+uint16_t frameCrc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+// COBS encode: out needs length + length / 254 + 1 bytes. Returns bytes written.
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+
+// COBS decode (in and out may be the same buffer). Returns 0 if malformed.
+size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out);
+
+// Little-endian helpers for payload fields
+inline void framePutU16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+inline void framePutU32(uint8_t* out, uint32_t value) {
+    framePutU16(out, value & 0xFFFF);
+    framePutU16(out + 2, value >> 16);
+}
+
+inline uint16_t frameGetU16(const uint8_t* in) {
+    return in[0] | ((uint16_t)in[1] << 8);
+}
+
+inline uint32_t frameGetU32(const uint8_t* in) {
+    return frameGetU16(in) | ((uint32_t)frameGetU16(in + 2) << 16);
+}
+
+// ===========================================
+// Text between frames
+// ===========================================
+
+// Bytes byte takes on the wire outside a frame (1 or 2)
+inline uint8_t frameTextSize(uint8_t byte) {
+    return (byte == FRAME_DELIMITER || byte == FRAME_TEXT_ESCAPE) ? 2 : 1;
+}
+
+// Escape one byte for sending outside a frame. Returns bytes written (1 or 2).
+inline uint8_t frameTextEscape(uint8_t byte, uint8_t* out) {
+    if (frameTextSize(byte) == 1) {
+        out[0] = byte;
+        return 1;
+    }
+    out[0] = FRAME_TEXT_ESCAPE;
+    out[1] = byte ^ FRAME_TEXT_XOR;
+    return 2;
+}
+
+// Undo frameTextEscape() on received FRAME_TEXT bytes. escaped is the
+// caller's state (start false). Returns false for an escape byte, true
+// once byte holds the original value.
+inline bool frameTextUnescape(bool& escaped, uint8_t& byte) {
+    if (escaped) {
+        escaped = false;
+        byte ^= FRAME_TEXT_XOR;
+        return true;
+    }
+    if (byte == FRAME_TEXT_ESCAPE) {
+        escaped = true;
+        return false;
+    }
+    return true;
+}
+
+// ===========================================
+// Frames
+// ===========================================
+
+/**
+ * Build a complete frame including both delimiters.
+ * @return Bytes written to out, 0 if payload is too long or out too small
+ */
+size_t encodeFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length,
+                   uint8_t* out, size_t outSize);
+
+// A received frame. payload points into the decoder's buffer and is
+// valid until the next frameDecoderPush().
+struct Frame {
+    uint8_t type;
+    uint8_t seq;
+    uint8_t length;
+    const uint8_t* payload;
+};
+
+enum FrameResult {
+    FRAME_NONE = 0,         // Byte consumed, nothing complete yet
+    FRAME_READY,            // frame holds a valid frame
+    FRAME_BAD,              // Frame ended but was corrupt (CRC, COBS, length)
+    FRAME_TEXT              // Byte is plain text outside any frame
+};
+
+// Between frames every byte is FRAME_TEXT. A 0x00 starts a frame; the
+// decoder goes back to text at the closing 0x00 (good or corrupt) or as
+// soon as a COBS code makes the frame too long - so typed text after a
+// stray 0x00, its line end included, reaches the console again.
+struct FrameDecoder {
+    uint8_t buffer[FRAME_MAX_COBS];
+    uint8_t length;
+    uint8_t nextCode;       // Index of the next COBS code byte
+    bool inFrame;
+};
+
+void frameDecoderReset(FrameDecoder& decoder);
+
+// Feed one received byte
+FrameResult frameDecoderPush(FrameDecoder& decoder, uint8_t byte, Frame& frame);
+
+#endif // FRAME_PROTOCOL_H
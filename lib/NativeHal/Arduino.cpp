@@ -0,0 +1,247 @@
+/**
+ * Native Arduino Core Implementation
+ */
+
+#include "Arduino.h"
+#include "SimHost.h"
+#include <stdio.h>
+
+// What the calls cost on a 16 MHz ATmega32u4, roughly
+#define TIME_CALL_US        2           // millis() / micros()
+#define PIN_CALL_US         4           // digitalRead() / digitalWrite()
+
+volatile uint8_t TCCR1A, TCCR1B, TIFR1, TIMSK1, SREG;
+volatile uint16_t TCNT1;
+
+USBDevice_ USBDevice;
+Serial_ Serial;
+
+// ===========================================
+// Time
+// ===========================================
+
+unsigned long millis() {
+    simCpu(TIME_CALL_US);
+    return (unsigned long)(simNow() / 1000);
+}
+
+unsigned long micros() {
+    simCpu(TIME_CALL_US);
+    return (unsigned long)simNow();
+}
+
+// Same shape as the AVR core: yield() keeps running while the time passes
+void delay(unsigned long ms) {
+    simWaitStarted(ms);
+    while (ms > 0) {
+        yield();
+        simAdvance(1000);
+        ms--;
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    simAdvance(us);
+}
+
+__attribute__((weak)) void yield() {
+}
+
+// ===========================================
+// Pins and interrupts
+// ===========================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    simPinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    simCpu(PIN_CALL_US);
+    simPinWrite(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+    simCpu(PIN_CALL_US);
+    uint8_t level = simPinRead(pin);
+    simRecordPinRead(pin, level);
+    return level;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode) {
+    simAttachInterrupt(interrupt, handler, mode);
+}
+
+void detachInterrupt(uint8_t interrupt) {
+    simAttachInterrupt(interrupt, NULL, 0);
+}
+
+// Events only run inside waits, never in the middle of a critical section
+void interrupts() {
+}
+
+void noInterrupts() {
+}
+
+long random(long max) {
+    if (max <= 0) return 0;
+    return simRandom() % max;
+}
+
+long random(long min, long max) {
+    if (min >= max) return min;
+    return min + random(max - min);
+}
+
+void randomSeed(unsigned long seed) {
+    simSeedRandom((uint32_t)seed);
+}
+
+// ===========================================
+// USB device and Serial
+// ===========================================
+
+bool USBDevice_::configured() {
+    return simUsbConfigured();
+}
+
+bool USBDevice_::isSuspended() {
+    return false;
+}
+
+int Serial_::available() {
+    return simSerialAvailable();
+}
+
+int Serial_::read() {
+    return simSerialRead(true);
+}
+
+int Serial_::peek() {
+    return simSerialRead(false);
+}
+
+size_t Serial_::write(uint8_t c) {
+    if (!simSerialOpen()) return 0;
+    simSerialWrite(c);
+    return 1;
+}
+
+int Serial_::availableForWrite() {
+    return simSerialAvailableForWrite();
+}
+
+Serial_::operator bool() {
+    return simSerialOpen();
+}
+
+// ===========================================
+// Print
+// ===========================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size--) {
+        if (write(*buffer++) == 0) break;
+        written++;
+    }
+    return written;
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+    char digits[8 * sizeof(long) + 1];
+    char* p = &digits[sizeof(digits) - 1];
+    *p = '\0';
+    if (base < 2) base = 10;
+
+    do {
+        unsigned long digit = value % base;
+        value /= base;
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    } while (value);
+
+    return write(p);
+}
+
+size_t Print::print(const __FlashStringHelper* str) {
+    return write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char* str) {
+    return write(str);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base) {
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base) {
+    return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+    if (base == 10 && value < 0) {
+        size_t n = print('-');
+        return n + printNumber((unsigned long)(-value), 10);
+    }
+    // Other bases print the two's complement, as on the AVR (32 bits)
+    if (base != 10) return printNumber((uint32_t)value, base);
+    return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+    char text[40];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+size_t Print::println() {
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper* str) {
+    return print(str) + println();
+}
+
+size_t Print::println(const char* str) {
+    return print(str) + println();
+}
+
+size_t Print::println(char c) {
+    return print(c) + println();
+}
+
+size_t Print::println(unsigned char value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(int value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits) {
+    return print(value, digits) + println();
+}
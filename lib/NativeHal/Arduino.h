@@ -0,0 +1,149 @@
+/**
+ * Native Arduino Core
+ *
+ * The part of the Arduino AVR core the firmware uses, for building
+ * src/ on a PC ([env:native]). Time is the virtual clock from
+ * SimHost.h: delay() returns at once with the clock moved on.
+ *
+ * Program memory is ordinary memory here. pgm_read_word() reads the
+ * type it points at rather than 16 bits, because the firmware uses it
+ * for PROGMEM pointer tables and pointers are 8 bytes on a PC.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+
+#define CHANGE          1
+#define FALLING         2
+#define RISING          3
+
+#define DEC             10
+#define HEX             16
+#define OCT             8
+#define BIN             2
+
+#define LED_BUILTIN     13
+
+// ===========================================
+// Program memory
+// ===========================================
+class __FlashStringHelper;
+
+#define PROGMEM
+#define PGM_P               const char*
+#define PSTR(s)             (s)
+#define F(s)                (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(addr))
+#define pgm_read_dword(addr) (*(addr))
+#define pgm_read_ptr(addr)  (*(addr))
+#define memcpy_P            memcpy
+#define strlen_P            strlen
+#define strcmp_P            strcmp
+#define strncmp_P           strncmp
+#define strcpy_P            strcpy
+
+// ===========================================
+// Time, pins, interrupts
+// ===========================================
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Called while delay() waits; the firmware may define its own
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+// Any pin can interrupt here; the interrupt number is the pin number
+#define digitalPinToInterrupt(pin)  (pin)
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+void interrupts();
+void noInterrupts();
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+// Timer1 and status registers, so TIMING_PROBES still builds.
+// Nothing counts in them.
+extern volatile uint8_t TCCR1A, TCCR1B, TIFR1, TIMSK1, SREG;
+extern volatile uint16_t TCNT1;
+#define CS10            0
+#define TOV1            0
+#define TOIE1           0
+#define ISR(vector)     extern "C" void vector(void)
+#define cli()           noInterrupts()
+#define sei()           interrupts()
+
+// ===========================================
+// Print / Stream
+// ===========================================
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) {
+        return str ? write((const uint8_t*)str, strlen(str)) : 0;
+    }
+    size_t write(const char* buffer, size_t size) {
+        return write((const uint8_t*)buffer, size);
+    }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper* str);
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println(const __FlashStringHelper* str);
+    size_t println(const char* str);
+    size_t println(char c);
+    size_t println(unsigned char value, int base = DEC);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+    size_t println();
+
+private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#include "USBAPI.h"
+
+#endif // ARDUINO_H
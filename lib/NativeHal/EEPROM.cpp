@@ -0,0 +1,24 @@
+/**
+ * Native EEPROM Implementation
+ */
+
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
+
+uint8_t EEPROMClass::read(int address) {
+    simEepromWait();
+    return simEeprom()[address & (EEPROM_SIZE - 1)];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+    simEepromWait();
+    simEeprom()[address & (EEPROM_SIZE - 1)] = value;
+    simEepromWritten();
+}
+
+void EEPROMClass::update(int address, uint8_t value) {
+    if (read(address) != value) {
+        write(address, value);
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ * Native EEPROM
+ *
+ * 1 KB like the ATmega32u4, kept in SimHost (simLoadEeprom() /
+ * simSaveEeprom() carry it between runs). A write keeps the EEPROM busy
+ * for 3.4 ms, so the next access waits as it does on the chip.
+ */
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include "Arduino.h"
+#include "SimHost.h"
+
+#define EEPROM_SIZE     1024
+
+struct EEPROMClass {
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length() { return EEPROM_SIZE; }
+
+    template <typename T> T& get(int address, T& value) {
+        uint8_t* bytes = (uint8_t*)&value;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = read(address + i);
+        }
+        return value;
+    }
+
+    template <typename T> const T& put(int address, const T& value) {
+        const uint8_t* bytes = (const uint8_t*)&value;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            update(address + i, bytes[i]);
+        }
+        return value;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // EEPROM_H
@@ -0,0 +1,86 @@
+/**
+ * Native PluggableUSB / HID Implementation
+ */
+
+#include "HID.h"
+#include "SimHost.h"
+
+// Data stage of the request PluggableUSB is handing out right now
+static const uint8_t* controlData = NULL;
+static int controlLength = 0;
+
+int USB_RecvControl(void* data, int length) {
+    if (length > controlLength) length = controlLength;
+    if (length > 0) {
+        memcpy(data, controlData, length);
+    }
+    return length;
+}
+
+bool PluggableUSB_::plug(PluggableUSBModule* node) {
+    if (rootNode == NULL) {
+        rootNode = node;
+    } else {
+        PluggableUSBModule* current = rootNode;
+        while (current->next) {
+            current = current->next;
+        }
+        current->next = node;
+    }
+    return true;
+}
+
+bool PluggableUSB_::setup(USBSetup& setup) {
+    for (PluggableUSBModule* node = rootNode; node; node = node->next) {
+        if (node->setup(setup)) return true;
+    }
+    return false;
+}
+
+PluggableUSB_& PluggableUSB() {
+    static PluggableUSB_ instance;
+    return instance;
+}
+
+void HID_::AppendDescriptor(HIDSubDescriptor* node) {
+    if (rootNode == NULL) {
+        rootNode = node;
+    } else {
+        HIDSubDescriptor* current = rootNode;
+        while (current->next) {
+            current = current->next;
+        }
+        current->next = node;
+    }
+    descriptorSize += node->length;
+}
+
+void HID_::SendReport(uint8_t id, const void* data, int length) {
+    (void)id;
+    if (length == 8) {
+        simUsbSendReport((const uint8_t*)data);
+    }
+}
+
+HID_& HID() {
+    static HID_ instance;
+    return instance;
+}
+
+// The PC's SET_REPORT with the report ID in front, as Windows sends it
+void simSendOutputReport(uint8_t reportId, uint8_t data) {
+    uint8_t bytes[2] = { reportId, data };
+    USBSetup setup;
+    setup.bmRequestType = REQUEST_HOSTTODEVICE_CLASS_INTERFACE;
+    setup.bRequest = HID_SET_REPORT;
+    setup.wValueL = reportId;
+    setup.wValueH = HID_REPORT_TYPE_OUTPUT;
+    setup.wIndex = 0;
+    setup.wLength = sizeof(bytes);
+
+    controlData = bytes;
+    controlLength = sizeof(bytes);
+    PluggableUSB().setup(setup);
+    controlData = NULL;
+    controlLength = 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * Native PluggableUSB / HID
+ *
+ * Modules plugged into PluggableUSB get the PC's class requests the
+ * same way as on the board: simSendOutputReport() turns into a
+ * SET_REPORT control request that each module may claim, with the
+ * report bytes read through USB_RecvControl().
+ */
+
+#ifndef HID_H
+#define HID_H
+
+#include "Arduino.h"
+
+#define REQUEST_HOSTTODEVICE_CLASS_INTERFACE    0x21
+#define HID_GET_REPORT          0x01
+#define HID_SET_REPORT          0x09
+#define HID_REPORT_TYPE_INPUT   1
+#define HID_REPORT_TYPE_OUTPUT  2
+#define HID_REPORT_TYPE_FEATURE 3
+
+struct USBSetup {
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint8_t wValueL;
+    uint8_t wValueH;
+    uint16_t wIndex;
+    uint16_t wLength;
+};
+
+// Data stage of the control request being handled
+int USB_RecvControl(void* data, int length);
+
+class PluggableUSBModule {
+public:
+    PluggableUSBModule(uint8_t numEps, uint8_t numIfs, uint8_t* epType)
+        : next(NULL) {
+        (void)numEps;
+        (void)numIfs;
+        (void)epType;
+    }
+    virtual ~PluggableUSBModule() {}
+
+protected:
+    virtual bool setup(USBSetup& setup) = 0;
+    virtual int getInterface(uint8_t* interfaceCount) = 0;
+    virtual int getDescriptor(USBSetup& setup) = 0;
+
+    PluggableUSBModule* next;
+    friend class PluggableUSB_;
+};
+
+class PluggableUSB_ {
+public:
+    PluggableUSB_() : rootNode(NULL) {}
+    bool plug(PluggableUSBModule* node);
+
+    // Offer a control request to each module in plug order
+    bool setup(USBSetup& setup);
+
+private:
+    PluggableUSBModule* rootNode;
+};
+
+PluggableUSB_& PluggableUSB();
+
+class HIDSubDescriptor {
+public:
+    HIDSubDescriptor(const void* data, uint16_t length)
+        : data(data), length(length), next(NULL) {}
+
+    const void* data;
+    uint16_t length;
+    HIDSubDescriptor* next;
+};
+
+class HID_ {
+public:
+    HID_() : rootNode(NULL), descriptorSize(0) {}
+    void AppendDescriptor(HIDSubDescriptor* node);
+    void SendReport(uint8_t id, const void* data, int length);
+
+    uint16_t getDescriptorSize() const { return descriptorSize; }
+
+private:
+    HIDSubDescriptor* rootNode;
+    uint16_t descriptorSize;
+};
+
+HID_& HID();
+
+#endif // HID_H
@@ -0,0 +1,158 @@
+/**
+ * Native Keyboard Implementation
+ */
+
+#include "Keyboard.h"
+
+#define SHIFT   0x80        // In the ASCII map: needs Left Shift
+
+Keyboard_ Keyboard;
+
+// US layout, as the Arduino Keyboard library's _asciimap
+static uint8_t asciiToUsage(uint8_t c) {
+    if (c >= 'a' && c <= 'z') return 0x04 + (c - 'a');
+    if (c >= 'A' && c <= 'Z') return (0x04 + (c - 'A')) | SHIFT;
+    if (c >= '1' && c <= '9') return 0x1E + (c - '1');
+
+    switch (c) {
+        case '0':  return 0x27;
+        case '\b': return 0x2A;
+        case '\t': return 0x2B;
+        case '\n': return 0x28;
+        case 0x1B: return 0x29;
+        case ' ':  return 0x2C;
+        case '!':  return 0x1E | SHIFT;
+        case '"':  return 0x34 | SHIFT;
+        case '#':  return 0x20 | SHIFT;
+        case '$':  return 0x21 | SHIFT;
+        case '%':  return 0x22 | SHIFT;
+        case '&':  return 0x24 | SHIFT;
+        case '\'': return 0x34;
+        case '(':  return 0x26 | SHIFT;
+        case ')':  return 0x27 | SHIFT;
+        case '*':  return 0x25 | SHIFT;
+        case '+':  return 0x2E | SHIFT;
+        case ',':  return 0x36;
+        case '-':  return 0x2D;
+        case '.':  return 0x37;
+        case '/':  return 0x38;
+        case ':':  return 0x33 | SHIFT;
+        case ';':  return 0x33;
+        case '<':  return 0x36 | SHIFT;
+        case '=':  return 0x2E;
+        case '>':  return 0x37 | SHIFT;
+        case '?':  return 0x38 | SHIFT;
+        case '@':  return 0x1F | SHIFT;
+        case '[':  return 0x2F;
+        case '\\': return 0x31;
+        case ']':  return 0x30;
+        case '^':  return 0x23 | SHIFT;
+        case '_':  return 0x2D | SHIFT;
+        case '`':  return 0x35;
+        case '{':  return 0x2F | SHIFT;
+        case '|':  return 0x31 | SHIFT;
+        case '}':  return 0x30 | SHIFT;
+        case '~':  return 0x35 | SHIFT;
+        default:   return 0;
+    }
+}
+
+Keyboard_::Keyboard_() {
+    memset(&keyReport, 0, sizeof(keyReport));
+}
+
+void Keyboard_::begin() {
+}
+
+void Keyboard_::end() {
+}
+
+void Keyboard_::sendReport(KeyReport* keys) {
+    HID().SendReport(KEYBOARD_REPORT_ID, keys, sizeof(KeyReport));
+}
+
+// Key code for k, with its modifier bit added to the report; 0 for a
+// pure modifier, 0xFF if the key doesn't exist
+static uint8_t usageFor(uint8_t k, uint8_t* modifiers, bool add) {
+    uint8_t bit = 0;
+    uint8_t usage = 0;
+
+    if (k >= 136) {
+        usage = k - 136;                // Non-printing key
+    } else if (k >= 128) {
+        bit = 1 << (k - 128);           // Modifier key
+    } else {
+        usage = asciiToUsage(k);
+        if (usage == 0) return 0xFF;
+        if (usage & SHIFT) {
+            bit = 0x02;                 // Left Shift
+            usage &= ~SHIFT;
+        }
+    }
+
+    if (add) {
+        *modifiers |= bit;
+    } else {
+        *modifiers &= ~bit;
+    }
+    return usage;
+}
+
+size_t Keyboard_::press(uint8_t k) {
+    uint8_t usage = usageFor(k, &keyReport.modifiers, true);
+    if (usage == 0xFF) return 0;
+
+    if (usage != 0) {
+        bool present = false;
+        for (uint8_t i = 0; i < 6; i++) {
+            if (keyReport.keys[i] == usage) present = true;
+        }
+        if (!present) {
+            uint8_t i = 0;
+            while (i < 6 && keyReport.keys[i] != 0) i++;
+            if (i == 6) return 0;       // Six keys down already
+            keyReport.keys[i] = usage;
+        }
+    }
+    sendReport(&keyReport);
+    return 1;
+}
+
+size_t Keyboard_::release(uint8_t k) {
+    uint8_t usage = usageFor(k, &keyReport.modifiers, false);
+    if (usage == 0xFF) return 0;
+
+    if (usage != 0) {
+        for (uint8_t i = 0; i < 6; i++) {
+            if (keyReport.keys[i] == usage) keyReport.keys[i] = 0;
+        }
+    }
+    sendReport(&keyReport);
+    return 1;
+}
+
+void Keyboard_::releaseAll() {
+    memset(&keyReport, 0, sizeof(keyReport));
+    sendReport(&keyReport);
+}
+
+size_t Keyboard_::write(uint8_t c) {
+    uint8_t p = press(c);
+    release(c);
+    return p;
+}
+
+size_t Keyboard_::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size--) {
+        if (*buffer != '\r') {
+            if (write(*buffer)) {
+                written++;
+            } else {
+                break;
+            }
+        }
+        buffer++;
+    }
+    return written;
+}
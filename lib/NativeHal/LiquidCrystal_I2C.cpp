@@ -0,0 +1,175 @@
+/**
+ * Native LiquidCrystal_I2C Implementation
+ *
+ * Command sequence and PCF8574 bit layout follow LiquidCrystal_I2C
+ * 1.1.x: P0 = RS, P2 = EN, P3 = backlight, P4-P7 = D4-D7.
+ */
+
+#include "LiquidCrystal_I2C.h"
+#include "SimHost.h"
+#include <Wire.h>
+
+#define LCD_CLEARDISPLAY    0x01
+#define LCD_RETURNHOME      0x02
+#define LCD_ENTRYMODESET    0x04
+#define LCD_DISPLAYCONTROL  0x08
+#define LCD_FUNCTIONSET     0x20
+#define LCD_SETCGRAMADDR    0x40
+#define LCD_SETDDRAMADDR    0x80
+
+#define LCD_BACKLIGHT       0x08
+#define LCD_NOBACKLIGHT     0x00
+#define En                  0x04
+#define Rs                  0x01
+
+#define LINE_LENGTH         40          // DDRAM per line
+#define ROW_OFFSET          20          // Rows 2 and 3 continue lines 0 and 1
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t address, uint8_t cols, uint8_t rows)
+    : address(address), cols(cols > 20 ? 20 : cols), rows(rows > 4 ? 4 : rows),
+      backlightBit(LCD_NOBACKLIGHT), displayOn(false),
+      cursorCol(0), cursorRow(0) {
+    memset(ram, ' ', sizeof(ram));
+    memset(shown, 0, sizeof(shown));
+}
+
+void LiquidCrystal_I2C::init() {
+    Wire.begin();
+    begin(cols, rows);
+}
+
+void LiquidCrystal_I2C::begin(uint8_t cols, uint8_t rows) {
+    (void)cols;
+    (void)rows;
+
+    // Power-up wait of the real library, then the 4-bit init sequence
+    delay(50);
+    expanderWrite(backlightBit);
+    delay(1000);
+    write4bits(0x03 << 4);
+    delayMicroseconds(4500);
+    write4bits(0x03 << 4);
+    delayMicroseconds(4500);
+    write4bits(0x03 << 4);
+    delayMicroseconds(150);
+    write4bits(0x02 << 4);
+
+    send(LCD_FUNCTIONSET | 0x08, 0);        // 4-bit, 2 lines, 5x8
+    display();
+    clear();
+    send(LCD_ENTRYMODESET | 0x02, 0);       // Left to right, no shift
+    home();
+}
+
+void LiquidCrystal_I2C::clear() {
+    send(LCD_CLEARDISPLAY, 0);
+    delayMicroseconds(2000);
+    memset(ram, ' ', sizeof(ram));
+    cursorCol = 0;
+    cursorRow = 0;
+    markDirty();
+}
+
+void LiquidCrystal_I2C::home() {
+    send(LCD_RETURNHOME, 0);
+    delayMicroseconds(2000);
+    cursorCol = 0;
+    cursorRow = 0;
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+    if (row >= rows) row = rows - 1;
+    uint8_t line = row % 2;
+    uint8_t pos = col + (row / 2) * ROW_OFFSET;
+    send(LCD_SETDDRAMADDR | ((line ? 0x40 : 0x00) + pos), 0);
+    cursorRow = line;
+    cursorCol = pos % LINE_LENGTH;
+}
+
+void LiquidCrystal_I2C::display() {
+    displayOn = true;
+    send(LCD_DISPLAYCONTROL | 0x04, 0);
+    markDirty();
+}
+
+void LiquidCrystal_I2C::noDisplay() {
+    displayOn = false;
+    send(LCD_DISPLAYCONTROL, 0);
+    markDirty();
+}
+
+void LiquidCrystal_I2C::backlight() {
+    backlightBit = LCD_BACKLIGHT;
+    expanderWrite(0);
+    markDirty();
+}
+
+void LiquidCrystal_I2C::noBacklight() {
+    backlightBit = LCD_NOBACKLIGHT;
+    expanderWrite(0);
+    markDirty();
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
+    location &= 0x7;
+    send(LCD_SETCGRAMADDR | (location << 3), 0);
+    for (uint8_t i = 0; i < 8; i++) {
+        send(charmap[i], Rs);
+    }
+    // The address counter is in CGRAM now; the firmware always sets
+    // the cursor or clears before printing again
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t value) {
+    send(value, Rs);
+
+    // Custom glyphs 0-7 are kept as their mirror 8-15 so rows stay strings
+    ram[cursorRow][cursorCol] = (value < 8) ? (char)(value + 8) : (char)value;
+    cursorCol++;
+    if (cursorCol >= LINE_LENGTH) {
+        cursorCol = 0;
+        cursorRow ^= 1;
+    }
+    markDirty();
+    return 1;
+}
+
+const char* LiquidCrystal_I2C::rowText(uint8_t row) {
+    return (row < rows) ? shown[row] : "";
+}
+
+void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
+    write4bits((value & 0xF0) | mode);
+    write4bits(((value << 4) & 0xF0) | mode);
+}
+
+void LiquidCrystal_I2C::write4bits(uint8_t value) {
+    expanderWrite(value);
+    expanderWrite(value | En);
+    delayMicroseconds(1);
+    expanderWrite(value & ~En);
+    delayMicroseconds(50);
+}
+
+void LiquidCrystal_I2C::expanderWrite(uint8_t data) {
+    Wire.beginTransmission(address);
+    Wire.write(data | backlightBit);
+    Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::markDirty() {
+    for (uint8_t r = 0; r < rows; r++) {
+        for (uint8_t c = 0; c < cols; c++) {
+            shown[r][c] = displayOn ? ram[r % 2][(r / 2) * ROW_OFFSET + c] : ' ';
+        }
+        shown[r][cols] = '\0';
+    }
+
+    SimLcdFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.rows = rows;
+    frame.cols = cols;
+    frame.backlight = (backlightBit != LCD_NOBACKLIGHT);
+    memcpy(frame.text, shown, sizeof(frame.text));
+    simLcdUpdate(frame);
+}
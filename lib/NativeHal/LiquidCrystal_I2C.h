@@ -0,0 +1,56 @@
+/**
+ * Native LiquidCrystal_I2C
+ *
+ * Keeps the HD44780 display memory and sends the same PCF8574 traffic
+ * as the real library (six I2C writes per byte, 4-bit mode), so LCD
+ * updates cost realistic bus time. Each time the firmware waits after
+ * changing the text, the visible screen is recorded as a frame.
+ */
+
+#ifndef LIQUIDCRYSTAL_I2C_H
+#define LIQUIDCRYSTAL_I2C_H
+
+#include "Arduino.h"
+
+class LiquidCrystal_I2C : public Print {
+public:
+    LiquidCrystal_I2C(uint8_t address, uint8_t cols, uint8_t rows);
+    void init();
+    void begin(uint8_t cols, uint8_t rows);
+    void clear();
+    void home();
+    void setCursor(uint8_t col, uint8_t row);
+    void display();
+    void noDisplay();
+    void cursor() {}
+    void noCursor() {}
+    void blink() {}
+    void noBlink() {}
+    void backlight();
+    void noBacklight();
+    void createChar(uint8_t location, uint8_t charmap[]);
+    // No using Print::write, as in the real header: lcd.write(0) must
+    // not be ambiguous with write(const char*)
+    size_t write(uint8_t value);
+
+    // Visible text of one row (for the simulator)
+    const char* rowText(uint8_t row);
+
+private:
+    void send(uint8_t value, uint8_t mode);
+    void write4bits(uint8_t value);
+    void expanderWrite(uint8_t data);
+    void markDirty();
+
+    uint8_t address;
+    uint8_t cols;
+    uint8_t rows;
+    uint8_t backlightBit;
+    bool displayOn;
+    uint8_t cursorCol;
+    uint8_t cursorRow;
+    char ram[2][40];            // DDRAM, two lines of 40
+    char shown[4][21];
+};
+
+#endif // LIQUIDCRYSTAL_I2C_H
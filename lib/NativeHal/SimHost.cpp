@@ -0,0 +1,476 @@
+/**
+ * Simulated Host Implementation
+ */
+
+#include "SimHost.h"
+#include "Arduino.h"
+#include <deque>
+#include <queue>
+#include <stdio.h>
+
+#define PIN_COUNT           32
+#define EEPROM_BYTES        1024
+#define EEPROM_WRITE_US     3400        // Erase + write, ATmega32u4 datasheet
+#define USB_FRAME_US        1000        // Full speed: one IN poll per 1 ms frame
+#define CDC_FRAME_BYTES     64          // CDC bulk IN: one packet per frame
+
+struct SimEvent {
+    SimTime at;
+    uint32_t order;                     // Same time: first scheduled runs first
+    std::function<void()> action;
+};
+
+struct SimEventLater {
+    bool operator()(const SimEvent& a, const SimEvent& b) const {
+        return (a.at != b.at) ? a.at > b.at : a.order > b.order;
+    }
+};
+
+struct SimPin {
+    uint8_t mode;
+    uint8_t output;
+    bool driven;                        // Something outside holds the level
+    uint8_t external;
+    void (*handler)();
+    int interruptMode;
+};
+
+// Function-local so fakes constructed before main() can use it
+struct SimState {
+    SimTime now;
+    SimTime deadline;
+    uint32_t nextOrder;
+    std::priority_queue<SimEvent, std::vector<SimEvent>, SimEventLater> events;
+    std::vector<std::function<void()> > waitHooks;
+
+    SimPin pins[PIN_COUNT];
+    bool recordPinReads;
+
+    SimPc* pc;
+    bool usbConfigured;
+    SimTime endpointFreeAt;
+
+    std::deque<uint8_t> serialIn;
+    bool serialOpen;
+    SimTime cdcFrame;
+    uint8_t cdcUsed;
+    std::string serialOut;
+    std::string serialLine;
+    std::vector<std::function<void(const std::string&)> > lineHooks;
+
+    std::vector<uint8_t> i2cDevices;
+
+    uint8_t eeprom[EEPROM_BYTES];
+    SimTime eepromBusyUntil;
+    uint32_t eepromWrites;
+
+    SimLcdFrame lcdPending;
+    bool lcdDirty;
+
+    uint32_t random;
+
+    std::vector<SimKeyReport> keyReports;
+    std::vector<SimLcdFrame> lcdFrames;
+    std::vector<SimPinRead> pinReads;
+    std::vector<SimPinEdge> pinEdges;
+    std::vector<SimI2cTransfer> i2cTransfers;
+    std::vector<SimWait> waits;
+    SimQueueStats queues;
+
+    SimState()
+        : now(0), deadline(0), nextOrder(0), recordPinReads(false),
+          pc(NULL), usbConfigured(true), endpointFreeAt(0),
+          serialOpen(true), cdcFrame(0), cdcUsed(0),
+          eepromBusyUntil(0), eepromWrites(0), lcdDirty(false), random(1) {
+        memset(pins, 0, sizeof(pins));
+        memset(eeprom, 0xFF, sizeof(eeprom));
+        memset(&lcdPending, 0, sizeof(lcdPending));
+        memset(&queues, 0, sizeof(queues));
+    }
+};
+
+static SimState& sim() {
+    static SimState state;
+    return state;
+}
+
+// ===========================================
+// Clock
+// ===========================================
+
+SimTime simNow() {
+    return sim().now;
+}
+
+void simAdvanceTo(SimTime at) {
+    SimState& s = sim();
+    while (!s.events.empty() && s.events.top().at <= at) {
+        SimEvent event = s.events.top();
+        s.events.pop();
+        if (event.at > s.now) s.now = event.at;
+        event.action();
+    }
+    if (at > s.now) s.now = at;
+
+    if (s.deadline != 0 && s.now >= s.deadline) {
+        throw SimStop();
+    }
+}
+
+void simAdvance(SimTime us) {
+    simAdvanceTo(sim().now + us);
+}
+
+void simAt(SimTime at, std::function<void()> action) {
+    SimState& s = sim();
+    SimEvent event;
+    event.at = (at > s.now) ? at : s.now;
+    event.order = s.nextOrder++;
+    event.action = action;
+    s.events.push(event);
+}
+
+void simSetDeadline(SimTime at) {
+    sim().deadline = at;
+}
+
+void simOnWait(std::function<void()> hook) {
+    sim().waitHooks.push_back(hook);
+}
+
+void simCpu(uint32_t us) {
+    simAdvance(us);
+}
+
+void simWaitStarted(uint32_t ms) {
+    SimState& s = sim();
+
+    // Whatever the firmware drew is what the technician sees now
+    if (s.lcdDirty) {
+        s.lcdDirty = false;
+        s.lcdPending.at = s.now;
+        const SimLcdFrame* last = s.lcdFrames.empty() ? NULL : &s.lcdFrames.back();
+        if (last == NULL || last->backlight != s.lcdPending.backlight ||
+            memcmp(last->text, s.lcdPending.text, sizeof(last->text)) != 0) {
+            s.lcdFrames.push_back(s.lcdPending);
+        }
+    }
+
+    SimWait wait = { s.now, ms };
+    s.waits.push_back(wait);
+
+    for (size_t i = 0; i < s.waitHooks.size(); i++) {
+        s.waitHooks[i]();
+    }
+}
+
+// ===========================================
+// Pins
+// ===========================================
+
+static void pinChanged(uint8_t pin, uint8_t before, bool external) {
+    SimState& s = sim();
+    uint8_t after = simPinRead(pin);
+    if (after == before) return;
+
+    SimPinEdge edge = { s.now, pin, after, external };
+    s.pinEdges.push_back(edge);
+
+    SimPin& p = s.pins[pin];
+    if (p.handler == NULL) return;
+    if (p.interruptMode == CHANGE ||
+        (p.interruptMode == RISING && after == HIGH) ||
+        (p.interruptMode == FALLING && after == LOW)) {
+        p.handler();
+    }
+}
+
+static uint8_t pinLevel(const SimPin& p) {
+    if (p.mode == OUTPUT) return p.output;
+    if (p.driven) return p.external;
+    return (p.mode == INPUT_PULLUP) ? HIGH : LOW;
+}
+
+void simDrivePin(uint8_t pin, uint8_t level) {
+    if (pin >= PIN_COUNT) return;
+    SimPin& p = sim().pins[pin];
+    uint8_t before = pinLevel(p);
+    p.driven = true;
+    p.external = level ? HIGH : LOW;
+    pinChanged(pin, before, true);
+}
+
+void simFloatPin(uint8_t pin) {
+    if (pin >= PIN_COUNT) return;
+    SimPin& p = sim().pins[pin];
+    uint8_t before = pinLevel(p);
+    p.driven = false;
+    pinChanged(pin, before, true);
+}
+
+void simDrivePinAt(SimTime at, uint8_t pin, uint8_t level) {
+    simAt(at, [pin, level]() { simDrivePin(pin, level); });
+}
+
+uint8_t simPinOutput(uint8_t pin) {
+    return (pin < PIN_COUNT) ? sim().pins[pin].output : LOW;
+}
+
+void simPinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= PIN_COUNT) return;
+    SimPin& p = sim().pins[pin];
+    uint8_t before = pinLevel(p);
+    p.mode = mode;
+    pinChanged(pin, before, false);
+}
+
+void simPinWrite(uint8_t pin, uint8_t level) {
+    if (pin >= PIN_COUNT) return;
+    SimPin& p = sim().pins[pin];
+    uint8_t before = pinLevel(p);
+    p.output = level ? HIGH : LOW;
+    pinChanged(pin, before, false);
+}
+
+uint8_t simPinRead(uint8_t pin) {
+    if (pin >= PIN_COUNT) return LOW;
+    return pinLevel(sim().pins[pin]);
+}
+
+void simAttachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+    if (pin >= PIN_COUNT) return;
+    sim().pins[pin].handler = handler;
+    sim().pins[pin].interruptMode = mode;
+}
+
+void simRecordPinReads(bool record) {
+    sim().recordPinReads = record;
+}
+
+// Called by digitalRead() in Arduino.cpp
+void simRecordPinRead(uint8_t pin, uint8_t level) {
+    SimState& s = sim();
+    if (!s.recordPinReads) return;
+    SimPinRead read = { s.now, pin, level };
+    s.pinReads.push_back(read);
+}
+
+// ===========================================
+// USB
+// ===========================================
+
+void simSetPc(SimPc* pc) {
+    sim().pc = pc;
+}
+
+void simSetUsbConfigured(bool configured) {
+    sim().usbConfigured = configured;
+}
+
+bool simUsbConfigured() {
+    return sim().usbConfigured;
+}
+
+void simUsbSendReport(const uint8_t report[8]) {
+    SimState& s = sim();
+    if (!s.usbConfigured) return;       // USB_Send() gives up when not configured
+
+    // The previous report is still in the endpoint until the PC polls
+    if (s.endpointFreeAt > s.now) {
+        s.queues.hidWaits++;
+        s.queues.hidWaitUs += s.endpointFreeAt - s.now;
+        simAdvanceTo(s.endpointFreeAt);
+    }
+
+    SimKeyReport key;
+    key.sentAt = s.now;
+    key.hostAt = (s.now / USB_FRAME_US + 1) * USB_FRAME_US;
+    key.modifiers = report[0];
+    memcpy(key.keys, report + 2, sizeof(key.keys));
+    s.endpointFreeAt = key.hostAt;
+    s.keyReports.push_back(key);
+
+    simAt(key.hostAt, [key]() {
+        if (sim().pc) sim().pc->onKeyReport(key);
+    });
+}
+
+void simSerialInput(const std::string& text) {
+    SimState& s = sim();
+    s.serialIn.insert(s.serialIn.end(), text.begin(), text.end());
+}
+
+void simSerialInputAt(SimTime at, const std::string& text) {
+    simAt(at, [text]() { simSerialInput(text); });
+}
+
+void simSetSerialOpen(bool open) {
+    sim().serialOpen = open;
+}
+
+bool simSerialOpen() {
+    return sim().serialOpen;
+}
+
+void simOnSerialLine(std::function<void(const std::string& line)> hook) {
+    sim().lineHooks.push_back(hook);
+}
+
+int simSerialAvailable() {
+    return (int)sim().serialIn.size();
+}
+
+int simSerialRead(bool consume) {
+    SimState& s = sim();
+    if (s.serialIn.empty()) return -1;
+    uint8_t c = s.serialIn.front();
+    if (consume) s.serialIn.pop_front();
+    return c;
+}
+
+int simSerialAvailableForWrite() {
+    SimState& s = sim();
+    SimTime frame = s.now / USB_FRAME_US;
+    if (frame != s.cdcFrame) {
+        s.cdcFrame = frame;
+        s.cdcUsed = 0;
+    }
+    return CDC_FRAME_BYTES - s.cdcUsed;
+}
+
+void simSerialWrite(uint8_t c) {
+    SimState& s = sim();
+    if (!s.serialOpen) return;
+
+    if (simSerialAvailableForWrite() == 0) {
+        s.queues.cdcWaits++;
+        simAdvanceTo((s.now / USB_FRAME_US + 1) * USB_FRAME_US);
+        simSerialAvailableForWrite();
+    }
+    s.cdcUsed++;
+    s.serialOut += (char)c;
+
+    if (c == '\n') {
+        std::string line = s.serialLine;
+        s.serialLine.clear();
+        for (size_t i = 0; i < s.lineHooks.size(); i++) {
+            s.lineHooks[i](line);
+        }
+    } else if (c != '\r') {
+        s.serialLine += (char)c;
+    }
+}
+
+// ===========================================
+// I2C, LCD, EEPROM
+// ===========================================
+
+void simAddI2cDevice(uint8_t address) {
+    sim().i2cDevices.push_back(address);
+}
+
+bool simI2cAck(uint8_t address) {
+    const std::vector<uint8_t>& devices = sim().i2cDevices;
+    for (size_t i = 0; i < devices.size(); i++) {
+        if (devices[i] == address) return true;
+    }
+    return false;
+}
+
+void simRecordI2c(const SimI2cTransfer& transfer) {
+    sim().i2cTransfers.push_back(transfer);
+}
+
+void simLcdUpdate(const SimLcdFrame& frame) {
+    sim().lcdPending = frame;
+    sim().lcdDirty = true;
+}
+
+uint8_t* simEeprom() {
+    return sim().eeprom;
+}
+
+bool simLoadEeprom(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+    size_t size = fread(sim().eeprom, 1, EEPROM_BYTES, file);
+    fclose(file);
+    return size == EEPROM_BYTES;
+}
+
+bool simSaveEeprom(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+    size_t size = fwrite(sim().eeprom, 1, EEPROM_BYTES, file);
+    fclose(file);
+    return size == EEPROM_BYTES;
+}
+
+void simEepromWait() {
+    if (sim().eepromBusyUntil > sim().now) {
+        simAdvanceTo(sim().eepromBusyUntil);
+    }
+}
+
+void simEepromWritten() {
+    sim().eepromBusyUntil = sim().now + EEPROM_WRITE_US;
+    sim().eepromWrites++;
+}
+
+uint32_t simEepromWrites() {
+    return sim().eepromWrites;
+}
+
+// ===========================================
+// Random
+// ===========================================
+
+void simSeedRandom(uint32_t seed) {
+    sim().random = seed ? seed : 1;
+}
+
+uint32_t simRandom() {
+    // xorshift32
+    uint32_t x = sim().random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim().random = x;
+    return x;
+}
+
+// ===========================================
+// Records
+// ===========================================
+
+const std::vector<SimKeyReport>& simKeyReports() {
+    return sim().keyReports;
+}
+
+const std::vector<SimLcdFrame>& simLcdFrames() {
+    return sim().lcdFrames;
+}
+
+const std::vector<SimPinRead>& simPinReads() {
+    return sim().pinReads;
+}
+
+const std::vector<SimPinEdge>& simPinEdges() {
+    return sim().pinEdges;
+}
+
+const std::vector<SimI2cTransfer>& simI2cTransfers() {
+    return sim().i2cTransfers;
+}
+
+const std::vector<SimWait>& simWaits() {
+    return sim().waits;
+}
+
+const SimQueueStats& simQueueStats() {
+    return sim().queues;
+}
+
+const std::string& simSerialOutput() {
+    return sim().serialOut;
+}
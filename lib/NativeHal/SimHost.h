@@ -0,0 +1,206 @@
+/**
+ * Simulated Host
+ *
+ * The world around the board in the native build: a virtual clock,
+ * the wires on the pins, the PC on the other end of the USB cable,
+ * I2C devices, and a record of everything the firmware did to them.
+ *
+ * Time only moves when the firmware waits (delay(), delayMicroseconds(),
+ * a USB report or I2C transfer that blocks, an EEPROM write) or calls
+ * into the core - every Arduino call costs a few microseconds, so
+ * polling loops make progress. Scheduled events run at their exact
+ * time inside whichever wait covers it, so a three-minute payload
+ * finishes in milliseconds and always the same way.
+ */
+
+#ifndef SIM_HOST_H
+#define SIM_HOST_H
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef uint64_t SimTime;       // Microseconds since power-up
+
+#define SIM_MS(ms)      ((SimTime)(ms) * 1000)
+
+// Thrown out of the firmware when the deadline passes (simSetDeadline)
+struct SimStop {};
+
+// One keyboard report (Arduino Keyboard layout, report ID 2)
+struct SimKeyReport {
+    SimTime sentAt;             // Firmware handed it to the endpoint
+    SimTime hostAt;             // PC picked it up (next 1 ms frame)
+    uint8_t modifiers;
+    uint8_t keys[6];
+};
+
+// What the LCD showed when the firmware stopped drawing and waited
+struct SimLcdFrame {
+    SimTime at;
+    uint8_t rows;
+    uint8_t cols;
+    bool backlight;
+    char text[4][21];           // Raw characters, 0-7 are custom glyphs
+};
+
+struct SimPinRead {
+    SimTime at;
+    uint8_t pin;
+    uint8_t level;
+};
+
+// Output pin changes and pin changes from outside (wires, gestures)
+struct SimPinEdge {
+    SimTime at;
+    uint8_t pin;
+    uint8_t level;
+    bool external;
+};
+
+struct SimI2cTransfer {
+    SimTime start;
+    SimTime end;
+    uint8_t address;
+    uint8_t length;             // Data bytes, without the address byte
+    bool acked;
+};
+
+// A wait the firmware made (delay() calls only)
+struct SimWait {
+    SimTime start;
+    uint32_t ms;
+};
+
+// Times the firmware had to wait for a full endpoint
+struct SimQueueStats {
+    uint32_t hidWaits;          // Report sent while the previous one was still queued
+    SimTime hidWaitUs;
+    uint32_t cdcWaits;          // Serial write into a full 64-byte CDC frame
+};
+
+// The PC the board is plugged into
+class SimPc {
+public:
+    virtual ~SimPc() {}
+
+    // A keyboard report arrived (called at report.hostAt)
+    virtual void onKeyReport(const SimKeyReport& report) { (void)report; }
+};
+
+// ===========================================
+// Clock
+// ===========================================
+
+SimTime simNow();
+
+// Let time pass (and scheduled events fire) without the firmware noticing
+void simAdvance(SimTime us);
+void simAdvanceTo(SimTime at);
+
+// Run action at a point in virtual time (now if that has passed)
+void simAt(SimTime at, std::function<void()> action);
+
+// Throw SimStop from the next wait that reaches this time (0 = never)
+void simSetDeadline(SimTime at);
+
+// Called at the start of every delay(), before time moves
+void simOnWait(std::function<void()> hook);
+
+// ===========================================
+// Pins
+// ===========================================
+
+// Drive a pin from outside (a wire to GND = LOW). simFloatPin() takes
+// the wire away: an INPUT_PULLUP pin then reads HIGH.
+void simDrivePin(uint8_t pin, uint8_t level);
+void simFloatPin(uint8_t pin);
+void simDrivePinAt(SimTime at, uint8_t pin, uint8_t level);
+
+// Level the firmware drives on an OUTPUT pin
+uint8_t simPinOutput(uint8_t pin);
+
+// ===========================================
+// USB: keyboard, LED reports, CDC Serial
+// ===========================================
+
+void simSetPc(SimPc* pc);
+
+// Enumerated and configured by the PC (false while it reboots)
+void simSetUsbConfigured(bool configured);
+
+// PC sends an output report (SET_REPORT), e.g. the keyboard LEDs
+void simSendOutputReport(uint8_t reportId, uint8_t data);
+
+// Text typed into the serial terminal, now or later
+void simSerialInput(const std::string& text);
+void simSerialInputAt(SimTime at, const std::string& text);
+
+// Terminal open on the PC side (DTR); output is lost when it isn't
+void simSetSerialOpen(bool open);
+
+// Called with each complete line the firmware printed
+void simOnSerialLine(std::function<void(const std::string& line)> hook);
+
+// ===========================================
+// I2C
+// ===========================================
+
+// A device that ACKs at this 7-bit address
+void simAddI2cDevice(uint8_t address);
+
+// ===========================================
+// EEPROM image (1 KB, 0xFF when blank)
+// ===========================================
+
+uint8_t* simEeprom();
+bool simLoadEeprom(const char* path);
+bool simSaveEeprom(const char* path);
+
+// ===========================================
+// Records
+// ===========================================
+
+// Pin reads are many (every poll loop) - off unless asked for
+void simRecordPinReads(bool record);
+
+const std::vector<SimKeyReport>& simKeyReports();
+const std::vector<SimLcdFrame>& simLcdFrames();
+const std::vector<SimPinRead>& simPinReads();
+const std::vector<SimPinEdge>& simPinEdges();
+const std::vector<SimI2cTransfer>& simI2cTransfers();
+const std::vector<SimWait>& simWaits();
+const SimQueueStats& simQueueStats();
+const std::string& simSerialOutput();
+uint32_t simEepromWrites();
+
+// Random numbers for the firmware's random() (same seed = same run)
+void simSeedRandom(uint32_t seed);
+
+// ===========================================
+// Used by the fake libraries
+// ===========================================
+
+void simCpu(uint32_t us);                       // Time spent computing
+void simWaitStarted(uint32_t ms);               // delay() begins
+void simPinMode(uint8_t pin, uint8_t mode);
+void simPinWrite(uint8_t pin, uint8_t level);
+uint8_t simPinRead(uint8_t pin);
+void simRecordPinRead(uint8_t pin, uint8_t level);
+void simAttachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void simUsbSendReport(const uint8_t report[8]); // Blocks while the endpoint is full
+bool simUsbConfigured();
+void simSerialWrite(uint8_t c);
+int simSerialAvailable();
+int simSerialRead(bool consume);
+int simSerialAvailableForWrite();
+bool simSerialOpen();
+bool simI2cAck(uint8_t address);
+void simRecordI2c(const SimI2cTransfer& transfer);
+void simLcdUpdate(const SimLcdFrame& frame);    // Recorded at the next wait
+void simEepromWait();                           // Previous write still busy
+void simEepromWritten();
+uint32_t simRandom();
+
+#endif // SIM_HOST_H
@@ -0,0 +1,43 @@
+/**
+ * Native USB Device and CDC Serial
+ *
+ * Serial is the terminal on the simulated PC (simSerialInput() types
+ * into it). Like the Leonardo's CDC port it takes 64 bytes per 1 ms USB
+ * frame; write() blocks until there is room.
+ */
+
+#ifndef USBAPI_H
+#define USBAPI_H
+
+#include "Arduino.h"
+
+class USBDevice_ {
+public:
+    bool configured();
+    bool isSuspended();
+    void attach() {}
+    void detach() {}
+};
+
+extern USBDevice_ USBDevice;
+
+class Serial_ : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void begin(unsigned long baud, uint8_t config) { (void)baud; (void)config; }
+    void end() {}
+
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t c);
+    using Print::write;
+    int availableForWrite();
+
+    // True while a terminal has the port open (DTR)
+    operator bool();
+};
+
+extern Serial_ Serial;
+
+#endif // USBAPI_H
@@ -0,0 +1,84 @@
+/**
+ * Native Wire Implementation
+ */
+
+#include "Wire.h"
+#include "SimHost.h"
+
+#define WIRE_DEFAULT_CLOCK  100000UL
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+    : clockHz(WIRE_DEFAULT_CLOCK), txAddress(0), txLength(0), overflow(false) {
+}
+
+void TwoWire::begin() {
+}
+
+void TwoWire::setClock(uint32_t clock) {
+    if (clock > 0) clockHz = clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+    overflow = false;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength >= WIRE_BUFFER_LENGTH) {
+        overflow = true;
+        return 0;
+    }
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    size_t written = 0;
+    while (written < quantity && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    if (overflow) return 1;
+
+    SimI2cTransfer transfer;
+    transfer.start = simNow();
+    transfer.address = txAddress;
+    transfer.acked = simI2cAck(txAddress);
+    transfer.length = transfer.acked ? txLength : 0;
+
+    // Start, 9 bits per byte (address first), stop; the master blocks
+    uint32_t bits = 2 + 9 * (1 + transfer.length);
+    simAdvance((SimTime)bits * 1000000UL / clockHz);
+    transfer.end = simNow();
+    simRecordI2c(transfer);
+
+    txLength = 0;
+    return transfer.acked ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+    (void)quantity;
+    (void)sendStop;
+    beginTransmission(address);
+    endTransmission();
+    return 0;
+}
+
+int TwoWire::available() {
+    return 0;
+}
+
+int TwoWire::read() {
+    return -1;
+}
+
+int TwoWire::peek() {
+    return -1;
+}
@@ -0,0 +1,49 @@
+/**
+ * Native Wire (I2C master)
+ *
+ * Transfers take the time they take on the bus (9 bit times per byte
+ * plus start/stop at the set clock) and are recorded. Only addresses
+ * registered with simAddI2cDevice() ACK; reads return nothing.
+ */
+
+#ifndef TWOWIRE_H
+#define TWOWIRE_H
+
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH  32
+
+class TwoWire : public Stream {
+public:
+    TwoWire();
+    void begin();
+    void end() {}
+    void setClock(uint32_t clock);
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    // 0 = ACK, 1 = too long, 2 = NACK on address
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = true);
+    uint8_t requestFrom(int address, int quantity) {
+        return requestFrom((uint8_t)address, (uint8_t)quantity);
+    }
+
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t quantity);
+    using Print::write;
+    int available();
+    int read();
+    int peek();
+
+private:
+    uint32_t clockHz;
+    uint8_t txAddress;
+    uint8_t txBuffer[WIRE_BUFFER_LENGTH];
+    uint8_t txLength;
+    bool overflow;
+};
+
+extern TwoWire Wire;
+
+#endif // TWOWIRE_H
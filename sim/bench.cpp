@@ -0,0 +1,370 @@
+/**
+ * Payload Benchmark Implementation
+ */
+
+#include "bench.h"
+#include "isolated.h"
+#include "metrics.h"
+#include "scenario.h"
+#include "sim_pc.h"
+#include "../include/config.h"
+#include "../src/telemetry.h"
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct BenchRun {
+    std::string payload;
+    std::string profile;
+    bool ok;                    // The child ran to the end
+    Metrics metrics;
+};
+
+struct BenchOptions {
+    int payload;                // -1 = all
+    int profile;
+    std::string eeprom;
+    const char* jsonPath;
+    const char* baselinePath;
+    double tolerancePct;
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator bench [--payload P] [--profile P] [--eeprom FILE]\n"
+        "                       [--json FILE|-] [--baseline FILE] [--tolerance PCT]\n");
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    options.payload = -1;
+    options.profile = -1;
+    options.jsonPath = NULL;
+    options.baselinePath = NULL;
+    options.tolerancePct = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return false;
+        }
+        uint8_t choice;
+        if (strcmp(arg, "--payload") == 0) {
+            if (!parsePayload(value, &choice)) {
+                fprintf(stderr, "unknown payload: %s\n", value);
+                return false;
+            }
+            options.payload = choice;
+        } else if (strcmp(arg, "--profile") == 0) {
+            if (!parseProfile(value, &choice)) {
+                fprintf(stderr, "unknown profile: %s\n", value);
+                return false;
+            }
+            options.profile = choice;
+        } else if (strcmp(arg, "--eeprom") == 0) {
+            options.eeprom = value;
+        } else if (strcmp(arg, "--json") == 0) {
+            options.jsonPath = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            options.baselinePath = value;
+        } else if (strcmp(arg, "--tolerance") == 0) {
+            options.tolerancePct = atof(value);
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===========================================
+// Runs
+// ===========================================
+
+static BenchRun benchOne(uint8_t payload, uint8_t profile, const std::string& eeprom) {
+    BenchRun run;
+    run.payload = payloadWord(payload);
+    run.profile = profileWord(profile);
+
+    std::string output;
+    run.ok = runIsolated([payload, profile, &eeprom](std::string& out) {
+        Scenario scenario;
+        scenario.payload = payload;
+        scenario.profile = profile;
+        scenario.eepromIn = eeprom;
+
+        BasicPc pc;
+        simSetPc(&pc);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        RunResult result = runScenario(scenario);
+        double wallMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        out = serializeMetrics(collectMetrics(result, wallMs));
+    }, output);
+    run.metrics = parseMetrics(output);
+    return run;
+}
+
+// ===========================================
+// Table
+// ===========================================
+
+static double metric(const BenchRun& run, const char* name) {
+    return findMetric(run.metrics, name);
+}
+
+static void printTable(const std::vector<BenchRun>& runs) {
+    printf("%-7s %-6s %9s %6s %7s %8s %5s %6s %9s %6s %9s\n",
+           "payload", "prof", "run_s", "keys", "reports", "i2c_kB", "lcd", "waits",
+           "log_peak", "drops", "hid_waits");
+    for (size_t i = 0; i < runs.size(); i++) {
+        const BenchRun& run = runs[i];
+        if (!run.ok) {
+            printf("%-7s %-6s  (run crashed)\n", run.payload.c_str(), run.profile.c_str());
+            continue;
+        }
+        char runText[16];
+        if (metric(run, "finished")) {
+            snprintf(runText, sizeof(runText), "%.2f", metric(run, "run_ms") / 1000);
+        } else {
+            snprintf(runText, sizeof(runText), "no end");
+        }
+        printf("%-7s %-6s %9s %6.0f %7.0f %8.1f %5.0f %6.0f %9.0f %6.0f %9.0f\n",
+               run.payload.c_str(), run.profile.c_str(), runText,
+               metric(run, "key_presses"), metric(run, "key_reports"),
+               metric(run, "i2c_bytes") / 1024, metric(run, "lcd_frames"), metric(run, "waits"),
+               metric(run, "log_peak"), metric(run, "log_drops"), metric(run, "hid_waits"));
+    }
+
+    printf("\nSeconds per phase:\n%-7s %-6s", "payload", "prof");
+    for (uint8_t phase = 0; phase < RUN_PHASE_COUNT; phase++) {
+        printf(" %10s", reinterpret_cast<const char*>(getPhaseName(phase)));
+    }
+    printf("\n");
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (!runs[i].ok) continue;
+        printf("%-7s %-6s", runs[i].payload.c_str(), runs[i].profile.c_str());
+        for (uint8_t phase = 0; phase < RUN_PHASE_COUNT; phase++) {
+            std::string name = std::string("phase_") +
+                reinterpret_cast<const char*>(getPhaseName(phase)) + "_ms";
+            double ms = findMetric(runs[i].metrics, name);
+            if (ms > 0) {
+                printf(" %10.2f", ms / 1000);
+            } else {
+                printf(" %10s", "-");
+            }
+        }
+        printf("\n");
+    }
+}
+
+// ===========================================
+// JSON
+// ===========================================
+
+static void writeJson(FILE* out, const std::vector<BenchRun>& runs) {
+    fprintf(out, "{\n  \"runs\": [\n");
+    for (size_t i = 0; i < runs.size(); i++) {
+        const BenchRun& run = runs[i];
+        fprintf(out, "    {\"payload\": \"%s\", \"profile\": \"%s\", \"ok\": %d",
+                run.payload.c_str(), run.profile.c_str(), run.ok ? 1 : 0);
+        for (size_t m = 0; m < run.metrics.size(); m++) {
+            fprintf(out, ",\n     \"%s\": %.10g", run.metrics[m].first.c_str(), run.metrics[m].second);
+        }
+        fprintf(out, "}%s\n", (i + 1 < runs.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void skipSpace(const std::string& text, size_t& pos) {
+    while (pos < text.size() && isspace((unsigned char)text[pos])) pos++;
+}
+
+static bool readString(const std::string& text, size_t& pos, std::string& out) {
+    skipSpace(text, pos);
+    if (pos >= text.size() || text[pos] != '"') return false;
+    size_t end = text.find('"', pos + 1);
+    if (end == std::string::npos) return false;
+    out = text.substr(pos + 1, end - pos - 1);
+    pos = end + 1;
+    return true;
+}
+
+// Reads the flat run objects writeJson() produces
+static bool readJson(const std::string& text, std::vector<BenchRun>& runs) {
+    size_t pos = text.find("\"runs\"");
+    if (pos == std::string::npos) return false;
+    pos = text.find('[', pos);
+    if (pos == std::string::npos) return false;
+    pos++;
+
+    while (true) {
+        skipSpace(text, pos);
+        if (pos >= text.size()) return false;
+        if (text[pos] == ']') return true;
+        if (text[pos] == ',') {
+            pos++;
+            continue;
+        }
+        if (text[pos] != '{') return false;
+        pos++;
+
+        BenchRun run;
+        run.ok = true;
+        while (true) {
+            skipSpace(text, pos);
+            if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                break;
+            }
+            if (pos < text.size() && text[pos] == ',') pos++;
+            std::string key;
+            if (!readString(text, pos, key)) return false;
+            skipSpace(text, pos);
+            if (pos >= text.size() || text[pos] != ':') return false;
+            pos++;
+            skipSpace(text, pos);
+
+            if (pos < text.size() && text[pos] == '"') {
+                std::string value;
+                if (!readString(text, pos, value)) return false;
+                if (key == "payload") run.payload = value;
+                if (key == "profile") run.profile = value;
+            } else {
+                char* end;
+                double value = strtod(text.c_str() + pos, &end);
+                if (end == text.c_str() + pos) return false;
+                pos = end - text.c_str();
+                if (key == "ok") {
+                    run.ok = (value != 0);
+                } else {
+                    run.metrics.push_back(std::make_pair(key, value));
+                }
+            }
+        }
+        runs.push_back(run);
+    }
+}
+
+// ===========================================
+// Baseline comparison
+// ===========================================
+
+// Number of regressions
+static int compareRuns(FILE* out, const std::vector<BenchRun>& runs,
+                       const std::vector<BenchRun>& baseline, double tolerancePct) {
+    int regressions = 0;
+    fprintf(out, "\nAgainst the baseline (tolerance %.1f%%):\n", tolerancePct);
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        const BenchRun& run = runs[i];
+        const BenchRun* before = NULL;
+        for (size_t b = 0; b < baseline.size(); b++) {
+            if (baseline[b].payload == run.payload && baseline[b].profile == run.profile) {
+                before = &baseline[b];
+            }
+        }
+        if (!before) {
+            fprintf(out, "  %s/%s: not in the baseline\n", run.payload.c_str(), run.profile.c_str());
+            continue;
+        }
+        if (!run.ok && before->ok) {
+            fprintf(out, "  REGRESSION %s/%s: run crashed\n", run.payload.c_str(), run.profile.c_str());
+            regressions++;
+            continue;
+        }
+
+        for (size_t m = 0; m < run.metrics.size(); m++) {
+            const std::string& name = run.metrics[m].first;
+            if (isNoisyMetric(name)) continue;
+            double now = run.metrics[m].second;
+            double then = findMetric(before->metrics, name, NAN);
+            // The JSON keeps 10 digits - closer than that is the same
+            if (std::isnan(then) || fabs(now - then) <= fabs(then) * 1e-9 + 1e-6) continue;
+
+            // Everything is lower = better, except a run that finishes
+            bool worse = (name == "finished") ? (now < then) : (now > then);
+            double pct = (then != 0) ? (now - then) / then * 100 : 100;
+            bool flagged = worse && fabs(pct) > tolerancePct;
+            if (flagged) regressions++;
+
+            fprintf(out, "  %-10s %s/%-6s %-20s %12.10g -> %-12.10g %+7.1f%%\n",
+                   flagged ? "REGRESSION" : (worse ? "worse" : "better"),
+                   run.payload.c_str(), run.profile.c_str(), name.c_str(), then, now, pct);
+        }
+    }
+
+    if (regressions) {
+        fprintf(out, "%d regression(s)\n", regressions);
+    } else {
+        fprintf(out, "No regressions\n");
+    }
+    return regressions;
+}
+
+// ===========================================
+// bench
+// ===========================================
+
+int commandBench(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    std::vector<BenchRun> baseline;
+    if (options.baselinePath) {
+        FILE* file = fopen(options.baselinePath, "rb");
+        std::string text;
+        if (file) {
+            char chunk[4096];
+            size_t got;
+            while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, got);
+            fclose(file);
+        }
+        if (!file || !readJson(text, baseline)) {
+            fprintf(stderr, "cannot read baseline %s\n", options.baselinePath);
+            return 2;
+        }
+    }
+
+    std::vector<BenchRun> runs;
+    for (uint8_t payload = 0; payload < PAYLOAD_COUNT; payload++) {
+        if (options.payload >= 0 && options.payload != payload) continue;
+        for (uint8_t profile = 0; profile < PROFILE_COUNT; profile++) {
+            if (options.profile >= 0 && options.profile != profile) continue;
+            runs.push_back(benchOne(payload, profile, options.eeprom));
+        }
+    }
+
+    bool jsonOnly = options.jsonPath && strcmp(options.jsonPath, "-") == 0;
+    if (jsonOnly) {
+        writeJson(stdout, runs);
+    } else {
+        printTable(runs);
+        if (options.jsonPath) {
+            FILE* file = fopen(options.jsonPath, "w");
+            if (!file) {
+                fprintf(stderr, "cannot write %s\n", options.jsonPath);
+                return 1;
+            }
+            writeJson(file, runs);
+            fclose(file);
+        }
+    }
+
+    int failed = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (!runs[i].ok) failed++;
+    }
+    if (options.baselinePath) {
+        // With the JSON on stdout the comparison goes to stderr
+        if (compareRuns(jsonOnly ? stderr : stdout, runs, baseline, options.tolerancePct) > 0) return 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,19 @@
+/**
+ * Payload Benchmark
+ *
+ * Runs every payload with every timing profile against the simulated
+ * PC (one forked child per run) and reports run time, time per phase,
+ * keys and reports, I2C bytes and queue high-water marks as a table
+ * and as JSON. With a baseline JSON from an earlier build it lists
+ * what changed and flags what got worse.
+ *
+ *   simulator bench [--payload P] [--profile P] [--eeprom FILE]
+ *                   [--json FILE] [--baseline FILE] [--tolerance PCT]
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+int commandBench(int argc, char** argv);
+
+#endif // BENCH_H
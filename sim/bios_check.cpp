@@ -0,0 +1,355 @@
+/**
+ * BIOS Sequence Check Implementation
+ */
+
+#include "bios_check.h"
+#include "dell_bios.h"
+#include "isolated.h"
+#include "scenario.h"
+#include "../include/config.h"
+#include "../src/settings.h"
+#include "../src/timing_config.h"
+#include "../src/wait_tuning.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define PACING_MARGIN_PCT   25
+#define PACING_STEP_MS      10          // Search resolution
+#define PACING_MAX_FACTOR   8           // Give up above 8x the default
+#define BIOS_RUN_LIMIT_MS   (10UL * 60 * 1000)
+
+struct BiosOptions {
+    std::string model;          // "" = all
+    int profile;                // -1 = all
+    uint8_t payload;
+    double latencyScale;
+    bool show;
+    bool pacing;
+};
+
+// A timing value the pacing search lowers
+struct PacingKnob {
+    const char* name;
+    bool learnedWait;           // WaitStep, else a TimingConfig field
+    uint8_t step;
+};
+
+static const PacingKnob knobs[] = {
+    { "nav_gap",     false, 0 },
+    { "key_delay",   false, 0 },
+    { "type_settle", false, 0 },
+    { "bios_dialog", true,  WAIT_BIOS_DIALOG },
+    { "bios_load",   true,  WAIT_BIOS_LOAD }
+};
+
+#define KNOB_COUNT  (sizeof(knobs) / sizeof(knobs[0]))
+
+// One knob set for a run (-1 = leave at default)
+struct Pacing {
+    long value[KNOB_COUNT];
+
+    Pacing() {
+        for (size_t i = 0; i < KNOB_COUNT; i++) value[i] = -1;
+    }
+};
+
+struct BiosRun {
+    bool ok;
+    bool crashed;
+    unsigned lost;
+    double runMs;
+    long applied;               // What the firmware stored for the knob under test
+    std::string verdict;
+    std::string events;
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator bios [--model NAME] [--profile P] [--payload bios|chain]\n"
+        "                      [--latency-scale X] [--show] [--pacing] [--list]\n");
+}
+
+static void listModels() {
+    const std::vector<BiosModel>& models = biosModels();
+    for (size_t i = 0; i < models.size(); i++) {
+        const BiosModel& model = models[i];
+        printf("%-15s %s\n", model.name, model.description);
+        printf("                +%u DOWN, POST %u ms, load %u ms, dialog %u ms, check %u ms\n",
+               model.learnedDowns, model.timing.postMs, model.timing.setupLoadMs,
+               model.timing.dialogMs, model.timing.verifyMs);
+    }
+}
+
+// 0 = ok, 1 = done (--list), 2 = bad arguments
+static int parseOptions(int argc, char** argv, BiosOptions& options) {
+    options.profile = -1;
+    options.payload = PAYLOAD_BIOS;
+    options.latencyScale = 1.0;
+    options.show = false;
+    options.pacing = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--show") == 0) {
+            options.show = true;
+            continue;
+        }
+        if (strcmp(arg, "--pacing") == 0) {
+            options.pacing = true;
+            continue;
+        }
+        if (strcmp(arg, "--list") == 0) {
+            listModels();
+            return 1;
+        }
+        const char* value = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return 2;
+        }
+        uint8_t choice;
+        if (strcmp(arg, "--model") == 0) {
+            if (!findBiosModel(value)) {
+                fprintf(stderr, "unknown model: %s (see --list)\n", value);
+                return 2;
+            }
+            options.model = value;
+        } else if (strcmp(arg, "--profile") == 0) {
+            if (!parseProfile(value, &choice)) {
+                fprintf(stderr, "unknown profile: %s\n", value);
+                return 2;
+            }
+            options.profile = choice;
+        } else if (strcmp(arg, "--payload") == 0) {
+            if (!parsePayload(value, &choice) || (choice != PAYLOAD_BIOS && choice != PAYLOAD_CHAIN)) {
+                fprintf(stderr, "payload must be bios or chain: %s\n", value);
+                return 2;
+            }
+            options.payload = choice;
+        } else if (strcmp(arg, "--latency-scale") == 0) {
+            options.latencyScale = atof(value);
+            if (options.latencyScale <= 0) {
+                fprintf(stderr, "bad latency scale: %s\n", value);
+                return 2;
+            }
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return 2;
+        }
+    }
+    return 0;
+}
+
+// ===========================================
+// Runs
+// ===========================================
+
+// The station as the technician left it: learned position, and the
+// values under test written the way the console would
+static long presetStation(const BiosModel& model, const Pacing& pacing) {
+    long applied = -1;
+    saveBootPosition(PAYLOAD_BIOS, model.learnedDowns);
+    loadTimingConfig();
+    initWaitTuning();
+    for (size_t i = 0; i < KNOB_COUNT; i++) {
+        if (pacing.value[i] < 0) continue;
+        if (knobs[i].learnedWait) {
+            applied = setLearnedWait(knobs[i].step, pacing.value[i]);
+        } else {
+            applied = setTimingValue(findTimingField(knobs[i].name), pacing.value[i]);
+        }
+    }
+    return applied;
+}
+
+static BiosRun runBios(const BiosModel& base, const BiosOptions& options, uint8_t profile,
+                       const Pacing& pacing) {
+    BiosModel model = base;
+    model.timing.scale(options.latencyScale);
+    uint8_t payload = options.payload;
+    bool show = options.show;
+
+    std::string text;
+    BiosRun run;
+    run.crashed = !runIsolated([&model, payload, profile, pacing, show](std::string& out) {
+        long applied = presetStation(model, pacing);
+
+        Scenario scenario;
+        scenario.payload = payload;
+        scenario.profile = profile;
+        scenario.limitMs = BIOS_RUN_LIMIT_MS;
+        DellBiosPc pc(model);
+        simSetPc(&pc);
+        RunResult result = runScenario(scenario);
+
+        BiosOutcome outcome = pc.bios().outcome();
+        char line[64];
+        snprintf(line, sizeof(line), "%d %u %.1f %ld ", outcome.correct && result.finished,
+                 pc.bios().lostKeys(), (result.runEnd - result.runStart) / 1000.0, applied);
+        out = line + outcome.verdict + (result.finished ? "" : " (run did not finish)") + "\n";
+        if (show) {
+            const std::vector<std::string>& events = pc.bios().events();
+            for (size_t i = 0; i < events.size(); i++) out += events[i] + "\n";
+        }
+    }, text);
+
+    run.ok = false;
+    run.lost = 0;
+    run.runMs = 0;
+    run.applied = -1;
+    if (run.crashed) {
+        run.verdict = "run crashed";
+        return run;
+    }
+    int ok = 0;
+    int used = 0;
+    sscanf(text.c_str(), "%d %u %lf %ld %n", &ok, &run.lost, &run.runMs, &run.applied, &used);
+    run.ok = (ok != 0);
+    size_t end = text.find('\n');
+    run.verdict = text.substr(used, end - used);
+    run.events = (end == std::string::npos) ? "" : text.substr(end + 1);
+    return run;
+}
+
+// ===========================================
+// Pacing search
+// ===========================================
+
+static uint16_t knobDefault(size_t knob) {
+    switch (knob) {
+        case 0: return NAV_KEY_GAP;
+        case 1: return KEY_DELAY;
+        case 2: return TYPE_SETTLE;
+        case 3: {
+            static const uint16_t dialog[3] = { TUNE_BIOS_DIALOG };
+            return dialog[0];
+        }
+        default: {
+            static const uint16_t load[3] = { TUNE_BIOS_LOAD };
+            return load[0];
+        }
+    }
+}
+
+// Smallest value of one knob that clears the password. Below the
+// default if the model is faster, above it if the default fails. The
+// firmware clamps to its floor/ceiling; -1 if no value works.
+static long minimumPassing(const BiosModel& model, const BiosOptions& options, size_t knob,
+                           bool* atFloor) {
+    Pacing pacing;
+    long lo = -1;                               // Known to fail (or below any floor)
+    long hi = knobDefault(knob);
+    *atFloor = false;
+
+    pacing.value[knob] = hi;
+    BiosRun run = runBios(model, options, PROFILE_TUNED, pacing);
+    while (!run.ok) {
+        if (run.applied < hi || hi >= PACING_MAX_FACTOR * knobDefault(knob)) return -1;
+        lo = hi;
+        hi *= 2;
+        pacing.value[knob] = hi;
+        run = runBios(model, options, PROFILE_TUNED, pacing);
+    }
+
+    while (hi - lo > PACING_STEP_MS) {
+        long mid = (lo + hi) / 2;
+        pacing.value[knob] = mid;
+        run = runBios(model, options, PROFILE_TUNED, pacing);
+        if (run.applied > mid) {
+            // Clamped: nothing lower than the floor is possible
+            if (run.ok) {
+                *atFloor = true;
+                return run.applied;
+            }
+            lo = run.applied;
+            continue;
+        }
+        if (run.ok) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    return hi;
+}
+
+static int commandPacing(const BiosOptions& options) {
+    printf("Minimum safe pacing: tuned profile, one value changed at a time\n");
+    printf("(* = the firmware's floor still works)\n\n");
+    printf("%-15s", "model");
+    for (size_t k = 0; k < KNOB_COUNT; k++) printf(" %12s", knobs[k].name);
+    printf("\n");
+
+    long fleet[KNOB_COUNT];
+    for (size_t k = 0; k < KNOB_COUNT; k++) fleet[k] = 0;
+    bool anyPassed = false;
+
+    const std::vector<BiosModel>& models = biosModels();
+    for (size_t m = 0; m < models.size(); m++) {
+        if (!options.model.empty() && options.model != models[m].name) continue;
+        printf("%-15s", models[m].name);
+        fflush(stdout);
+        for (size_t k = 0; k < KNOB_COUNT; k++) {
+            bool atFloor = false;
+            long value = minimumPassing(models[m], options, k, &atFloor);
+            if (value < 0) {
+                printf(" %12s", "fails");
+                continue;
+            }
+            anyPassed = true;
+            char cell[24];
+            snprintf(cell, sizeof(cell), "%ld%s", value, atFloor ? "*" : "");
+            printf(" %12s", cell);
+            if (value > fleet[k]) fleet[k] = value;
+        }
+        printf("\n");
+    }
+    if (!anyPassed) return 1;
+
+    printf("\n%-15s", "fleet minimum");
+    for (size_t k = 0; k < KNOB_COUNT; k++) printf(" %12ld", fleet[k]);
+    printf("\n%-15s", "suggested");
+    for (size_t k = 0; k < KNOB_COUNT; k++) {
+        long margin = fleet[k] * (100 + PACING_MARGIN_PCT) / 100;
+        printf(" %12ld", (margin + PACING_STEP_MS - 1) / PACING_STEP_MS * PACING_STEP_MS);
+    }
+    printf("\n%-15s", "now");
+    for (size_t k = 0; k < KNOB_COUNT; k++) printf(" %12u", knobDefault(k));
+    printf("\n");
+    return 0;
+}
+
+// ===========================================
+// bios
+// ===========================================
+
+int commandBios(int argc, char** argv) {
+    BiosOptions options;
+    int parsed = parseOptions(argc, argv, options);
+    if (parsed == 1) return 0;
+    if (parsed) {
+        usage();
+        return 2;
+    }
+    if (options.pacing) return commandPacing(options);
+
+    printf("%-15s %-7s %-6s %9s %5s  %s\n", "model", "profile", "result", "run s", "lost", "verdict");
+    int failed = 0;
+    int runs = 0;
+    const std::vector<BiosModel>& models = biosModels();
+    for (size_t m = 0; m < models.size(); m++) {
+        if (!options.model.empty() && options.model != models[m].name) continue;
+        for (uint8_t profile = 0; profile < PROFILE_COUNT; profile++) {
+            if (options.profile >= 0 && options.profile != profile) continue;
+            BiosRun run = runBios(models[m], options, profile, Pacing());
+            runs++;
+            if (!run.ok) failed++;
+            printf("%-15s %-7s %-6s %9.1f %5u  %s\n", models[m].name, profileWord(profile),
+                   run.ok ? "ok" : "FAIL", run.runMs / 1000, run.lost, run.verdict.c_str());
+            if (options.show) printf("%s\n", run.events.c_str());
+        }
+    }
+    printf("\n%d of %d runs cleared the password\n", runs - failed, runs);
+    return failed ? 1 : 0;
+}
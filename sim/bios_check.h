@@ -0,0 +1,30 @@
+/**
+ * BIOS Sequence Check
+ *
+ * Runs the BIOS payload against every Dell model in dell_bios.cpp and
+ * every timing profile (one forked child per run) and says whether the
+ * admin password ends up cleared - and if not, where the sequence went
+ * off the menus or which key the BIOS never saw.
+ *
+ *   simulator bios [--model NAME] [--profile P] [--payload bios|chain]
+ *                  [--latency-scale X] [--show] [--pacing] [--list]
+ *
+ * The station's learned extra DOWNs for each model are in the EEPROM
+ * before the run, as they would be after the technician's first visit.
+ * --latency-scale multiplies the model's response times.
+ *
+ * --pacing measures the minimum safe pacing instead: for each model,
+ * with the tuned profile, it searches one timing value at a time
+ * (nav_gap, key_delay, type_settle and the learned bios_dialog/bios_load
+ * waits) for the smallest value that still clears the password. That is
+ * below the default on a fast model and above it where the default
+ * fails. Then it prints the fleet-wide minimum and a suggestion with
+ * 25 % margin.
+ */
+
+#ifndef BIOS_CHECK_H
+#define BIOS_CHECK_H
+
+int commandBios(int argc, char** argv);
+
+#endif // BIOS_CHECK_H
@@ -0,0 +1,530 @@
+/**
+ * Dell BIOS Setup Model Implementation
+ */
+
+#include "dell_bios.h"
+#include "hid_names.h"
+#include <stdio.h>
+#include <string.h>
+
+#define USAGE_A             0x04
+#define USAGE_Z             0x1D
+#define USAGE_1             0x1E
+#define USAGE_0             0x27
+#define USAGE_ENTER         0x28
+#define USAGE_ESC           0x29
+#define USAGE_TAB           0x2B
+#define USAGE_SPACE         0x2C
+#define USAGE_F2            0x3B
+#define USAGE_RIGHT         0x4F
+#define USAGE_LEFT          0x50
+#define USAGE_DOWN          0x51
+#define USAGE_UP            0x52
+
+#define SHIFT_BITS          0x22
+#define MAX_FAILURES        3
+#define ADMIN_GROUP_CHILD   "Admin Password"
+
+// Pane controls
+#define PANE_CHANGE         0           // Admin Password page only
+#define OTHER_PANE_CONTROLS 3           // Restore Settings, Apply, Exit
+
+// Dialog controls
+#define OLD_FIELD           0
+#define OLD_OK              1
+#define OLD_CANCEL          2
+#define NEW_FIELD           0
+#define CONFIRM_FIELD       1
+
+void BiosTiming::scale(double factor) {
+    uint32_t* fields[] = { &expandMs, &paneMs, &dialogMs, &verifyMs, &saveMs, &setupLoadMs };
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        *fields[i] = (uint32_t)(*fields[i] * factor + 0.5);
+    }
+}
+
+std::string BiosState::key() const {
+    char text[64];
+    snprintf(text, sizeof(text), "%u %x %u %u %u %u%u|", screen, expanded, cursor, control,
+             failures, cleared, changed);
+    return text + oldText + "|" + newText + "|" + confirmText;
+}
+
+// ===========================================
+// Tree
+// ===========================================
+
+struct TreeRow {
+    int group;
+    int child;                  // -1 = the group itself
+};
+
+static std::vector<TreeRow> visibleRows(const BiosModel& model, const BiosState& state) {
+    std::vector<TreeRow> rows;
+    for (size_t g = 0; g < model.tree.size(); g++) {
+        TreeRow row = { (int)g, -1 };
+        rows.push_back(row);
+        if (!(state.expanded & (1UL << g))) continue;
+        for (size_t c = 0; c < model.tree[g].children.size(); c++) {
+            TreeRow child = { (int)g, (int)c };
+            rows.push_back(child);
+        }
+    }
+    return rows;
+}
+
+static const char* rowText(const BiosModel& model, const TreeRow& row) {
+    const BiosGroup& group = model.tree[row.group];
+    return (row.child < 0) ? group.name : group.children[row.child];
+}
+
+std::vector<std::string> DellBios::treeRows(const BiosModel& model, const BiosState& state) {
+    std::vector<TreeRow> rows = visibleRows(model, state);
+    std::vector<std::string> names;
+    for (size_t i = 0; i < rows.size(); i++) {
+        names.push_back(std::string(rows[i].child < 0 ? "" : "  ") + rowText(model, rows[i]));
+    }
+    return names;
+}
+
+static bool onAdminPage(const BiosModel& model, const BiosState& state) {
+    std::vector<TreeRow> rows = visibleRows(model, state);
+    return state.cursor < rows.size() && rows[state.cursor].child >= 0 &&
+           strcmp(rowText(model, rows[state.cursor]), ADMIN_GROUP_CHILD) == 0;
+}
+
+static uint8_t paneControls(const BiosModel& model, const BiosState& state) {
+    return OTHER_PANE_CONTROLS + (onAdminPage(model, state) ? 1 : 0);
+}
+
+static uint8_t newDialogControls(const BiosModel& model) {
+    return model.showCheckbox ? 5 : 4;    // New, confirm, [Show], Cancel, OK
+}
+
+static uint8_t applyControls(const BiosModel& model) {
+    return model.applyHasNo ? 3 : 2;      // Cancel, [No], Save
+}
+
+// ===========================================
+// Keys
+// ===========================================
+
+static char usageChar(uint8_t usage) {
+    if (usage >= USAGE_A && usage <= USAGE_Z) return 'a' + (usage - USAGE_A);
+    if (usage >= USAGE_1 && usage < USAGE_0) return '1' + (usage - USAGE_1);
+    if (usage == USAGE_0) return '0';
+    return 0;
+}
+
+static void cycle(uint8_t& control, uint8_t count, bool back) {
+    control = back ? (control + count - 1) % count : (control + 1) % count;
+}
+
+BiosState DellBios::startState() {
+    BiosState state;
+    state.screen = BIOS_TREE;
+    state.expanded = 0;
+    state.cursor = 0;
+    state.control = 0;
+    state.failures = 0;
+    state.cleared = false;
+    state.changed = false;
+    state.strayActions = 0;
+    return state;
+}
+
+static void treeKey(const BiosModel& model, BiosState& state, uint8_t usage, bool shift) {
+    std::vector<TreeRow> rows = visibleRows(model, state);
+    if (usage == USAGE_UP && state.cursor > 0) state.cursor--;
+    if (usage == USAGE_DOWN && state.cursor + 1u < rows.size()) state.cursor++;
+    if (usage == USAGE_TAB) {
+        state.screen = BIOS_PANE;
+        state.control = shift ? paneControls(model, state) - 1 : 0;
+    }
+    if (usage == USAGE_ENTER || usage == USAGE_RIGHT || usage == USAGE_LEFT) {
+        const TreeRow& row = rows[state.cursor];
+        if (row.child >= 0) return;
+        uint32_t bit = 1UL << row.group;
+        bool open = (state.expanded & bit) != 0;
+        if (usage == USAGE_RIGHT && open) return;
+        if (usage == USAGE_LEFT && !open) return;
+        state.expanded ^= bit;
+        if (strcmp(model.tree[row.group].name, "Security") != 0) state.strayActions++;
+    }
+}
+
+static void paneKey(const BiosModel& model, BiosState& state, uint8_t usage, bool shift) {
+    uint8_t count = paneControls(model, state);
+    if (usage == USAGE_TAB) {
+        bool leaving = shift ? (state.control == 0) : (state.control + 1 == count);
+        if (leaving) {
+            state.screen = BIOS_TREE;
+        } else {
+            cycle(state.control, count, shift);
+        }
+    }
+    if (usage != USAGE_ENTER && usage != USAGE_SPACE) return;
+
+    uint8_t control = state.control - (count - OTHER_PANE_CONTROLS);
+    if (count > OTHER_PANE_CONTROLS && state.control == PANE_CHANGE) {
+        state.screen = BIOS_OLD_PASSWORD;
+        state.control = OLD_FIELD;
+        state.oldText.clear();
+    } else if (control == 0) {
+        state.strayActions++;                   // Restore Settings
+    } else if (control == 2) {
+        state.screen = BIOS_EXITED;             // Exit
+    }
+}
+
+static void oldPasswordKey(const BiosModel& model, BiosState& state, uint8_t usage, bool shift) {
+    char c = usageChar(usage);
+    if (c && state.control == OLD_FIELD) state.oldText += c;
+    if (usage == USAGE_TAB) cycle(state.control, 3, shift);
+    if (usage == USAGE_ESC || ((usage == USAGE_ENTER || usage == USAGE_SPACE) && state.control == OLD_CANCEL)) {
+        state.screen = BIOS_PANE;
+        state.control = PANE_CHANGE;
+        return;
+    }
+    if (usage == USAGE_ENTER) {
+        if (state.oldText == model.password) {
+            state.screen = BIOS_NEW_PASSWORD;
+            state.control = NEW_FIELD;
+            state.newText.clear();
+            state.confirmText.clear();
+        } else {
+            state.failures++;
+            state.screen = (state.failures >= MAX_FAILURES) ? BIOS_LOCKED : BIOS_INVALID;
+        }
+    }
+}
+
+static void newPasswordKey(const BiosModel& model, BiosState& state, uint8_t usage, bool shift) {
+    uint8_t count = newDialogControls(model);
+    uint8_t cancel = count - 2;
+    uint8_t ok = count - 1;
+    char c = usageChar(usage);
+    if (c && state.control == NEW_FIELD) state.newText += c;
+    if (c && state.control == CONFIRM_FIELD) state.confirmText += c;
+    if (usage == USAGE_TAB) cycle(state.control, count, shift);
+    bool activate = (usage == USAGE_ENTER || usage == USAGE_SPACE);
+
+    if (usage == USAGE_ESC || (activate && state.control == cancel)) {
+        state.screen = BIOS_PANE;
+        state.control = PANE_CHANGE;
+    } else if (activate && state.control == ok) {
+        if (!state.newText.empty()) {
+            state.changed = (state.newText == state.confirmText);
+            state.screen = state.changed ? BIOS_APPLY : BIOS_INVALID;
+        } else if (state.confirmText == model.password) {
+            state.cleared = true;
+            state.screen = BIOS_APPLY;
+        } else {
+            state.screen = BIOS_INVALID;
+        }
+        state.control = 0;
+    }
+}
+
+static void applyKeyDialog(const BiosModel& model, BiosState& state, uint8_t usage, bool shift) {
+    uint8_t count = applyControls(model);
+    if (usage == USAGE_TAB || usage == USAGE_LEFT || usage == USAGE_RIGHT) {
+        cycle(state.control, count, shift || usage == USAGE_LEFT);
+    }
+    bool activate = (usage == USAGE_ENTER || usage == USAGE_SPACE);
+    if (usage == USAGE_ESC || (activate && state.control == 0)) {
+        state.screen = BIOS_PANE;               // Cancel: still pending
+        state.control = PANE_CHANGE;
+    } else if (activate && state.control == count - 1) {
+        state.screen = BIOS_SAVED;
+    } else if (activate) {
+        state.cleared = false;                  // No: changes discarded
+        state.changed = false;
+        state.screen = BIOS_TREE;
+    }
+}
+
+void DellBios::applyKey(const BiosModel& model, BiosState& state, uint8_t usage, uint8_t modifiers) {
+    bool shift = (modifiers & SHIFT_BITS) != 0;
+    switch (state.screen) {
+        case BIOS_TREE:
+            treeKey(model, state, usage, shift);
+            break;
+        case BIOS_PANE:
+            paneKey(model, state, usage, shift);
+            break;
+        case BIOS_OLD_PASSWORD:
+            oldPasswordKey(model, state, usage, shift);
+            break;
+        case BIOS_NEW_PASSWORD:
+            newPasswordKey(model, state, usage, shift);
+            break;
+        case BIOS_INVALID:
+            if (usage == USAGE_ENTER || usage == USAGE_ESC) {
+                state.screen = BIOS_PANE;
+                state.control = PANE_CHANGE;
+            }
+            break;
+        case BIOS_APPLY:
+            applyKeyDialog(model, state, usage, shift);
+            break;
+        default:                                // Finished: nothing reads keys
+            break;
+    }
+}
+
+uint32_t DellBios::keyLatency(const BiosModel& model, const BiosState& before,
+                              const BiosState& after) {
+    const BiosTiming& timing = model.timing;
+    if (after.screen == before.screen) {
+        if (after.expanded != before.expanded) return timing.expandMs;
+        if (after.screen == BIOS_TREE && after.cursor != before.cursor) return timing.paneMs;
+        return 0;
+    }
+    switch (after.screen) {
+        case BIOS_OLD_PASSWORD:
+        case BIOS_APPLY:
+            return (before.screen == BIOS_NEW_PASSWORD) ? timing.verifyMs : timing.dialogMs;
+        case BIOS_NEW_PASSWORD:
+        case BIOS_INVALID:
+        case BIOS_LOCKED:
+            return timing.verifyMs;
+        case BIOS_SAVED:
+            return timing.saveMs;
+    }
+    return 0;
+}
+
+// ===========================================
+// Timed BIOS
+// ===========================================
+
+DellBios::DellBios(const BiosModel& model)
+    : model(model), current(startState()), powerOn(0), f2Seen(false), missedSetup(false),
+      busyUntil(0), lost(0), keys(0), endTime(0) {
+}
+
+uint32_t DellBios::readyAt() const {
+    return f2Seen ? powerOn + model.timing.postMs + model.timing.setupLoadMs : 0;
+}
+
+bool DellBios::inSetup(uint32_t atMs) const {
+    return f2Seen && atMs >= readyAt();
+}
+
+bool DellBios::isDone() const {
+    return missedSetup || current.screen >= BIOS_SAVED;
+}
+
+void DellBios::note(uint32_t atMs, const std::string& text) {
+    char stamp[24];
+    snprintf(stamp, sizeof(stamp), "  %10.3f  ", atMs / 1000.0);
+    log.push_back(stamp + text);
+}
+
+void DellBios::press(uint8_t usage, uint8_t modifiers, uint32_t atMs) {
+    if (isDone()) return;
+    if (!powerOn) {
+        powerOn = atMs;
+        note(atMs, "power on, POST");
+    }
+
+    uint32_t postEnd = powerOn + model.timing.postMs;
+    if (!f2Seen) {
+        if (atMs >= postEnd) {
+            missedSetup = true;
+            note(postEnd, "POST over without F2: booting the disk");
+            return;
+        }
+        if (usage == USAGE_F2 && atMs >= powerOn + model.timing.f2FromMs) {
+            f2Seen = true;
+            note(atMs, "F2 read: entering Setup");
+        }
+        return;
+    }
+
+    std::string name = usageName(usage);
+    if (!inSetup(atMs)) {
+        if (usage == USAGE_F2) return;          // The rest of the spam
+        lost++;
+        if (firstLost.empty()) firstLost = name + " while Setup was still loading";
+        note(atMs, name + " lost: Setup still loading");
+        return;
+    }
+    keys++;
+    if (atMs < busyUntil) {
+        lost++;
+        if (firstLost.empty()) firstLost = name + " while the BIOS was busy";
+        note(atMs, name + " lost: busy");
+        return;
+    }
+
+    BiosState before = current;
+    applyKey(model, current, usage, modifiers);
+    uint32_t latency = keyLatency(model, before, current);
+    busyUntil = atMs + latency;
+    if (isDone()) endTime = atMs;
+
+    static const char* const screenNames[] = {
+        "tree", "pane", "old password", "new password", "invalid password",
+        "save changes", "saved", "exited", "locked"
+    };
+    std::string text = name + " -> " + screenNames[current.screen];
+    if (current.screen == BIOS_TREE) {
+        text += std::string(": ") + treeRows(model, current)[current.cursor];
+    } else if (current.screen != BIOS_SAVED && current.screen < BIOS_EXITED) {
+        char control[24];
+        snprintf(control, sizeof(control), " [%u]", current.control);
+        text += control;
+    }
+    if (latency) {
+        char busy[24];
+        snprintf(busy, sizeof(busy), " (busy %u ms)", latency);
+        text += busy;
+    }
+    note(atMs, text);
+}
+
+BiosOutcome DellBios::outcome() const {
+    BiosOutcome outcome;
+    outcome.correct = false;
+    if (missedSetup) {
+        outcome.verdict = powerOn ? "missed the F2 window" : "no keys";
+    } else if (!f2Seen) {
+        outcome.verdict = "still in POST";
+    } else if (current.screen == BIOS_SAVED) {
+        outcome.correct = current.cleared;
+        outcome.verdict = current.cleared ? "password cleared" :
+                          current.changed ? "a new password was set" : "saved without clearing";
+    } else if (current.screen == BIOS_LOCKED) {
+        outcome.verdict = "locked out (3 wrong passwords)";
+    } else if (current.screen == BIOS_EXITED) {
+        outcome.verdict = "left Setup";
+    } else {
+        static const char* const stuck[] = {
+            "stuck in the tree", "stuck on the page", "stuck in the old password dialog",
+            "stuck in the new password dialog", "stuck on Invalid password",
+            "stuck in the save dialog"
+        };
+        outcome.verdict = stuck[current.screen];
+    }
+    if (!outcome.correct && !firstLost.empty()) outcome.verdict += ", first lost: " + firstLost;
+    return outcome;
+}
+
+// ===========================================
+// Simulated target
+// ===========================================
+
+DellBiosPc::DellBiosPc(const BiosModel& model) : dell(model) {
+    memset(&previous, 0, sizeof(previous));
+}
+
+void DellBiosPc::onKeyReport(const SimKeyReport& report) {
+    BasicPc::onKeyReport(report);
+    uint32_t atMs = report.hostAt / 1000;
+    for (int i = 0; i < 6; i++) {
+        uint8_t usage = report.keys[i];
+        if (usage && isKeyPress(previous, report, usage)) {
+            dell.press(usage, report.modifiers, atMs);
+        }
+    }
+    previous = report;
+}
+
+// ===========================================
+// Models
+// ===========================================
+
+static std::vector<BiosGroup> makeTree(const char* const* groups, size_t count) {
+    static const char* const security[] = {
+        "Admin Password", "System Password", "Internal HDD-0 Password", "Strong Password",
+        "Password Configuration", "Password Bypass", "Password Change", "TPM 2.0 Security"
+    };
+    std::vector<BiosGroup> tree;
+    for (size_t i = 0; i < count; i++) {
+        BiosGroup group;
+        group.name = groups[i];
+        if (strcmp(groups[i], "Security") == 0) {
+            group.children.assign(security, security + sizeof(security) / sizeof(security[0]));
+        } else {
+            group.children.push_back("Overview");
+        }
+        tree.push_back(group);
+    }
+    return tree;
+}
+
+#define TREE(groups) makeTree(groups, sizeof(groups) / sizeof(groups[0]))
+
+// Security sixth: the payload's "Down 5" lands on it
+static const char* const latitude5490[] = {
+    "General", "System Configuration", "Video", "Storage", "Display", "Security",
+    "Secure Boot", "Performance", "Power Management", "POST Behavior", "Wireless", "Maintenance"
+};
+static const char* const optiplex7050[] = {
+    "General", "System Configuration", "Video", "Storage", "Display", "Connection", "Security",
+    "Secure Boot", "Performance", "Power Management", "POST Behavior", "Maintenance"
+};
+static const char* const latitudeE7470[] = {
+    "General", "System Configuration", "Video", "Storage", "Display", "Connection", "Power",
+    "Security", "Secure Boot", "Performance", "POST Behavior", "Wireless", "Maintenance"
+};
+static const char* const precision3630[] = {
+    "General", "System Configuration", "Video", "Storage", "Display", "Security",
+    "Secure Boot", "Performance", "Power Management", "Manageability", "Maintenance"
+};
+static const char* const optiplex3020[] = {
+    "General", "System Configuration", "Video", "Storage", "Display", "Security",
+    "Performance", "Power Management", "POST Behavior", "Maintenance"
+};
+
+static BiosModel makeModel(const char* name, const char* description, std::vector<BiosGroup> tree,
+                           bool showCheckbox, bool applyHasNo, uint8_t learnedDowns,
+                           uint32_t postMs, uint32_t setupLoadMs, uint32_t expandMs,
+                           uint32_t paneMs, uint32_t dialogMs, uint32_t verifyMs) {
+    BiosModel model;
+    model.name = name;
+    model.description = description;
+    model.tree = tree;
+    model.password = "ls3gt1";
+    model.showCheckbox = showCheckbox;
+    model.applyHasNo = applyHasNo;
+    model.learnedDowns = learnedDowns;
+    model.timing.postMs = postMs;
+    model.timing.f2FromMs = 1000;
+    model.timing.setupLoadMs = setupLoadMs;
+    model.timing.expandMs = expandMs;
+    model.timing.paneMs = paneMs;
+    model.timing.dialogMs = dialogMs;
+    model.timing.verifyMs = verifyMs;
+    model.timing.saveMs = 2000;
+    return model;
+}
+
+const std::vector<BiosModel>& biosModels() {
+    static std::vector<BiosModel> models;
+    if (models.empty()) {
+        // Dialog variants and learned DOWNs, then POST, Setup load, expand,
+        // page, dialog and password check times
+        models.push_back(makeModel("latitude-5490", "Reference: the payload's sequence as written",
+                                   TREE(latitude5490), true, true, 0, 6000, 5000, 250, 200, 350, 500));
+        models.push_back(makeModel("optiplex-7050", "Security one row lower, slow password check",
+                                   TREE(optiplex7050), true, true, 1, 9000, 4000, 400, 300, 600, 900));
+        models.push_back(makeModel("latitude-e7470", "Security two rows lower, fast",
+                                   TREE(latitudeE7470), true, true, 2, 5000, 3000, 150, 120, 250, 300));
+        models.push_back(makeModel("precision-3630", "Newer dialogs: no Show characters, Cancel/Save",
+                                   TREE(precision3630), false, false, 0, 7000, 5000, 250, 200, 350, 500));
+        models.push_back(makeModel("optiplex-3020", "Old and slow: long POST and Setup load",
+                                   TREE(optiplex3020), true, true, 0, 12000, 7000, 500, 400, 450, 600));
+    }
+    return models;
+}
+
+const BiosModel* findBiosModel(const std::string& name) {
+    const std::vector<BiosModel>& models = biosModels();
+    for (size_t i = 0; i < models.size(); i++) {
+        if (name == models[i].name) return &models[i];
+    }
+    return NULL;
+}
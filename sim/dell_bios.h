@@ -0,0 +1,164 @@
+/**
+ * Dell BIOS Setup Model
+ *
+ * The part of a Dell BIOS the BIOS payload talks to, as a state machine
+ * that takes key presses: POST with its F2 window, the Settings tree
+ * (groups that Enter expands), the page pane next to it, and the admin
+ * password dialogs - old password, new/confirm, save changes.
+ *
+ * Rules the model assumes (the ones executeBIOSPasswordRemoval relies on):
+ *  - The tree starts collapsed with the cursor on the first group;
+ *    Security sits where the station's learned extra DOWNs put it
+ *  - Tab goes from the tree into the pane, through its controls and
+ *    back to the tree
+ *  - "Change" on the Admin Password page asks for the old password
+ *    (field, OK, Cancel)
+ *  - The next dialog clears the password when the new password is left
+ *    empty and the old one is typed again into the confirm field
+ *  - Save-changes dialogs open with Cancel focused
+ *
+ * Time: POST starts at the first key report (the technician powers the
+ * target up as the run starts). F2 counts only inside the F2 window.
+ * Opening a group, switching pages, opening a dialog, checking a
+ * password and saving keep the BIOS busy; keys that arrive then are
+ * lost, as on the real machines.
+ */
+
+#ifndef DELL_BIOS_H
+#define DELL_BIOS_H
+
+#include "sim_pc.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct BiosGroup {
+    const char* name;
+    std::vector<const char*> children;
+};
+
+// Response times of one model (ms)
+struct BiosTiming {
+    uint32_t postMs;            // Power-on -> POST over (end of the F2 window)
+    uint32_t f2FromMs;          // F2 is read from here on
+    uint32_t setupLoadMs;       // POST over -> Setup takes keys
+    uint32_t expandMs;          // Enter on a group
+    uint32_t paneMs;            // Cursor onto another page
+    uint32_t dialogMs;          // A dialog opening
+    uint32_t verifyMs;          // Checking the old password
+    uint32_t saveMs;            // Save -> reboot
+
+    void scale(double factor);
+};
+
+struct BiosModel {
+    const char* name;
+    const char* description;
+    std::vector<BiosGroup> tree;
+    const char* password;       // Admin password set on the machine
+    bool showCheckbox;          // New-password dialog has "Show characters"
+    bool applyHasNo;            // Save dialog: Cancel, No, Save (else Cancel, Save)
+    uint8_t learnedDowns;       // Extra DOWNs a technician confirms at this station
+    BiosTiming timing;
+};
+
+enum BiosScreen {
+    BIOS_TREE = 0,
+    BIOS_PANE,
+    BIOS_OLD_PASSWORD,          // Field, OK, Cancel
+    BIOS_NEW_PASSWORD,          // New, confirm, [Show characters], Cancel, OK
+    BIOS_INVALID,               // "Invalid password" message
+    BIOS_APPLY,                 // Save changes? Cancel, [No], Save
+    BIOS_SAVED,                 // Saved, rebooting
+    BIOS_EXITED,                // Left Setup without saving
+    BIOS_LOCKED                 // Three wrong passwords: system halted
+};
+
+// Everything that decides what the next key does (the planner's state)
+struct BiosState {
+    uint8_t screen;             // BiosScreen
+    uint32_t expanded;          // Bit per group
+    uint8_t cursor;             // Visible tree row
+    uint8_t control;            // Focused control on the pane or dialog
+    std::string oldText;        // Old password field
+    std::string newText;        // New password field
+    std::string confirmText;    // Confirm field
+    uint8_t failures;           // Wrong old passwords
+    bool cleared;               // Password removed (saved on BIOS_SAVED)
+    bool changed;               // A new password was set instead
+    uint16_t strayActions;      // Other groups opened, settings restored...
+
+    std::string key() const;
+};
+
+struct BiosOutcome {
+    bool correct;               // Password cleared and saved
+    std::string verdict;
+};
+
+class DellBios {
+public:
+    explicit DellBios(const BiosModel& model);
+
+    // A key press reaches the target at atMs (HID usage, modifier bits)
+    void press(uint8_t usage, uint8_t modifiers, uint32_t atMs);
+
+    const BiosState& state() const { return current; }
+    bool inSetup(uint32_t atMs) const;
+    bool isDone() const;        // Saved, exited, locked or booted past Setup
+    uint32_t lostKeys() const { return lost; }
+    uint32_t setupKeys() const { return keys; }     // Keys that reached Setup (lost ones too)
+    uint32_t readyAt() const;                       // Setup took keys from (0 = never)
+    uint32_t endedAt() const { return endTime; }    // Saved/exited/locked (0 = not yet)
+    BiosOutcome outcome() const;
+
+    // What happened, one line per event ("   12.345  Down -> Security")
+    const std::vector<std::string>& events() const { return log; }
+
+    // The state Setup opens with
+    static BiosState startState();
+
+    // Apply one key to a settled state (no time involved)
+    static void applyKey(const BiosModel& model, BiosState& state, uint8_t usage, uint8_t modifiers);
+
+    // How long the BIOS is busy after that key (0 = ready at once)
+    static uint32_t keyLatency(const BiosModel& model, const BiosState& before, const BiosState& after);
+
+    // Visible tree rows ("Security", "  Admin Password")
+    static std::vector<std::string> treeRows(const BiosModel& model, const BiosState& state);
+
+private:
+    void note(uint32_t atMs, const std::string& text);
+
+    const BiosModel& model;
+    BiosState current;
+    uint32_t powerOn;           // First key report (0 = not yet)
+    bool f2Seen;
+    bool missedSetup;
+    uint32_t busyUntil;
+    uint32_t lost;
+    uint32_t keys;
+    uint32_t endTime;
+    std::string firstLost;
+    std::vector<std::string> log;
+};
+
+// A Dell target for the simulator: keys go to the model until the
+// password is saved, then it is a BasicPc again (Num Lock echo)
+class DellBiosPc : public BasicPc {
+public:
+    explicit DellBiosPc(const BiosModel& model);
+    void onKeyReport(const SimKeyReport& report);
+
+    const DellBios& bios() const { return dell; }
+
+private:
+    DellBios dell;
+    SimKeyReport previous;
+};
+
+// Latitude, OptiPlex and Precision variants: tree order, dialogs, timing
+const std::vector<BiosModel>& biosModels();
+const BiosModel* findBiosModel(const std::string& name);
+
+#endif // DELL_BIOS_H
@@ -0,0 +1,288 @@
+/**
+ * Golden Keystroke Traces Implementation
+ */
+
+#include "golden_trace.h"
+#include "hid_names.h"
+#include "isolated.h"
+#include "scenario.h"
+#include "sim_pc.h"
+#include "../include/config.h"
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define MAX_SHOWN_MISMATCHES    5
+
+struct TraceOptions {
+    bool update;
+    int payload;                // -1 = all
+    int profile;
+    std::string goldenDir;
+    double tolerancePct;
+    double toleranceMs;
+};
+
+// One parsed trace line
+struct TraceStep {
+    double gapMs;
+    uint8_t report[7];          // Modifiers, six key slots
+    std::string text;           // The whole line, for messages
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator trace --check|--update [--payload P] [--profile P] [--golden DIR]\n"
+        "                       [--tolerance-pct N] [--tolerance-ms N]\n");
+}
+
+static bool parseOptions(int argc, char** argv, TraceOptions& options) {
+    bool modeGiven = false;
+    options.update = false;
+    options.payload = -1;
+    options.profile = -1;
+    options.goldenDir = "sim/golden";
+    options.tolerancePct = 5;
+    options.toleranceMs = 2;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--check") == 0 || strcmp(arg, "--update") == 0) {
+            options.update = (arg[2] == 'u');
+            modeGiven = true;
+            continue;
+        }
+        const char* value = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return false;
+        }
+        uint8_t choice;
+        if (strcmp(arg, "--payload") == 0) {
+            if (!parsePayload(value, &choice)) {
+                fprintf(stderr, "unknown payload: %s\n", value);
+                return false;
+            }
+            options.payload = choice;
+        } else if (strcmp(arg, "--profile") == 0) {
+            if (!parseProfile(value, &choice)) {
+                fprintf(stderr, "unknown profile: %s\n", value);
+                return false;
+            }
+            options.profile = choice;
+        } else if (strcmp(arg, "--golden") == 0) {
+            options.goldenDir = value;
+        } else if (strcmp(arg, "--tolerance-pct") == 0) {
+            options.tolerancePct = atof(value);
+        } else if (strcmp(arg, "--tolerance-ms") == 0) {
+            options.toleranceMs = atof(value);
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        }
+    }
+    if (!modeGiven) fprintf(stderr, "--check or --update?\n");
+    return modeGiven;
+}
+
+// ===========================================
+// Recording
+// ===========================================
+
+// Run one payload in a child and format its report stream
+static bool recordTrace(uint8_t payload, uint8_t profile, std::string& trace) {
+    return runIsolated([payload, profile](std::string& out) {
+        Scenario scenario;
+        scenario.payload = payload;
+        scenario.profile = profile;
+
+        BasicPc pc;
+        simSetPc(&pc);
+        RunResult result = runScenario(scenario);
+
+        char line[128];
+        snprintf(line, sizeof(line), "# %s/%s: gap_ms modifiers keys[6] | change\n",
+                 payloadWord(payload), profileWord(profile));
+        out = line;
+        snprintf(line, sizeof(line), "# run %s, regenerate with: simulator trace --update\n",
+                 result.finished ? "finished" : "did not finish");
+        out += line;
+
+        const std::vector<SimKeyReport>& reports = simKeyReports();
+        SimKeyReport last;
+        memset(&last, 0, sizeof(last));
+        SimTime lastAt = 0;
+        for (size_t i = 0; i < reports.size(); i++) {
+            const SimKeyReport& report = reports[i];
+            snprintf(line, sizeof(line), "%10.3f  %02x %02x %02x %02x %02x %02x %02x | %s\n",
+                     (report.hostAt - lastAt) / 1000.0, report.modifiers,
+                     report.keys[0], report.keys[1], report.keys[2],
+                     report.keys[3], report.keys[4], report.keys[5],
+                     describeReportChange(last, report).c_str());
+            out += line;
+            last = report;
+            lastAt = report.hostAt;
+        }
+    }, trace);
+}
+
+static std::vector<TraceStep> parseTrace(const std::string& text) {
+    std::vector<TraceStep> steps;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        if (line.empty() || line[0] == '#') continue;
+
+        TraceStep step;
+        unsigned int bytes[7];
+        if (sscanf(line.c_str(), "%lf %x %x %x %x %x %x %x", &step.gapMs, &bytes[0], &bytes[1],
+                   &bytes[2], &bytes[3], &bytes[4], &bytes[5], &bytes[6]) != 8) {
+            continue;
+        }
+        for (int i = 0; i < 7; i++) step.report[i] = (uint8_t)bytes[i];
+        step.text = line;
+        steps.push_back(step);
+    }
+    return steps;
+}
+
+// ===========================================
+// Files
+// ===========================================
+
+static std::string goldenPath(const TraceOptions& options, uint8_t payload, uint8_t profile) {
+    return options.goldenDir + "/" + payloadWord(payload) + "_" + profileWord(profile) + ".trace";
+}
+
+static bool readFile(const std::string& path, std::string& text) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char chunk[4096];
+    size_t got;
+    text.clear();
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, got);
+    fclose(file);
+    return true;
+}
+
+static bool writeFile(const std::string& path, const std::string& text) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    return (fclose(file) == 0) && ok;
+}
+
+// ===========================================
+// Comparison
+// ===========================================
+
+static void appendf(std::string& out, const char* format, ...) {
+    char text[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    out += text;
+}
+
+// True if the recorded steps match the golden ones, otherwise why not
+static bool compareTrace(const std::vector<TraceStep>& golden, const std::vector<TraceStep>& now,
+                         const TraceOptions& options, std::string& why) {
+    size_t common = (golden.size() < now.size()) ? golden.size() : now.size();
+
+    // Keys first: the first report that differs is what matters
+    for (size_t i = 0; i < common; i++) {
+        if (memcmp(golden[i].report, now[i].report, sizeof(golden[i].report)) != 0) {
+            appendf(why, "    report %zu differs\n      golden: %s\n      now:    %s\n",
+                    i + 1, golden[i].text.c_str(), now[i].text.c_str());
+            return false;
+        }
+    }
+    if (golden.size() != now.size()) {
+        appendf(why, "    %zu reports, golden has %zu\n", now.size(), golden.size());
+        const std::vector<TraceStep>& longer = (golden.size() > now.size()) ? golden : now;
+        appendf(why, "      first %s: %s\n", (golden.size() > now.size()) ? "missing" : "extra",
+                longer[common].text.c_str());
+        return false;
+    }
+
+    int late = 0;
+    for (size_t i = 0; i < common; i++) {
+        double allowed = golden[i].gapMs * options.tolerancePct / 100 + options.toleranceMs;
+        if (fabs(now[i].gapMs - golden[i].gapMs) <= allowed) continue;
+        if (late < MAX_SHOWN_MISMATCHES) {
+            appendf(why, "    report %zu gap %.3f ms, golden %.3f +- %.3f ms (%s)\n", i + 1,
+                    now[i].gapMs, golden[i].gapMs, allowed,
+                    now[i].text.substr(now[i].text.find('|') + 2).c_str());
+        }
+        late++;
+    }
+    if (late > MAX_SHOWN_MISMATCHES) {
+        appendf(why, "    ... %d gaps out of bounds\n", late);
+    }
+    return late == 0;
+}
+
+// ===========================================
+// trace
+// ===========================================
+
+int commandTrace(int argc, char** argv) {
+    TraceOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    int failed = 0;
+    int checked = 0;
+    for (uint8_t payload = 0; payload < PAYLOAD_COUNT; payload++) {
+        if (options.payload >= 0 && options.payload != payload) continue;
+        for (uint8_t profile = 0; profile < PROFILE_COUNT; profile++) {
+            if (options.profile >= 0 && options.profile != profile) continue;
+
+            std::string path = goldenPath(options, payload, profile);
+            std::string trace;
+            if (!recordTrace(payload, profile, trace)) {
+                printf("FAIL    %s (run crashed)\n", path.c_str());
+                failed++;
+                continue;
+            }
+            std::vector<TraceStep> now = parseTrace(trace);
+
+            if (options.update) {
+                if (!writeFile(path, trace)) {
+                    printf("FAIL    %s (cannot write)\n", path.c_str());
+                    failed++;
+                } else {
+                    printf("updated %s (%zu reports)\n", path.c_str(), now.size());
+                }
+                continue;
+            }
+
+            checked++;
+            std::string text;
+            if (!readFile(path, text)) {
+                printf("FAIL    %s (no golden - run trace --update)\n", path.c_str());
+                failed++;
+                continue;
+            }
+            std::vector<TraceStep> golden = parseTrace(text);
+            std::string why;
+            bool match = compareTrace(golden, now, options, why);
+            printf("%-7s %s (%zu reports)\n%s", match ? "ok" : "FAIL", path.c_str(),
+                   now.size(), why.c_str());
+            if (!match) failed++;
+        }
+    }
+
+    if (!options.update) {
+        printf("\n%d of %d traces match\n", checked - failed, checked);
+    }
+    return failed ? 1 : 0;
+}
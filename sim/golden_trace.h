@@ -0,0 +1,24 @@
+/**
+ * Golden Keystroke Traces
+ *
+ * The exact keyboard report stream of every payload and profile,
+ * checked in under sim/golden/. A change to keyboard_utils or the
+ * payload code that alters a key, its order, or the pace it is sent
+ * at fails the check; a change that is meant to do so updates them.
+ *
+ *   simulator trace --check  [--payload P] [--profile P] [--golden DIR]
+ *                            [--tolerance-pct N] [--tolerance-ms N]
+ *   simulator trace --update [--payload P] [--profile P] [--golden DIR]
+ *
+ * Each line is one report: the gap since the previous report (host
+ * time), the modifier byte and the six key slots, then what changed.
+ * Keys must match exactly; each gap may differ by tolerance-pct
+ * percent plus tolerance-ms (default 5 % + 2 ms).
+ */
+
+#ifndef GOLDEN_TRACE_H
+#define GOLDEN_TRACE_H
+
+int commandTrace(int argc, char** argv);
+
+#endif // GOLDEN_TRACE_H
@@ -0,0 +1,97 @@
+/**
+ * HID Key Names Implementation
+ */
+
+#include "hid_names.h"
+#include <stdio.h>
+#include <string.h>
+
+struct UsageName {
+    uint8_t usage;
+    const char* name;
+};
+
+static const UsageName namedUsages[] = {
+    { 0x28, "ENTER" },    { 0x29, "ESC" },       { 0x2A, "BACKSPACE" },
+    { 0x2B, "TAB" },      { 0x2C, "SPACE" },     { 0x39, "CAPSLOCK" },
+    { 0x46, "PRINTSCR" }, { 0x47, "SCROLLLOCK" },{ 0x48, "PAUSE" },
+    { 0x49, "INSERT" },   { 0x4A, "HOME" },      { 0x4B, "PAGEUP" },
+    { 0x4C, "DELETE" },   { 0x4D, "END" },       { 0x4E, "PAGEDOWN" },
+    { 0x4F, "RIGHT" },    { 0x50, "LEFT" },      { 0x51, "DOWN" },
+    { 0x52, "UP" },       { 0x53, "NUMLOCK" },   { 0x65, "MENU" },
+    { 0x2D, "-" },        { 0x2E, "=" },         { 0x2F, "[" },
+    { 0x30, "]" },        { 0x31, "\\" },        { 0x33, ";" },
+    { 0x34, "'" },        { 0x35, "`" },         { 0x36, "," },
+    { 0x37, "." },        { 0x38, "/" }
+};
+
+static const char* const modifierNames[8] = {
+    "LCTRL", "LSHIFT", "LALT", "LGUI", "RCTRL", "RSHIFT", "RALT", "RGUI"
+};
+
+std::string usageName(uint8_t usage) {
+    char text[8];
+    if (usage >= 0x04 && usage <= 0x1D) {
+        text[0] = 'a' + (usage - 0x04);
+        text[1] = '\0';
+        return text;
+    }
+    if (usage >= 0x1E && usage <= 0x27) {
+        text[0] = (usage == 0x27) ? '0' : '1' + (usage - 0x1E);
+        text[1] = '\0';
+        return text;
+    }
+    if (usage >= 0x3A && usage <= 0x45) {
+        snprintf(text, sizeof(text), "F%d", usage - 0x3A + 1);
+        return text;
+    }
+    for (size_t i = 0; i < sizeof(namedUsages) / sizeof(namedUsages[0]); i++) {
+        if (namedUsages[i].usage == usage) return namedUsages[i].name;
+    }
+    snprintf(text, sizeof(text), "0x%02X", usage);
+    return text;
+}
+
+const char* modifierName(uint8_t bit) {
+    return (bit < 8) ? modifierNames[bit] : "?";
+}
+
+static bool hasKey(const SimKeyReport& report, uint8_t usage) {
+    for (int i = 0; i < 6; i++) {
+        if (report.keys[i] == usage) return true;
+    }
+    return false;
+}
+
+std::string describeReportChange(const SimKeyReport& before, const SimKeyReport& after) {
+    std::string text;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        bool was = before.modifiers & (1 << bit);
+        bool is = after.modifiers & (1 << bit);
+        if (was != is) {
+            if (!text.empty()) text += ' ';
+            text += is ? '+' : '-';
+            text += modifierNames[bit];
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        if (before.keys[i] && !hasKey(after, before.keys[i])) {
+            if (!text.empty()) text += ' ';
+            text += '-' + usageName(before.keys[i]);
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        if (after.keys[i] && !hasKey(before, after.keys[i])) {
+            if (!text.empty()) text += ' ';
+            text += '+' + usageName(after.keys[i]);
+        }
+    }
+    return text.empty() ? "=" : text;
+}
+
+uint8_t usageFromName(const std::string& name) {
+    for (int usage = 1; usage < 0x100; usage++) {
+        if (usageName((uint8_t)usage) == name) return (uint8_t)usage;
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+/**
+ * HID Key Names
+ *
+ * Readable names for keyboard usages and report changes, shared by
+ * everything in sim/ that prints keys ("F12", "DOWN", "a", "LSHIFT").
+ */
+
+#ifndef HID_NAMES_H
+#define HID_NAMES_H
+
+#include <SimHost.h>
+#include <stdint.h>
+#include <string>
+
+// Name of a keyboard usage ("ENTER", "a", "F12"), "0xNN" if unnamed
+std::string usageName(uint8_t usage);
+
+// Name of a modifier bit (0-7)
+const char* modifierName(uint8_t bit);
+
+// What changed between two reports: "+F12", "-F12", "+LSHIFT +a"
+std::string describeReportChange(const SimKeyReport& before, const SimKeyReport& after);
+
+// Usage for a name from usageName(), 0 if unknown
+uint8_t usageFromName(const std::string& name);
+
+#endif // HID_NAMES_H
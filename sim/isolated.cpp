@@ -0,0 +1,63 @@
+/**
+ * Isolated Runs Implementation
+ */
+
+#include "isolated.h"
+#include <mutex>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+// Pipe, fork and closing the parent's write end happen as one step, so
+// a child forked by another thread never inherits this pipe's write end
+// (which would hold off our EOF until that child exits)
+static std::mutex forkLock;
+
+bool runIsolated(std::function<void(std::string& output)> work, std::string& output) {
+    output.clear();
+    std::unique_lock<std::mutex> lock(forkLock);
+    fflush(stdout);
+    fflush(stderr);
+
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        std::string result;
+        work(result);
+        bool sent = writeAll(fds[1], result.data(), result.size());
+        close(fds[1]);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    lock.unlock();
+    char chunk[4096];
+    ssize_t got;
+    while ((got = read(fds[0], chunk, sizeof(chunk))) > 0) {
+        output.append(chunk, got);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,21 @@
+/**
+ * Isolated Runs
+ *
+ * The firmware keeps its state in globals and function statics, and
+ * the simulated host is one per process. Tools that run the firmware
+ * more than once fork a child per run: the child starts from a fresh
+ * copy of the process, does one run and writes its results to a pipe.
+ * Several threads may call runIsolated() at once, one child each.
+ */
+
+#ifndef ISOLATED_H
+#define ISOLATED_H
+
+#include <functional>
+#include <string>
+
+// Run work in a forked child. Whatever it appends to its string comes
+// back in output. False if the child crashed or could not start.
+bool runIsolated(std::function<void(std::string& output)> work, std::string& output);
+
+#endif // ISOLATED_H
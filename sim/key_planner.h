@@ -0,0 +1,237 @@
+/**
+ * Keystroke Planner
+ *
+ * Shortest-time search (A*) for a key sequence over UI models such as
+ * SetupPage and DellBios. A plan is robust: one sequence has to take
+ * every member of a set of models (layouts, BIOS variants) from its
+ * start state to a goal. The search state is therefore the tuple of
+ * member states. After each key it waits for the slowest member:
+ *
+ *   cost of a key = keyGapMs + latency * (100 + marginPct) / 100
+ *
+ * with latency the largest keyLatency() any member reports for that
+ * key. The result is minimal for the model and the action set. A
+ * member in a dead state (wrong partition deleted, wrong password)
+ * drops the whole tuple.
+ *
+ * A model provides:
+ *   typedef ... State;
+ *   State start() const;
+ *   void apply(State& state, const PlanKey& key) const;
+ *   uint32_t latency(const State& before, const State& after) const;
+ *   bool isGoal(const State& state) const;
+ *   bool isDead(const State& state) const;
+ *   uint32_t estimate(const State& state, const PlanCost& cost) const;  // Admissible
+ *   std::string key(const State& state) const;                         // Unique
+ */
+
+#ifndef KEY_PLANNER_H
+#define KEY_PLANNER_H
+
+#include <stdint.h>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct PlanKey {
+    uint8_t usage;              // HID usage
+    uint8_t modifiers;
+};
+
+// One choice for the search: usually a key, or a fixed run of keys
+// ("type the password")
+struct PlanAction {
+    std::string label;
+    std::vector<PlanKey> keys;
+};
+
+struct PlanCost {
+    uint32_t keyGapMs;          // Press to press when nothing is pending
+    uint32_t marginPct;         // Extra wait on top of every latency
+
+    uint32_t waitFor(uint32_t latency) const {
+        return keyGapMs + (latency * (100 + marginPct) + 99) / 100;
+    }
+};
+
+// One key of the plan and when it is sent
+struct PlannedKey {
+    PlanKey key;
+    uint32_t atMs;
+    std::string label;          // Action it belongs to
+};
+
+struct PlanResult {
+    bool found;
+    bool budgetHit;             // Gave up at maxStates
+    size_t expanded;
+    uint32_t totalMs;           // Last key sent + its wait
+    std::vector<PlannedKey> keys;
+};
+
+template <class Model>
+class KeyPlanner {
+public:
+    typedef typename Model::State State;
+    typedef std::vector<State> Belief;
+
+    KeyPlanner(const std::vector<Model>& members, const std::vector<PlanAction>& actions,
+               const PlanCost& cost)
+        : members(members), actions(actions), cost(cost) {
+    }
+
+    PlanResult plan(size_t maxStates) {
+        PlanResult result;
+        result.found = false;
+        result.budgetHit = false;
+        result.expanded = 0;
+        result.totalMs = 0;
+        nodes.clear();
+
+        Node first;
+        first.g = 0;
+        first.parent = -1;
+        first.action = -1;
+        for (size_t m = 0; m < members.size(); m++) first.belief.push_back(members[m].start());
+
+        std::unordered_map<std::string, uint32_t> best;
+        std::priority_queue<Entry> open;
+        nodes.push_back(first);
+        best[beliefKey(first.belief)] = 0;
+        open.push(Entry(estimate(first.belief), 0, 0));
+
+        while (!open.empty()) {
+            Entry entry = open.top();
+            open.pop();
+            const Node current = nodes[entry.node];
+            if (entry.g > current.g) continue;          // Stale: reached cheaper since
+
+            if (isGoal(current.belief)) {
+                result.found = true;
+                result.totalMs = current.g;
+                result.keys = replay(entry.node);
+                return result;
+            }
+            if (++result.expanded > maxStates) {
+                result.budgetHit = true;
+                return result;
+            }
+
+            for (size_t a = 0; a < actions.size(); a++) {
+                Node next;
+                next.belief = current.belief;
+                next.g = current.g;
+                next.parent = entry.node;
+                next.action = a;
+                if (!step(next.belief, actions[a], next.g)) continue;
+
+                std::string key = beliefKey(next.belief);
+                typename std::unordered_map<std::string, uint32_t>::iterator seen = best.find(key);
+                if (seen != best.end() && seen->second <= next.g) continue;
+                best[key] = next.g;
+                nodes.push_back(next);
+                open.push(Entry(next.g + estimate(next.belief), next.g, nodes.size() - 1));
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Node {
+        Belief belief;
+        uint32_t g;
+        int parent;
+        int action;
+    };
+
+    struct Entry {
+        uint32_t f;
+        uint32_t g;
+        size_t node;
+
+        Entry(uint32_t f, uint32_t g, size_t node) : f(f), g(g), node(node) {}
+
+        // Lowest f first; on a tie the deeper node (closer to a goal)
+        bool operator<(const Entry& other) const {
+            return (f != other.f) ? f > other.f : g < other.g;
+        }
+    };
+
+    // Apply an action to every member; false if it leads nowhere useful
+    bool step(Belief& belief, const PlanAction& action, uint32_t& g) const {
+        std::string before = beliefKey(belief);
+        for (size_t k = 0; k < action.keys.size(); k++) {
+            uint32_t slowest = 0;
+            for (size_t m = 0; m < belief.size(); m++) {
+                State previous = belief[m];
+                members[m].apply(belief[m], action.keys[k]);
+                if (members[m].isDead(belief[m])) return false;
+                uint32_t latency = members[m].latency(previous, belief[m]);
+                if (latency > slowest) slowest = latency;
+            }
+            g += cost.waitFor(slowest);
+        }
+        return beliefKey(belief) != before;
+    }
+
+    bool isGoal(const Belief& belief) const {
+        for (size_t m = 0; m < belief.size(); m++) {
+            if (!members[m].isGoal(belief[m])) return false;
+        }
+        return true;
+    }
+
+    uint32_t estimate(const Belief& belief) const {
+        uint32_t most = 0;
+        for (size_t m = 0; m < belief.size(); m++) {
+            uint32_t e = members[m].estimate(belief[m], cost);
+            if (e > most) most = e;
+        }
+        return most;
+    }
+
+    std::string beliefKey(const Belief& belief) const {
+        std::string key;
+        for (size_t m = 0; m < belief.size(); m++) {
+            key += members[m].key(belief[m]);
+            key += '#';
+        }
+        return key;
+    }
+
+    // The keys on the path to a node, timed the way the search costed them
+    std::vector<PlannedKey> replay(size_t node) const {
+        std::vector<int> path;
+        for (int at = (int)node; nodes[at].parent >= 0; at = nodes[at].parent) {
+            path.push_back(nodes[at].action);
+        }
+
+        std::vector<PlannedKey> keys;
+        Belief belief = nodes[0].belief;
+        uint32_t now = 0;
+        for (size_t i = path.size(); i-- > 0;) {
+            const PlanAction& action = actions[path[i]];
+            for (size_t k = 0; k < action.keys.size(); k++) {
+                PlannedKey planned = { action.keys[k], now, action.label };
+                keys.push_back(planned);
+                uint32_t slowest = 0;
+                for (size_t m = 0; m < belief.size(); m++) {
+                    State previous = belief[m];
+                    members[m].apply(belief[m], action.keys[k]);
+                    uint32_t latency = members[m].latency(previous, belief[m]);
+                    if (latency > slowest) slowest = latency;
+                }
+                now += cost.waitFor(slowest);
+            }
+        }
+        return keys;
+    }
+
+    const std::vector<Model>& members;
+    const std::vector<PlanAction>& actions;
+    PlanCost cost;
+    std::vector<Node> nodes;
+};
+
+#endif // KEY_PLANNER_H
@@ -0,0 +1,104 @@
+/**
+ * Run Metrics Implementation
+ */
+
+#include "metrics.h"
+#include "sim_pc.h"
+#include "../src/log_buffer.h"
+#include "../src/telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t countKeyPresses(const std::vector<SimKeyReport>& reports) {
+    uint32_t presses = 0;
+    SimKeyReport last;
+    memset(&last, 0, sizeof(last));
+    for (size_t i = 0; i < reports.size(); i++) {
+        for (int k = 0; k < 6; k++) {
+            if (reports[i].keys[k] && isKeyPress(last, reports[i], reports[i].keys[k])) presses++;
+        }
+        last = reports[i];
+    }
+    return presses;
+}
+
+uint64_t countI2cBytes(const std::vector<SimI2cTransfer>& transfers) {
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < transfers.size(); i++) {
+        bytes += transfers[i].length + 1;
+    }
+    return bytes;
+}
+
+Metrics collectMetrics(const RunResult& result, double wallMs) {
+    Metrics metrics;
+    const std::vector<SimKeyReport>& reports = simKeyReports();
+    const SimQueueStats& queues = simQueueStats();
+
+    metrics.push_back(std::make_pair("finished", result.finished ? 1.0 : 0.0));
+    metrics.push_back(std::make_pair("run_ms", result.finished ? (result.runEnd - result.runStart) / 1000.0 : 0.0));
+    metrics.push_back(std::make_pair("key_reports", (double)reports.size()));
+    metrics.push_back(std::make_pair("key_presses", (double)countKeyPresses(reports)));
+    metrics.push_back(std::make_pair("i2c_transfers", (double)simI2cTransfers().size()));
+    metrics.push_back(std::make_pair("i2c_bytes", (double)countI2cBytes(simI2cTransfers())));
+    metrics.push_back(std::make_pair("lcd_frames", (double)simLcdFrames().size()));
+    metrics.push_back(std::make_pair("waits", (double)simWaits().size()));
+    metrics.push_back(std::make_pair("eeprom_writes", (double)simEepromWrites()));
+    metrics.push_back(std::make_pair("log_peak", (double)getLogPeak()));
+    metrics.push_back(std::make_pair("log_drops", (double)getLogDropCount()));
+    metrics.push_back(std::make_pair("hid_waits", (double)queues.hidWaits));
+    metrics.push_back(std::make_pair("hid_wait_ms", queues.hidWaitUs / 1000.0));
+    metrics.push_back(std::make_pair("cdc_waits", (double)queues.cdcWaits));
+
+    double phaseMs[RUN_PHASE_COUNT] = { 0 };
+    for (size_t i = 0; i < result.phases.size(); i++) {
+        const PhaseSpan& span = result.phases[i];
+        if (span.phase < RUN_PHASE_COUNT) phaseMs[span.phase] += (span.end - span.start) / 1000.0;
+    }
+    for (uint8_t phase = 0; phase < RUN_PHASE_COUNT; phase++) {
+        std::string name = "phase_";
+        name += reinterpret_cast<const char*>(getPhaseName(phase));
+        metrics.push_back(std::make_pair(name + "_ms", phaseMs[phase]));
+    }
+
+    metrics.push_back(std::make_pair("sim_wall_ms", wallMs));
+    return metrics;
+}
+
+double findMetric(const Metrics& metrics, const std::string& name, double fallback) {
+    for (size_t i = 0; i < metrics.size(); i++) {
+        if (metrics[i].first == name) return metrics[i].second;
+    }
+    return fallback;
+}
+
+std::string serializeMetrics(const Metrics& metrics) {
+    std::string text;
+    char value[32];
+    for (size_t i = 0; i < metrics.size(); i++) {
+        snprintf(value, sizeof(value), " %.17g\n", metrics[i].second);
+        text += metrics[i].first + value;
+    }
+    return text;
+}
+
+Metrics parseMetrics(const std::string& text) {
+    Metrics metrics;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        size_t space = line.find(' ');
+        if (space != std::string::npos) {
+            metrics.push_back(std::make_pair(line.substr(0, space), atof(line.c_str() + space + 1)));
+        }
+        start = end + 1;
+    }
+    return metrics;
+}
+
+bool isNoisyMetric(const std::string& name) {
+    return name == "sim_wall_ms";
+}
@@ -0,0 +1,38 @@
+/**
+ * Run Metrics
+ *
+ * The numbers one simulated run is judged by, taken from the SimHost
+ * records and the firmware's own counters. Kept as an ordered list of
+ * named values so they travel through a pipe, JSON and a table alike.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "scenario.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<std::string, double> > Metrics;
+
+// Keys pressed (a key going down, not reports)
+uint32_t countKeyPresses(const std::vector<SimKeyReport>& reports);
+
+// I2C bytes on the bus, address bytes included
+uint64_t countI2cBytes(const std::vector<SimI2cTransfer>& transfers);
+
+// Everything about the run that just finished in this process
+Metrics collectMetrics(const RunResult& result, double wallMs);
+
+// Value by name (fallback if it is missing)
+double findMetric(const Metrics& metrics, const std::string& name, double fallback = 0);
+
+// "name value" lines and back
+std::string serializeMetrics(const Metrics& metrics);
+Metrics parseMetrics(const std::string& text);
+
+// Metrics that vary between identical runs (host timing)
+bool isNoisyMetric(const std::string& name);
+
+#endif // METRICS_H
@@ -0,0 +1,628 @@
+/**
+ * Keystroke Plans Implementation
+ */
+
+#include "plan_keys.h"
+#include "dell_bios.h"
+#include "hid_names.h"
+#include "isolated.h"
+#include "key_planner.h"
+#include "scenario.h"
+#include "setup_page.h"
+#include "wipe_score.h"
+#include "../include/config.h"
+#include "../src/key_script.h"
+#include "../src/settings.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define USAGE_A             0x04
+#define USAGE_Z             0x1D
+#define USAGE_1             0x1E
+#define USAGE_0             0x27
+#define USAGE_ENTER         0x28
+#define USAGE_ESC           0x29
+#define USAGE_TAB           0x2B
+#define USAGE_SPACE         0x2C
+#define USAGE_F2            0x3B
+#define USAGE_HOME          0x4A
+#define USAGE_END           0x4D
+#define USAGE_RIGHT         0x4F
+#define USAGE_LEFT          0x50
+#define USAGE_DOWN          0x51
+#define USAGE_UP            0x52
+#define MOD_LEFT_SHIFT      0x02
+
+#define PLAN_KEY_GAP_MS     100         // Press to press with nothing pending
+#define PLAN_MARGIN_PCT     25
+#define PLAN_MAX_STATES     200000
+#define PLAN_F2_EVERY_MS    200         // Script's F2 spam
+#define PLAN_RUN_LIMIT_MS   (5UL * 60 * 1000)
+
+// key_script.h step gaps
+#define GAP_UNIT_MS         10
+#define GAP_MAX_UNITS       0x7FFF
+
+struct PlanOptions {
+    bool bios;
+    std::vector<std::string> names;     // Layouts or models ({} = the reference one)
+    PlanCost cost;
+    size_t maxStates;
+    const char* scriptPath;
+    const char* eepromPath;
+    bool robust;                        // Setup: one plan for all layouts
+    bool show;
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator plan --ui setup|bios [--layout NAME|all]... [--model NAME|all]\n"
+        "                      [--key-gap MS] [--margin PCT] [--max-states N]\n"
+        "                      [--robust] [--script FILE] [--eeprom FILE] [--show]\n");
+}
+
+// 0 = ok, 2 = bad arguments
+static int parseOptions(int argc, char** argv, PlanOptions& options) {
+    options.bios = false;
+    options.cost.keyGapMs = PLAN_KEY_GAP_MS;
+    options.cost.marginPct = PLAN_MARGIN_PCT;
+    options.maxStates = PLAN_MAX_STATES;
+    options.scriptPath = NULL;
+    options.eepromPath = NULL;
+    options.robust = false;
+    options.show = false;
+
+    bool ui = false;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--show") == 0) {
+            options.show = true;
+            continue;
+        }
+        if (strcmp(arg, "--robust") == 0) {
+            options.robust = true;
+            continue;
+        }
+        const char* value = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return 2;
+        }
+        if (strcmp(arg, "--ui") == 0) {
+            if (strcmp(value, "setup") != 0 && strcmp(value, "bios") != 0) {
+                fprintf(stderr, "ui must be setup or bios: %s\n", value);
+                return 2;
+            }
+            options.bios = (strcmp(value, "bios") == 0);
+            ui = true;
+        } else if (strcmp(arg, "--layout") == 0 || strcmp(arg, "--model") == 0) {
+            options.names.push_back(value);
+        } else if (strcmp(arg, "--key-gap") == 0) {
+            options.cost.keyGapMs = strtoul(value, NULL, 10);
+            if (options.cost.keyGapMs <= KEY_HOLD_DELAY) {
+                fprintf(stderr, "key gap must be longer than the key hold (%d ms)\n", KEY_HOLD_DELAY);
+                return 2;
+            }
+        } else if (strcmp(arg, "--margin") == 0) {
+            options.cost.marginPct = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--max-states") == 0) {
+            options.maxStates = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--script") == 0) {
+            options.scriptPath = value;
+        } else if (strcmp(arg, "--eeprom") == 0) {
+            options.eepromPath = value;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return 2;
+        }
+    }
+    if (!ui) {
+        fprintf(stderr, "--ui setup|bios is required\n");
+        return 2;
+    }
+    if (options.robust && options.bios) {
+        fprintf(stderr, "--robust is for --ui setup (the BIOS trees differ per model)\n");
+        return 2;
+    }
+    return 0;
+}
+
+// ===========================================
+// Models for the planner
+// ===========================================
+
+struct SetupPlanModel {
+    typedef SetupState State;
+
+    const SetupLayout* layout;
+    SetupTiming timing;
+
+    State start() const {
+        return SetupPage(*layout, timing).state();
+    }
+    void apply(State& state, const PlanKey& key) const {
+        SetupPage::applyKey(state, key.usage, key.modifiers);
+    }
+    uint32_t latency(const State& before, const State& after) const {
+        return SetupPage::keyLatency(before, after, timing);
+    }
+    bool isGoal(const State& state) const {
+        return judgeSetup(state).correct;
+    }
+    // Nothing the firmware should ever do: a wrong install, another
+    // drive touched, partitions made or formatted, a refresh
+    bool isDead(const State& state) const {
+        if (state.end != END_NONE) return !judgeSetup(state).correct;
+        for (int d = 1; d < 4; d++) {
+            if (state.deleted[d] || state.formatted[d]) return true;
+        }
+        return state.formatted[0] || state.created || state.strayActions;
+    }
+    // Every partition left on drive 0 takes at least a key out of the
+    // list, Enter on Delete, a key onto OK (dialogs open on Cancel) and
+    // Enter on OK. Then Next.
+    uint32_t estimate(const State& state, const PlanCost& cost) const {
+        uint32_t left = 0;
+        for (size_t i = 0; i < state.rows.size(); i++) {
+            if (state.rows[i].disk == 0 && state.rows[i].kind != ROW_FREE) left++;
+        }
+        if (state.end != END_NONE) return 0;
+        return left * (2 * cost.keyGapMs + cost.waitFor(timing.dialogMs) + cost.waitFor(timing.deleteMs)) +
+               cost.keyGapMs;
+    }
+    std::string key(const State& state) const {
+        return state.key();
+    }
+};
+
+struct BiosPlanModel {
+    typedef BiosState State;
+
+    const BiosModel* model;
+
+    State start() const {
+        return DellBios::startState();
+    }
+    void apply(State& state, const PlanKey& key) const {
+        DellBios::applyKey(*model, state, key.usage, key.modifiers);
+    }
+    uint32_t latency(const State& before, const State& after) const {
+        return DellBios::keyLatency(*model, before, after);
+    }
+    bool isGoal(const State& state) const {
+        return state.screen == BIOS_SAVED && state.cleared;
+    }
+    // A wrong password counts towards the lockout, a new one is worse
+    // than none, and other groups or settings are not ours to touch
+    bool isDead(const State& state) const {
+        return state.failures || state.changed || state.strayActions ||
+               state.screen == BIOS_EXITED || state.screen == BIOS_LOCKED ||
+               (state.screen == BIOS_SAVED && !state.cleared);
+    }
+    uint32_t estimate(const State&, const PlanCost&) const {
+        return 0;
+    }
+    std::string key(const State& state) const {
+        return state.key();
+    }
+};
+
+static PlanAction single(const char* label, uint8_t usage, uint8_t modifiers = 0) {
+    PlanAction action;
+    action.label = label;
+    PlanKey key = { usage, modifiers };
+    action.keys.push_back(key);
+    return action;
+}
+
+static std::vector<PlanAction> setupActions() {
+    std::vector<PlanAction> actions;
+    actions.push_back(single("Tab", USAGE_TAB));
+    actions.push_back(single("Shift+Tab", USAGE_TAB, MOD_LEFT_SHIFT));
+    actions.push_back(single("Enter", USAGE_ENTER));
+    actions.push_back(single("Esc", USAGE_ESC));
+    actions.push_back(single("Up", USAGE_UP));
+    actions.push_back(single("Down", USAGE_DOWN));
+    actions.push_back(single("Left", USAGE_LEFT));
+    actions.push_back(single("Right", USAGE_RIGHT));
+    actions.push_back(single("Home", USAGE_HOME));
+    actions.push_back(single("End", USAGE_END));
+    return actions;
+}
+
+static uint8_t charUsage(char c) {
+    if (c >= 'a' && c <= 'z') return USAGE_A + (c - 'a');
+    if (c >= '1' && c <= '9') return USAGE_1 + (c - '1');
+    if (c == '0') return USAGE_0;
+    return 0;
+}
+
+// Single keys, and the password typed in one go (one letter at a time
+// would be a search over strings)
+static std::vector<PlanAction> biosActions(const BiosModel& model) {
+    std::vector<PlanAction> actions;
+    actions.push_back(single("Up", USAGE_UP));
+    actions.push_back(single("Down", USAGE_DOWN));
+    actions.push_back(single("Enter", USAGE_ENTER));
+    actions.push_back(single("Tab", USAGE_TAB));
+    actions.push_back(single("Shift+Tab", USAGE_TAB, MOD_LEFT_SHIFT));
+    actions.push_back(single("Esc", USAGE_ESC));
+    actions.push_back(single("Left", USAGE_LEFT));
+    actions.push_back(single("Right", USAGE_RIGHT));
+
+    PlanAction type;
+    type.label = "type password";
+    for (const char* c = model.password; *c; c++) {
+        PlanKey key = { charUsage(*c), 0 };
+        type.keys.push_back(key);
+    }
+    actions.push_back(type);
+    return actions;
+}
+
+// ===========================================
+// Key scripts
+// ===========================================
+
+// Arduino Keyboard code for a usage: ASCII for what is typed, usage +
+// 136 for the rest (KEY_RETURN, KEY_TAB, arrows, F keys)
+static uint8_t arduinoKey(uint8_t usage) {
+    if (usage >= USAGE_A && usage <= USAGE_Z) return 'a' + (usage - USAGE_A);
+    if (usage >= USAGE_1 && usage < USAGE_0) return '1' + (usage - USAGE_1);
+    if (usage == USAGE_0) return '0';
+    if (usage == USAGE_SPACE) return ' ';
+    return usage + 136;
+}
+
+// Steps for a timeline. replayKeyScript() waits the gap, presses, holds
+// and releases, so a gap is what is left of the time between two
+// presses after the hold - rounded up, which only ever makes a key later.
+// replayed gets the times the script really presses at.
+static bool encodeScript(const KeySequence& keys, std::vector<uint8_t>& steps, KeySequence& replayed) {
+    steps.clear();
+    replayed.clear();
+    uint32_t freeAt = 0;                        // Previous key released
+    for (size_t i = 0; i < keys.size(); i++) {
+        const TimedKey& key = keys[i];
+        uint32_t wait = (key.atMs > freeAt) ? key.atMs - freeAt : 0;
+        uint32_t units = (wait + GAP_UNIT_MS - 1) / GAP_UNIT_MS;
+        if (units > GAP_MAX_UNITS) return false;
+        if (units < 0x80) {
+            steps.push_back(units);
+        } else {
+            steps.push_back(0x80 | (units >> 8));
+            steps.push_back(units & 0xFF);
+        }
+
+        if (key.modifiers) {
+            uint8_t bit = 0;
+            while (!(key.modifiers & (1 << bit))) bit++;
+            if (key.modifiers != (1 << bit)) return false;     // One modifier per step
+            steps.push_back(0x80 + bit);
+        }
+        steps.push_back(arduinoKey(key.usage));
+
+        TimedKey sent = key;
+        sent.atMs = freeAt + units * GAP_UNIT_MS;
+        replayed.push_back(sent);
+        freeAt = sent.atMs + KEY_HOLD_DELAY;
+    }
+    return steps.size() <= KEY_SCRIPT_MAX_STEPS;
+}
+
+static KeySequence planTimeline(const PlanResult& plan, uint32_t offsetMs) {
+    KeySequence keys;
+    for (size_t i = 0; i < plan.keys.size(); i++) {
+        TimedKey key = { plan.keys[i].key.usage, plan.keys[i].key.modifiers,
+                         offsetMs + plan.keys[i].atMs };
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+// The script area as FRAME_SCRIPT_WRITE takes it, and/or a whole image
+static bool writeScript(const std::vector<uint8_t>& steps, const PlanOptions& options) {
+    storeKeyScript(steps.data(), steps.size());
+    if (options.scriptPath) {
+        FILE* file = fopen(options.scriptPath, "wb");
+        size_t size = KEY_SCRIPT_HEADER_SIZE + steps.size();
+        if (!file || fwrite(simEeprom() + EEPROM_SCRIPT_ADDR, 1, size, file) != size) {
+            fprintf(stderr, "cannot write %s\n", options.scriptPath);
+            if (file) fclose(file);
+            return false;
+        }
+        fclose(file);
+        printf("Script area (%u bytes) written to %s\n", (unsigned)size, options.scriptPath);
+    }
+    if (options.eepromPath) {
+        if (!simSaveEeprom(options.eepromPath)) {
+            fprintf(stderr, "cannot write %s\n", options.eepromPath);
+            return false;
+        }
+        printf("EEPROM image written to %s (run it as payload script)\n", options.eepromPath);
+    }
+    return true;
+}
+
+static std::string keyText(uint8_t usage, uint8_t modifiers) {
+    return (modifiers & MOD_LEFT_SHIFT) ? "Shift+" + usageName(usage) : usageName(usage);
+}
+
+static void printPlan(const PlanResult& plan) {
+    printf("%10s  %-12s %s\n", "at s", "key", "action");
+    for (size_t i = 0; i < plan.keys.size(); i++) {
+        const PlannedKey& key = plan.keys[i];
+        printf("%10.3f  %-12s %s\n", key.atMs / 1000.0,
+               keyText(key.key.usage, key.key.modifiers).c_str(), key.label.c_str());
+    }
+}
+
+static void printSearch(const PlanResult& plan) {
+    if (plan.found) {
+        printf("%u keys, last key at %.3f s (%u states searched)\n", (unsigned)plan.keys.size(),
+               plan.keys.empty() ? 0.0 : plan.keys.back().atMs / 1000.0, (unsigned)plan.expanded);
+    } else if (plan.budgetHit) {
+        printf("no plan within %u states (--max-states)\n", (unsigned)plan.expanded - 1);
+    } else {
+        printf("no sequence reaches the goal\n");
+    }
+}
+
+// ===========================================
+// Setup page
+// ===========================================
+
+static int planSetup(const PlanOptions& options) {
+    std::vector<SetupPlanModel> members;
+    std::vector<std::string> names = options.names;
+    if (names.empty()) names.push_back("dell-oem");
+    for (size_t i = 0; i < names.size(); i++) {
+        const std::vector<SetupLayout>& layouts = setupLayouts();
+        for (size_t l = 0; l < layouts.size(); l++) {
+            if (names[i] != "all" && names[i] != layouts[l].name) continue;
+            SetupPlanModel member = { &layouts[l], SetupTiming() };
+            members.push_back(member);
+        }
+        if (names[i] != "all" && !findSetupLayout(names[i])) {
+            fprintf(stderr, "unknown layout: %s (see setup-page --list)\n", names[i].c_str());
+            return 2;
+        }
+    }
+
+    // One plan per layout, or one for all of them
+    std::vector<std::vector<SetupPlanModel> > groups;
+    if (options.robust) {
+        groups.push_back(members);
+    } else {
+        for (size_t m = 0; m < members.size(); m++) {
+            groups.push_back(std::vector<SetupPlanModel>(1, members[m]));
+        }
+    }
+    if ((options.scriptPath || options.eepromPath) && groups.size() != 1) {
+        fprintf(stderr, "--script/--eeprom need one plan (one layout or --robust)\n");
+        return 2;
+    }
+
+    // The script's real key times go through the timed page, then the
+    // firmware's sequence (tuned) through the same page
+    KeySequence firmware;
+    bool recorded = recordFirmwareKeys(PROFILE_TUNED, firmware);
+    printf("Setup disk page plans: key gap %u ms, margin %u %%%s\n", options.cost.keyGapMs,
+           options.cost.marginPct, options.robust ? ", one sequence for every layout" : "");
+    printf("Times from the first key on the page\n\n");
+    printf("%-12s %5s %8s  %-6s %8s  %-6s %5s %8s  %s\n", "layout", "plan", "Next s",
+           "script", "Next s", "firmw.", "keys", "Next s", "firmware verdict");
+
+    int failed = 0;
+    std::vector<uint8_t> steps;
+    std::vector<PlanResult> plans;
+    std::vector<PlanAction> actions = setupActions();
+    for (size_t g = 0; g < groups.size(); g++) {
+        KeyPlanner<SetupPlanModel> planner(groups[g], actions, options.cost);
+        PlanResult plan = planner.plan(options.maxStates);
+        plans.push_back(plan);
+        if (!plan.found) {
+            failed++;
+            printf("%-12s ", options.robust ? "(all)" : groups[g][0].layout->name);
+            printSearch(plan);
+            continue;
+        }
+
+        KeySequence replayed;
+        bool fits = encodeScript(planTimeline(plan, 0), steps, replayed);
+        for (size_t m = 0; m < groups[g].size(); m++) {
+            const SetupPlanModel& member = groups[g][m];
+            WipeScore mine = scoreSequence(*member.layout, member.timing, replayed);
+            bool ok = fits && mine.outcome.correct && !mine.dropped;
+            if (!ok) failed++;
+            printf("%-12s %5u %8.1f  %-6s %8.1f", member.layout->name, (unsigned)plan.keys.size(),
+                   plan.keys.back().atMs / 1000.0, ok ? "ok" : "FAIL", mine.doneMs / 1000.0);
+            if (recorded) {
+                WipeScore theirs = scoreSequence(*member.layout, member.timing, firmware);
+                printf("  %-6s %5u %8.1f  %s\n", theirs.outcome.correct ? "ok" : "FAIL", theirs.keys,
+                       theirs.doneMs / 1000.0, theirs.outcome.verdict.c_str());
+            } else {
+                printf("  %-6s\n", "n/a");
+            }
+            if (!fits) {
+                printf("             script: does not fit the %d-byte script area\n", KEY_SCRIPT_MAX_STEPS);
+            } else if (!ok) {
+                printf("             script: %s\n", mine.outcome.verdict.c_str());
+            }
+        }
+    }
+
+    if (options.show || groups.size() == 1) {
+        for (size_t g = 0; g < groups.size(); g++) {
+            if (!plans[g].found) continue;
+            printf("\n%s:\n", options.robust ? "Every layout" : groups[g][0].layout->name);
+            printPlan(plans[g]);
+        }
+    }
+    if (failed) return 1;
+    if (options.scriptPath || options.eepromPath) {
+        printf("\n");
+        return writeScript(steps, options) ? 0 : 1;
+    }
+    return 0;
+}
+
+// ===========================================
+// BIOS
+// ===========================================
+
+struct BiosReplay {
+    bool ok;
+    uint32_t keys;              // Keys that reached Setup
+    uint32_t lost;
+    uint32_t toSaveMs;          // Setup taking keys -> the saving key
+    std::string verdict;
+};
+
+// One firmware run against the model in a child: the BIOS payload from
+// the learned position (script empty), or the planned script
+static BiosReplay replayBios(const BiosModel& model, const std::vector<uint8_t>& script) {
+    std::string text;
+    bool ran = runIsolated([&model, &script](std::string& out) {
+        saveBootPosition(PAYLOAD_BIOS, model.learnedDowns);
+
+        Scenario scenario;
+        scenario.payload = script.empty() ? PAYLOAD_BIOS : PAYLOAD_SCRIPT;
+        scenario.script = script;
+        scenario.limitMs = PLAN_RUN_LIMIT_MS;
+        DellBiosPc pc(model);
+        simSetPc(&pc);
+        RunResult result = runScenario(scenario);
+
+        const DellBios& bios = pc.bios();
+        BiosOutcome outcome = bios.outcome();
+        uint32_t toSave = (bios.endedAt() && bios.readyAt()) ? bios.endedAt() - bios.readyAt() : 0;
+        char line[64];
+        snprintf(line, sizeof(line), "%d %u %u %u ", outcome.correct && result.finished,
+                 bios.setupKeys(), bios.lostKeys(), toSave);
+        out = line + outcome.verdict;
+    }, text);
+
+    BiosReplay replay;
+    replay.ok = false;
+    replay.keys = replay.lost = replay.toSaveMs = 0;
+    if (!ran) {
+        replay.verdict = "run crashed";
+        return replay;
+    }
+    int ok = 0;
+    int used = 0;
+    sscanf(text.c_str(), "%d %u %u %u %n", &ok, &replay.keys, &replay.lost, &replay.toSaveMs, &used);
+    replay.ok = (ok != 0);
+    replay.verdict = text.substr(used);
+    return replay;
+}
+
+// F2 through the window from the first key on (POST starts with it),
+// then nothing until Setup takes keys, with margin
+static KeySequence biosPreamble(const BiosModel& model, const PlanCost& cost, uint32_t* setupAtMs) {
+    KeySequence keys;
+    for (uint32_t at = 0; at + PLAN_F2_EVERY_MS < model.timing.postMs; at += PLAN_F2_EVERY_MS) {
+        TimedKey key = { USAGE_F2, 0, at };
+        keys.push_back(key);
+    }
+    *setupAtMs = cost.waitFor(model.timing.postMs + model.timing.setupLoadMs);
+    return keys;
+}
+
+static int planBios(const PlanOptions& options) {
+    std::vector<const BiosModel*> models;
+    std::vector<std::string> names = options.names;
+    if (names.empty()) names.push_back("latitude-5490");
+    for (size_t i = 0; i < names.size(); i++) {
+        const std::vector<BiosModel>& all = biosModels();
+        for (size_t m = 0; m < all.size(); m++) {
+            if (names[i] == "all" || names[i] == all[m].name) models.push_back(&all[m]);
+        }
+        if (names[i] != "all" && !findBiosModel(names[i])) {
+            fprintf(stderr, "unknown model: %s (see bios --list)\n", names[i].c_str());
+            return 2;
+        }
+    }
+    if ((options.scriptPath || options.eepromPath) && models.size() != 1) {
+        fprintf(stderr, "--script/--eeprom need one model\n");
+        return 2;
+    }
+
+    printf("BIOS plans: key gap %u ms, margin %u %%\n", options.cost.keyGapMs, options.cost.marginPct);
+    printf("Plan times from its first key in Setup, script and firmware from Setup taking keys\n\n");
+    printf("%-15s %5s %9s  %-6s %5s %9s  %-6s %5s %9s  %s\n", "model", "plan", "save s",
+           "script", "keys", "save s", "firmw.", "keys", "save s", "firmware verdict");
+
+    int failed = 0;
+    std::vector<uint8_t> lastSteps;
+    std::vector<PlanResult> plans;
+    for (size_t m = 0; m < models.size(); m++) {
+        const BiosModel& model = *models[m];
+        std::vector<BiosPlanModel> members(1);
+        members[0].model = &model;
+        std::vector<PlanAction> actions = biosActions(model);
+        KeyPlanner<BiosPlanModel> planner(members, actions, options.cost);
+        PlanResult plan = planner.plan(options.maxStates);
+        plans.push_back(plan);
+        if (!plan.found) {
+            failed++;
+            printf("%-15s ", model.name);
+            printSearch(plan);
+            continue;
+        }
+
+        uint32_t setupAt = 0;
+        KeySequence keys = biosPreamble(model, options.cost, &setupAt);
+        KeySequence planned = planTimeline(plan, setupAt);
+        keys.insert(keys.end(), planned.begin(), planned.end());
+        KeySequence replayed;
+        bool fits = encodeScript(keys, lastSteps, replayed);
+
+        BiosReplay mine;
+        if (fits) {
+            mine = replayBios(model, lastSteps);
+        } else {
+            mine.ok = false;
+            mine.keys = mine.lost = mine.toSaveMs = 0;
+            mine.verdict = "does not fit the script area";
+        }
+        BiosReplay theirs = replayBios(model, std::vector<uint8_t>());
+        if (!mine.ok) failed++;
+
+        printf("%-15s %5u %9.1f  %-6s %5u %9.1f  %-6s %5u %9.1f  %s\n", model.name,
+               (unsigned)plan.keys.size(), plan.keys.back().atMs / 1000.0,
+               mine.ok ? "ok" : "FAIL", mine.keys, mine.toSaveMs / 1000.0,
+               theirs.ok ? "ok" : "FAIL", theirs.keys, theirs.toSaveMs / 1000.0,
+               theirs.verdict.c_str());
+        if (!mine.ok) printf("                script: %s\n", mine.verdict.c_str());
+    }
+
+    if (options.show || models.size() == 1) {
+        for (size_t m = 0; m < models.size(); m++) {
+            if (!plans[m].found) continue;
+            printf("\n%s:\n", models[m]->name);
+            printPlan(plans[m]);
+        }
+    }
+    if (failed) return 1;
+    if (options.scriptPath || options.eepromPath) {
+        printf("\n");
+        return writeScript(lastSteps, options) ? 0 : 1;
+    }
+    return 0;
+}
+
+// ===========================================
+// plan
+// ===========================================
+
+int commandPlan(int argc, char** argv) {
+    PlanOptions options;
+    if (parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+    return options.bios ? planBios(options) : planSetup(options);
+}
@@ -0,0 +1,32 @@
+/**
+ * Keystroke Plans
+ *
+ * Searches the UI models for the fastest key sequence that gets the job
+ * done (key_planner.h), checks it on the timed models and compares it
+ * with what the firmware types:
+ *
+ *   simulator plan --ui setup|bios [--layout NAME|all]... [--model NAME|all]
+ *                  [--key-gap MS] [--margin PCT] [--max-states N]
+ *                  [--script FILE] [--eeprom FILE] [--show]
+ *
+ * --ui setup plans the disk page from the moment it shows to Next on an
+ * empty disk 0. With several layouts (--layout all, or --layout more
+ * than once) it is one sequence that works on every one of them.
+ *
+ * --ui bios plans from Setup taking keys to the cleared password being
+ * saved, one plan per model (Security sits on a different row on each,
+ * as the station's learned DOWNs do for the firmware). The script puts
+ * the F2 spam and the wait for Setup in front of it.
+ *
+ * Each key waits --key-gap plus what the model says the key starts,
+ * plus --margin percent. --script writes the plan as a key script area
+ * (header and steps, what FRAME_SCRIPT_WRITE takes), --eeprom as an
+ * EEPROM image to run as the script payload.
+ */
+
+#ifndef PLAN_KEYS_H
+#define PLAN_KEYS_H
+
+int commandPlan(int argc, char** argv);
+
+#endif // PLAN_KEYS_H
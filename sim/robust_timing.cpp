@@ -0,0 +1,490 @@
+/**
+ * Robust Win10 Timing Search Implementation
+ */
+
+#include "robust_timing.h"
+#include "isolated.h"
+#include "scenario.h"
+#include "sim_pc.h"
+#include "slow_host.h"
+#include "../include/config.h"
+#include "../src/timing_config.h"
+#include "../src/wait_tuning.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <thread>
+
+#define ROBUST_RUNS         200
+#define ROBUST_TARGET_PCT   99.0
+#define ROBUST_STEP_MS      10          // Search resolution
+#define ROBUST_RAISE_PCT    25          // Defaults fail: one delay up by this per round
+#define ROBUST_MAX_RAISES   16
+#define ROBUST_PASSES       2           // Lowering passes over all delays
+#define ROBUST_PROBE_PCT    25          // Sensitivity: the delay this much shorter
+#define ROBUST_USE_STEP_MS  100         // Uses per run: run time change for this much more
+#define ROBUST_RUN_LIMIT_MS (10UL * 60 * 1000)
+
+// Default of a learned wait (first of value, floor, ceiling)
+#define FIRST_OF(...)                   FIRST_OF_(__VA_ARGS__)
+#define FIRST_OF_(value, floor, ceiling)    value
+
+struct RobustOptions {
+    unsigned runs;
+    double targetPct;
+    unsigned threads;
+    HostLatency latency;
+    const char* profilePath;
+    const char* eepromPath;
+};
+
+// A delay executeWindows10Install waits after a key
+struct RobustKnob {
+    const char* name;
+    bool learnedWait;           // WaitStep, else a TimingConfig field
+    uint8_t step;
+    uint16_t defaultMs;
+};
+
+static const RobustKnob knobs[] = {
+    { "key_delay",      false, 0, KEY_DELAY },
+    { "nav_gap",        false, 0, NAV_KEY_GAP },
+    { "setup_tab",      false, 0, SETUP_TAB_GAP },
+    { "list_step",      false, 0, LIST_STEP_GAP },
+    { "list_fast",      false, 0, LIST_FAST_GAP },
+    { "list_settle",    false, 0, LIST_SETTLE },
+    { "header_gap",     false, 0, HEADER_SKIP_GAP },
+    { "delete_gap",     false, 0, DELETE_KEY_GAP },
+    { "next_tab",       false, 0, NEXT_TAB_GAP },
+    { "final_enter",    false, 0, FINAL_ENTER_WAIT },
+    { "delete_click",   true,  WAIT_DELETE_CLICK,   FIRST_OF(TUNE_DELETE_CLICK) },
+    { "delete_confirm", true,  WAIT_DELETE_CONFIRM, FIRST_OF(TUNE_DELETE_CONFIRM) },
+    { "install_start",  true,  WAIT_INSTALL_START,  FIRST_OF(TUNE_INSTALL_START) }
+};
+
+#define KNOB_COUNT  (sizeof(knobs) / sizeof(knobs[0]))
+
+struct Profile {
+    long value[KNOB_COUNT];
+
+    Profile() {
+        for (size_t i = 0; i < KNOB_COUNT; i++) value[i] = knobs[i].defaultMs;
+    }
+};
+
+struct RunOutcome {
+    bool ok;
+    double runMs;
+    long applied[KNOB_COUNT];   // What the firmware stored (clamped)
+    std::string firstDrop;
+};
+
+struct Evaluation {
+    bool passed;
+    unsigned runs;              // Done (fewer if it failed early)
+    unsigned failed;
+    double meanRunMs;
+    long applied[KNOB_COUNT];
+    std::map<std::string, unsigned> drops;  // First dropped key per failed run
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator robust [--runs N] [--target PCT] [--threads N]\n"
+        "                        [--key-ms MS] [--enter-ms MS] [--sigma X]\n"
+        "                        [--stall-pct PCT] [--stall-ms MS]\n"
+        "                        [--profile-out FILE] [--eeprom FILE]\n");
+}
+
+static bool parseOptions(int argc, char** argv, RobustOptions& options) {
+    options.runs = ROBUST_RUNS;
+    options.targetPct = ROBUST_TARGET_PCT;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    options.profilePath = NULL;
+    options.eepromPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return false;
+        }
+        if (strcmp(arg, "--runs") == 0) {
+            options.runs = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--target") == 0) {
+            options.targetPct = atof(value);
+        } else if (strcmp(arg, "--threads") == 0) {
+            options.threads = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--key-ms") == 0) {
+            options.latency.keyMs = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--enter-ms") == 0) {
+            options.latency.enterMs = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--sigma") == 0) {
+            options.latency.sigma = atof(value);
+        } else if (strcmp(arg, "--stall-pct") == 0) {
+            options.latency.stallPct = atof(value);
+        } else if (strcmp(arg, "--stall-ms") == 0) {
+            options.latency.stallMs = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--profile-out") == 0) {
+            options.profilePath = value;
+        } else if (strcmp(arg, "--eeprom") == 0) {
+            options.eepromPath = value;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        }
+    }
+    if (!options.runs || !options.threads || options.targetPct <= 0 || options.targetPct > 100 ||
+        !options.latency.keyMs || !options.latency.enterMs) {
+        fprintf(stderr, "runs, threads and latencies must be > 0, target in (0, 100]\n");
+        return false;
+    }
+    return true;
+}
+
+// ===========================================
+// Runs
+// ===========================================
+
+// The profile written the way the console and Config set frames would
+static void presetProfile(const Profile& profile, long applied[KNOB_COUNT]) {
+    loadTimingConfig();
+    initWaitTuning();
+    for (size_t i = 0; i < KNOB_COUNT; i++) {
+        if (knobs[i].learnedWait) {
+            applied[i] = setLearnedWait(knobs[i].step, profile.value[i]);
+        } else {
+            applied[i] = setTimingValue(findTimingField(knobs[i].name), profile.value[i]);
+        }
+    }
+}
+
+// One win10 run: against a slow host seeded with seed, or with
+// jitter = false against BasicPc (the run time of the pacing alone)
+static RunOutcome runOnce(const Profile& profile, const HostLatency& latency, uint32_t seed,
+                          bool jitter) {
+    std::string text;
+    bool ran = runIsolated([&profile, &latency, seed, jitter](std::string& out) {
+        long applied[KNOB_COUNT];
+        presetProfile(profile, applied);
+
+        Scenario scenario;
+        scenario.payload = PAYLOAD_WIN10;
+        scenario.profile = PROFILE_TUNED;
+        scenario.limitMs = ROBUST_RUN_LIMIT_MS;
+        SlowHostPc slow(latency, seed);
+        BasicPc basic;
+        simSetPc(jitter ? static_cast<SimPc*>(&slow) : &basic);
+        RunResult result = runScenario(scenario);
+
+        bool ok = result.finished && !slow.droppedKeys();
+        char line[48];
+        snprintf(line, sizeof(line), "%d %.1f", ok, (result.runEnd - result.runStart) / 1000.0);
+        out = line;
+        for (size_t i = 0; i < KNOB_COUNT; i++) out += " " + std::to_string(applied[i]);
+        out += " " + (result.finished ? slow.firstDrop() : std::string("run did not finish"));
+    }, text);
+
+    RunOutcome run;
+    run.ok = false;
+    run.runMs = 0;
+    for (size_t i = 0; i < KNOB_COUNT; i++) run.applied[i] = -1;
+    if (!ran) {
+        run.firstDrop = "run crashed";
+        return run;
+    }
+    int ok = 0;
+    int used = 0;
+    sscanf(text.c_str(), "%d %lf%n", &ok, &run.runMs, &used);
+    const char* at = text.c_str() + used;
+    for (size_t i = 0; i < KNOB_COUNT; i++) {
+        char* end;
+        run.applied[i] = strtol(at, &end, 10);
+        at = end;
+    }
+    run.ok = (ok != 0);
+    run.firstDrop = (*at == ' ') ? at + 1 : at;
+    return run;
+}
+
+// Jobs 0..count-1 on a pool of threads, each job forking its own child.
+// A job returning false stops the pool handing out more.
+static void runParallel(size_t count, unsigned threads, std::function<bool(size_t)> job) {
+    std::atomic<size_t> next(0);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads && t < count; t++) {
+        workers.push_back(std::thread([&]() {
+            while (!stop) {
+                size_t index = next++;
+                if (index >= count) break;
+                if (!job(index)) stop = true;
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+}
+
+// Runs the profile on options.runs hosts; gives up as soon as more runs
+// failed than the target allows
+static Evaluation evaluate(const Profile& profile, const RobustOptions& options) {
+    unsigned allowed = (unsigned)floor(options.runs * (100.0 - options.targetPct) / 100.0 + 1e-9);
+    std::vector<RunOutcome> runs(options.runs);
+    std::vector<char> done(options.runs, 0);
+    std::atomic<unsigned> failed(0);
+
+    runParallel(options.runs, options.threads, [&](size_t index) {
+        runs[index] = runOnce(profile, options.latency, index + 1, true);
+        done[index] = 1;
+        if (!runs[index].ok) failed++;
+        return failed <= allowed;
+    });
+
+    Evaluation evaluation;
+    evaluation.runs = 0;
+    evaluation.failed = 0;
+    evaluation.meanRunMs = 0;
+    for (size_t i = 0; i < KNOB_COUNT; i++) evaluation.applied[i] = profile.value[i];
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (!done[i]) continue;
+        if (evaluation.runs++ == 0) {
+            for (size_t k = 0; k < KNOB_COUNT; k++) evaluation.applied[k] = runs[i].applied[k];
+        }
+        evaluation.meanRunMs += runs[i].runMs;
+        if (!runs[i].ok) {
+            evaluation.failed++;
+            evaluation.drops[runs[i].firstDrop]++;
+        }
+    }
+    if (evaluation.runs) evaluation.meanRunMs /= evaluation.runs;
+    evaluation.passed = (evaluation.runs == options.runs && evaluation.failed <= allowed);
+    return evaluation;
+}
+
+static double successPct(const Evaluation& evaluation) {
+    return evaluation.runs ? 100.0 * (evaluation.runs - evaluation.failed) / evaluation.runs : 0;
+}
+
+static void printEvaluation(const char* label, const Evaluation& evaluation) {
+    printf("%-16s %6.1f %% (%u of %u runs failed%s), mean run %.1f s\n", label,
+           successPct(evaluation), evaluation.failed, evaluation.runs,
+           evaluation.passed ? "" : ", stopped early", evaluation.meanRunMs / 1000);
+    if (!evaluation.drops.empty()) {
+        std::map<std::string, unsigned>::const_iterator most = evaluation.drops.begin();
+        for (std::map<std::string, unsigned>::const_iterator it = most; it != evaluation.drops.end(); ++it) {
+            if (it->second > most->second) most = it;
+        }
+        printf("%-16s most first drops: %s (%u)\n", "", most->first.c_str(), most->second);
+    }
+}
+
+// ===========================================
+// Search
+// ===========================================
+
+// Defaults too tight for these hosts: raise the delay that buys the
+// most good runs (before the allowed failures are used up) per second
+// it adds to a run, again and again until the profile passes
+static bool raiseUntilPassing(Profile& profile, Evaluation& evaluation, const double uses[KNOB_COUNT],
+                              const RobustOptions& options) {
+    for (int round = 1; !evaluation.passed; round++) {
+        if (round > ROBUST_MAX_RAISES) return false;
+        long good = evaluation.runs - evaluation.failed;
+        size_t best = KNOB_COUNT;
+        double bestGain = 0;
+        Profile bestProfile;
+        Evaluation bestEvaluation;
+        for (size_t k = 0; k < KNOB_COUNT; k++) {
+            Profile trial = profile;
+            trial.value[k] = trial.value[k] * (100 + ROBUST_RAISE_PCT) / 100 + ROBUST_STEP_MS;
+            Evaluation result = evaluate(trial, options);
+            double addedMs = uses[k] * (trial.value[k] - profile.value[k]) + 1;
+            double gain = (long)(result.runs - result.failed) - good;
+            gain = (gain > 0) ? gain / addedMs : gain;
+            if (best == KNOB_COUNT || gain > bestGain) {
+                best = k;
+                bestGain = gain;
+                bestProfile = trial;
+                bestEvaluation = result;
+            }
+        }
+        printf("  %-15s %6ld -> %5ld   %5.1f %% of %u runs\n", knobs[best].name, profile.value[best],
+               bestProfile.value[best], successPct(bestEvaluation), bestEvaluation.runs);
+        fflush(stdout);
+        profile = bestProfile;
+        evaluation = bestEvaluation;
+    }
+    return true;
+}
+
+// Run time the pacing alone spends in each delay: extra run time per ms
+// of extra delay, i.e. how often the payload waits it
+static void measureUses(const Profile& profile, const RobustOptions& options, double uses[KNOB_COUNT]) {
+    RunOutcome base = runOnce(profile, options.latency, 0, false);
+    runParallel(KNOB_COUNT, options.threads, [&](size_t k) {
+        Profile longer = profile;
+        longer.value[k] += ROBUST_USE_STEP_MS;
+        RunOutcome run = runOnce(longer, options.latency, 0, false);
+        uses[k] = (run.runMs - base.runMs) / ROBUST_USE_STEP_MS;
+        return true;
+    });
+}
+
+// Smallest value of one delay that still passes, everything else fixed.
+// The firmware clamps to its floor; a passing floor ends the search.
+static long lowestPassing(Profile profile, size_t knob, const RobustOptions& options, bool* atFloor) {
+    long lo = -1;                               // Known to fail (or below any floor)
+    long hi = profile.value[knob];
+    *atFloor = false;
+    while (hi - lo > ROBUST_STEP_MS) {
+        long mid = (lo + hi) / 2;
+        profile.value[knob] = mid;
+        Evaluation evaluation = evaluate(profile, options);
+        long applied = evaluation.applied[knob];
+        if (applied > mid) {
+            if (evaluation.passed) {
+                *atFloor = true;
+                return applied;
+            }
+            lo = applied;
+            continue;
+        }
+        if (evaluation.passed) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    return hi;
+}
+
+static bool writeProfile(const Profile& profile, const Evaluation& evaluation,
+                         const RobustOptions& options) {
+    FILE* file = fopen(options.profilePath, "w");
+    if (!file) {
+        fprintf(stderr, "cannot write %s\n", options.profilePath);
+        return false;
+    }
+    const HostLatency& latency = options.latency;
+    fprintf(file, "# Win10 timing: %.1f %% of %u runs (target %.1f %%), mean run %.1f s\n",
+            successPct(evaluation), evaluation.runs, options.targetPct, evaluation.meanRunMs / 1000);
+    fprintf(file, "# Hosts: key %u ms, Enter %u ms, sigma %.2f, stalls %.2f %% up to %u ms\n",
+            latency.keyMs, latency.enterMs, latency.sigma, latency.stallPct, latency.stallMs);
+    fprintf(file, "# Console lines (D7 out, no run):\n");
+    for (size_t i = 0; i < KNOB_COUNT; i++) {
+        if (!knobs[i].learnedWait) fprintf(file, "set %s %ld\n", knobs[i].name, profile.value[i]);
+    }
+    fprintf(file, "# Learned waits, as Config set (0x07) frames: id value\n");
+    for (size_t i = 0; i < KNOB_COUNT; i++) {
+        if (knobs[i].learnedWait) {
+            fprintf(file, "# config %u %ld   %s\n", knobs[i].step, profile.value[i], knobs[i].name);
+        }
+    }
+    fclose(file);
+    printf("Profile written to %s\n", options.profilePath);
+    return true;
+}
+
+static bool writeEeprom(const Profile& profile, const char* path) {
+    std::string text;
+    bool ran = runIsolated([&profile, path](std::string& out) {
+        long applied[KNOB_COUNT];
+        presetProfile(profile, applied);
+        out = simSaveEeprom(path) ? "ok" : "";
+    }, text);
+    if (!ran || text != "ok") {
+        fprintf(stderr, "cannot write %s\n", path);
+        return false;
+    }
+    printf("EEPROM image written to %s\n", path);
+    return true;
+}
+
+// ===========================================
+// robust
+// ===========================================
+
+int commandRobust(int argc, char** argv) {
+    RobustOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+    const HostLatency& latency = options.latency;
+    printf("Win10 pacing on random hosts: %u runs per candidate, target %.1f %%, %u thread(s)\n",
+           options.runs, options.targetPct, options.threads);
+    printf("Hosts: key %u ms, Enter %u ms (log-normal, sigma %.2f), stalls %.2f %% up to %u ms\n\n",
+           latency.keyMs, latency.enterMs, latency.sigma, latency.stallPct, latency.stallMs);
+
+    Profile defaults;
+    Evaluation first = evaluate(defaults, options);
+    Evaluation start = first;
+    printEvaluation("defaults", first);
+
+    double uses[KNOB_COUNT];
+    measureUses(defaults, options, uses);
+
+    Profile profile = defaults;
+    if (!first.passed) {
+        printf("\nRaising the delay that helps most for its cost until the target is met:\n");
+        if (!raiseUntilPassing(profile, start, uses, options)) {
+            printf("\nNo profile within %d raises passes - check the host latencies\n", ROBUST_MAX_RAISES);
+            return 1;
+        }
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < KNOB_COUNT; i++) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return uses[a] * profile.value[a] > uses[b] * profile.value[b];
+    });
+
+    // A second pass only if the first changed anything: a delay lowered
+    // late can let one lowered early go further
+    printf("\nLowering one delay at a time (most run time first, * = firmware floor):\n");
+    bool changed = true;
+    for (int pass = 0; pass < ROBUST_PASSES && changed; pass++) {
+        changed = false;
+        for (size_t n = 0; n < order.size(); n++) {
+            size_t k = order[n];
+            bool atFloor = false;
+            long before = profile.value[k];
+            profile.value[k] = lowestPassing(profile, k, options, &atFloor);
+            if (profile.value[k] == before) continue;
+            changed = true;
+            printf("  %-15s %6ld -> %5ld%s\n", knobs[k].name, before, profile.value[k], atFloor ? "*" : "");
+            fflush(stdout);
+        }
+    }
+
+    Evaluation robust = evaluate(profile, options);
+    printf("\n");
+    printEvaluation("robust profile", robust);
+    printf("%-16s %+.1f s against the defaults\n", "", (robust.meanRunMs - first.meanRunMs) / 1000);
+
+    // What each delay costs, and how close to the edge it now sits
+    printf("\nSensitivity of the robust profile:\n");
+    printf("%-15s %8s %8s %9s %9s %11s\n", "delay", "default", "robust", "uses/run", "run s",
+           "ok at -25%");
+    for (size_t n = 0; n < order.size(); n++) {
+        size_t k = order[n];
+        Profile shorter = profile;
+        shorter.value[k] = profile.value[k] * (100 - ROBUST_PROBE_PCT) / 100;
+        Evaluation probe = evaluate(shorter, options);
+        char ok[16];
+        snprintf(ok, sizeof(ok), "%.1f %%%s", successPct(probe), probe.passed ? "" : "*");
+        printf("%-15s %8u %8ld %9.1f %9.1f %11s\n", knobs[k].name, knobs[k].defaultMs,
+               profile.value[k], uses[k], uses[k] * profile.value[k] / 1000, ok);
+    }
+    printf("(* = below target; stopped at the first run over the allowed failures)\n");
+
+    if (options.profilePath && !writeProfile(profile, robust, options)) return 1;
+    if (options.eepromPath && !writeEeprom(profile, options.eepromPath)) return 1;
+    return robust.passed ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+/**
+ * Robust Win10 Timing Search
+ *
+ * Monte Carlo over the win10 payload: each candidate timing profile is
+ * run many times against SlowHostPc targets with random latencies, on a
+ * pool of worker threads (one forked child per run, as everywhere in
+ * sim/). Run i always meets the host seeded with i, so two candidates
+ * are compared on the same machines.
+ *
+ *   simulator robust [--runs N] [--target PCT] [--threads N]
+ *                    [--key-ms MS] [--enter-ms MS] [--sigma X]
+ *                    [--stall-pct PCT] [--stall-ms MS]
+ *                    [--profile-out FILE] [--eeprom FILE]
+ *
+ * A candidate passes if at most (100 - target) % of its runs drop a key
+ * in Setup. Starting from the defaults (raised first if they don't
+ * pass), the delays of executeWindows10Install are lowered one at a
+ * time, the ones the run spends most time in first, to the smallest
+ * value that still passes.
+ *
+ * The result is a profile of console "set" lines (the learned waits as
+ * Config set frame IDs) and, with --eeprom, an image with all of it
+ * stored. The sensitivity report says how much run time each delay
+ * costs and what the success rate does with it 25 % shorter.
+ */
+
+#ifndef ROBUST_TIMING_H
+#define ROBUST_TIMING_H
+
+int commandRobust(int argc, char** argv);
+
+#endif // ROBUST_TIMING_H
@@ -0,0 +1,240 @@
+/**
+ * Simulated Runs Implementation
+ */
+
+#include "scenario.h"
+#include "../include/config.h"
+#include "../src/serial_link.h"
+#include "../src/telemetry.h"
+#include <FrameProtocol.h>
+#include <Keyboard.h>
+#include <stdlib.h>
+#include <string.h>
+
+// main.cpp
+void setup();
+void loop();
+
+#define CONSOLE_TYPE_AT     500         // First command, while D7 is still in
+#define CONSOLE_REPLY_MS    200         // Technician reading and typing
+#define REBOOT_DROP_MS      1500        // Chained run: password saved -> bus reset
+#define REBOOT_DOWN_MS      6000        // ... -> enumerated again in POST
+#define WINPE_DROP_MS       6000        // Boot device chosen -> WinPE resets the bus
+#define WINPE_DOWN_MS       400         // ... -> enumerated by WinPE
+
+static const char* const payloadWords[PAYLOAD_COUNT] = { "bios", "win10", "chain", "script" };
+static const char* const profileWords[PROFILE_COUNT] = { "tuned", "safe", "slow" };
+
+// Stand-in for a taught script (format in key_script.h): F12 twice,
+// boot menu wait, Down Down Enter, Alt+D, y
+static const uint8_t sampleScript[] = {
+    0x00, KEY_F12,
+    10, KEY_F12,
+    0x81, 0x2C, KEY_DOWN_ARROW,             // 3 s
+    30, KEY_DOWN_ARROW,
+    50, KEY_RETURN,
+    100, KEY_LEFT_ALT, 'd',
+    20, 'y'
+};
+
+Scenario::Scenario()
+    : payload(PAYLOAD_WIN10), profile(PROFILE_TUNED),
+      limitMs(30UL * 60 * 1000), idleMs(0), recordPinReads(false) {
+}
+
+bool parsePayload(const char* word, uint8_t* payload) {
+    for (uint8_t i = 0; i < PAYLOAD_COUNT; i++) {
+        if (strcmp(word, payloadWords[i]) == 0) {
+            *payload = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseProfile(const char* word, uint8_t* profile) {
+    for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+        if (strcmp(word, profileWords[i]) == 0) {
+            *profile = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* payloadWord(uint8_t payload) {
+    return (payload < PAYLOAD_COUNT) ? payloadWords[payload] : "?";
+}
+
+const char* profileWord(uint8_t profile) {
+    return (profile < PROFILE_COUNT) ? profileWords[profile] : "?";
+}
+
+bool isWiredStart(const Scenario& scenario) {
+    if (scenario.profile != PROFILE_TUNED || PAYLOAD_MENU) return false;
+    uint8_t biosWired = CHAIN_PAYLOADS ? PAYLOAD_CHAIN : PAYLOAD_BIOS;
+    return scenario.payload == PAYLOAD_WIN10 || scenario.payload == biosWired;
+}
+
+// Follows the run through the link state and telemetry phase at every wait
+struct RunWatch {
+    RunResult* result;
+    uint8_t phase;
+    SimTime goAccepted;         // Console said "OK running" (0 = not yet)
+
+    void sample() {
+        SimTime now = simNow();
+        uint8_t state = getLinkState();
+        if (!result->started && state == FRAME_STATE_RUNNING) {
+            result->started = true;
+            result->runStart = now;
+        }
+        if (result->started && !result->finished && state == FRAME_STATE_DONE) {
+            result->finished = true;
+            result->runEnd = now;
+        }
+
+        uint8_t current = getRunPhase();
+        if (result->finished) current = 0xFF;
+        if (current == phase) return;
+        if (phase != 0xFF && !result->phases.empty()) {
+            result->phases.back().end = now;
+        }
+        if (current == PHASE_REBOOT) {
+            // The target restarts after the password change is saved
+            simAt(now + SIM_MS(REBOOT_DROP_MS), []() { simSetUsbConfigured(false); });
+            simAt(now + SIM_MS(REBOOT_DROP_MS + REBOOT_DOWN_MS), []() { simSetUsbConfigured(true); });
+        }
+        if (current == PHASE_SETUP_LOAD) {
+            // WinPE's USB stack takes the keyboard over from the firmware
+            simAt(now + SIM_MS(WINPE_DROP_MS), []() { simSetUsbConfigured(false); });
+            simAt(now + SIM_MS(WINPE_DROP_MS + WINPE_DOWN_MS), []() { simSetUsbConfigured(true); });
+        }
+        if (current != 0xFF) {
+            PhaseSpan span = { current, now, now };
+            result->phases.push_back(span);
+        }
+        phase = current;
+    }
+};
+
+// Types one command per "OK", pulls D7 after the last one and answers
+// the token the firmware prints for "arm"
+static void startConsoleRun(const Scenario& scenario, RunWatch* watch) {
+    std::vector<std::string> commands;
+    commands.push_back(std::string("payload ") + payloadWord(scenario.payload) + "\n");
+    commands.push_back(std::string("profile ") + profileWord(scenario.profile) + "\n");
+    simSerialInputAt(SIM_MS(CONSOLE_TYPE_AT), commands[0]);
+
+    size_t* acked = new size_t(0);
+    simOnSerialLine([commands, acked, watch](const std::string& line) {
+        SimTime reply = simNow() + SIM_MS(CONSOLE_REPLY_MS);
+        if (line.compare(0, 10, "OK running") == 0) {
+            watch->goAccepted = simNow();
+            return;
+        }
+        size_t at = line.find("OK type: go ");
+        if (at != std::string::npos) {
+            std::string go = "go " + std::to_string(atoi(line.c_str() + at + 12)) + "\n";
+            simSerialInputAt(reply, go);
+        } else if (line.compare(0, 2, "OK") == 0 && *acked < commands.size()) {
+            if (++*acked < commands.size()) {
+                simSerialInputAt(reply, commands[*acked]);
+            } else {
+                simAt(reply, []() { simFloatPin(ARM_BUTTON_PIN); });
+            }
+        }
+    });
+}
+
+void storeKeyScript(const uint8_t* steps, uint16_t length) {
+    uint8_t* script = simEeprom() + EEPROM_SCRIPT_ADDR;
+    uint8_t sum = 0xA5;
+    sum = (sum << 1 | sum >> 7) ^ (uint8_t)length;
+    sum = (sum << 1 | sum >> 7) ^ (uint8_t)(length >> 8);
+    for (uint16_t i = 0; i < length; i++) {
+        sum = (sum << 1 | sum >> 7) ^ steps[i];
+    }
+    script[0] = 'K';
+    script[1] = 'S';
+    script[2] = 1;                      // KEY_SCRIPT_VERSION
+    script[3] = sum;
+    script[4] = length & 0xFF;
+    script[5] = length >> 8;
+    memcpy(script + 6, steps, length);
+}
+
+RunResult runScenario(const Scenario& scenario) {
+    RunResult result;
+    result.started = false;
+    result.finished = false;
+    result.timedOut = false;
+    result.runStart = 0;
+    result.runEnd = 0;
+
+    RunWatch* watch = new RunWatch();
+    watch->result = &result;
+    watch->phase = 0xFF;
+    watch->goAccepted = 0;
+    simOnWait([watch]() { watch->sample(); });
+
+    if (!scenario.eepromIn.empty()) {
+        simLoadEeprom(scenario.eepromIn.c_str());
+    } else if (!scenario.script.empty()) {
+        storeKeyScript(scenario.script.data(), scenario.script.size());
+    } else if (scenario.payload == PAYLOAD_SCRIPT) {
+        storeKeyScript(sampleScript, sizeof(sampleScript));
+    }
+    simAddI2cDevice(LCD_ADDRESS);
+    simRecordPinReads(scenario.recordPinReads);
+    simSetDeadline(SIM_MS(scenario.limitMs));
+
+    bool wired = isWiredStart(scenario);
+    if (wired) {
+        simFloatPin(ARM_BUTTON_PIN);
+        if (scenario.payload == PAYLOAD_WIN10) {
+            simFloatPin(MODE_SELECT_PIN);
+        } else {
+            simDrivePin(MODE_SELECT_PIN, LOW);
+        }
+    } else {
+        simDrivePin(ARM_BUTTON_PIN, LOW);
+        simDrivePin(MODE_SELECT_PIN, LOW);
+        startConsoleRun(scenario, watch);
+    }
+
+    try {
+        setup();
+        if (!wired) {
+            simSerialInputAt(simNow() + SIM_MS(CONSOLE_REPLY_MS), "arm\n");
+        }
+        while (!result.finished) {
+            loop();
+            // A console run that never waited (nothing to replay) starts
+            // and ends between two samples; loop() ran all of it
+            if (watch->goAccepted && !result.finished) {
+                if (!result.started) {
+                    result.started = true;
+                    result.runStart = watch->goAccepted;
+                }
+                result.finished = true;
+                result.runEnd = simNow();
+            }
+        }
+        SimTime idleUntil = simNow() + SIM_MS(scenario.idleMs);
+        while (simNow() < idleUntil) {
+            loop();
+        }
+    } catch (const SimStop&) {
+        result.timedOut = true;
+    }
+
+    if (!result.phases.empty() && result.phases.back().end < result.phases.back().start) {
+        result.phases.back().end = simNow();
+    }
+    if (!scenario.eepromOut.empty()) {
+        simSaveEeprom(scenario.eepromOut.c_str());
+    }
+    simSetDeadline(0);
+    return result;
+}
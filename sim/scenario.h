@@ -0,0 +1,76 @@
+/**
+ * Simulated Runs
+ *
+ * Powers up the firmware (setup(), then loop()) against a SimPc and
+ * works the wires and the Serial console like a technician would:
+ *
+ *  - Wired start: the tuned profile of the payload the wires select
+ *    (D7 out = BIOS, D7 + D10 out = Win10) starts at power-up
+ *  - Console start: everything else. D7 stays in, "payload" and
+ *    "profile" are typed, D7 comes out, then "arm" and "go <token>"
+ *
+ * The script payload without an EEPROM image replays the scenario's
+ * script steps, or a short sample script. The target enumerates the
+ * board again when WinPE starts loading, and a chained run's target
+ * reboots (USB drops and comes back) once the firmware starts waiting
+ * for it.
+ *
+ * The firmware keeps its state in globals, so one process runs one
+ * scenario; tools that need many runs fork a child per run.
+ */
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <SimHost.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct Scenario {
+    uint8_t payload;            // PAYLOAD_*
+    uint8_t profile;            // PROFILE_*
+    std::string eepromIn;       // EEPROM image to start from ("" = blank + script)
+    std::string eepromOut;      // Save the EEPROM here afterwards
+    std::vector<uint8_t> script;    // Script steps to store ({} = sample script)
+    uint32_t limitMs;           // Give up after this much virtual time
+    uint32_t idleMs;            // Keep running loop() this long after the run
+    bool recordPinReads;
+
+    Scenario();
+};
+
+// Time spent in one phase (phases may repeat)
+struct PhaseSpan {
+    uint8_t phase;              // RunPhase
+    SimTime start;
+    SimTime end;
+};
+
+struct RunResult {
+    bool started;               // The link state went RUNNING
+    bool finished;              // ... and back to DONE
+    bool timedOut;              // limitMs reached first
+    SimTime runStart;
+    SimTime runEnd;
+    std::vector<PhaseSpan> phases;
+};
+
+// Payload / profile from their console words ("win10", "safe"); false if unknown
+bool parsePayload(const char* word, uint8_t* payload);
+bool parseProfile(const char* word, uint8_t* profile);
+const char* payloadWord(uint8_t payload);
+const char* profileWord(uint8_t profile);
+
+// True if the scenario starts from the wires rather than the console
+bool isWiredStart(const Scenario& scenario);
+
+// Write a key script (steps in key_script.h format) with its header
+// into the simulated EEPROM
+void storeKeyScript(const uint8_t* steps, uint16_t length);
+
+// Run the firmware once. Call simSetPc() first; everything it did is
+// in the SimHost records afterwards.
+RunResult runScenario(const Scenario& scenario);
+
+#endif // SCENARIO_H
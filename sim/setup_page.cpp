@@ -0,0 +1,514 @@
+/**
+ * Windows Setup Disk Page Model Implementation
+ */
+
+#include "setup_page.h"
+#include <stdio.h>
+#include <string.h>
+
+#define USAGE_ENTER         0x28
+#define USAGE_ESC           0x29
+#define USAGE_TAB           0x2B
+#define USAGE_SPACE         0x2C
+#define USAGE_HOME          0x4A
+#define USAGE_PAGE_UP       0x4B
+#define USAGE_END           0x4D
+#define USAGE_PAGE_DOWN     0x4E
+#define USAGE_RIGHT         0x4F
+#define USAGE_LEFT          0x50
+#define USAGE_DOWN          0x51
+#define USAGE_UP            0x52
+
+#define SHIFT_BITS          0x22        // Left or right Shift
+#define MIN_INSTALL_MB      20000       // Next stays grey below this
+#define PAGE_ROWS           5           // Page Up/Down step
+#define BUTTON_OK           0
+#define BUTTON_CANCEL       1
+#define EDITOR_SIZE         0
+#define EDITOR_APPLY        1
+#define EDITOR_CANCEL       2
+
+SetupTiming::SetupTiming()
+    : dialogMs(300), deleteMs(700), formatMs(1500), createMs(1500), refreshMs(1000) {
+}
+
+// ===========================================
+// State
+// ===========================================
+
+bool SetupState::operator==(const SetupState& other) const {
+    return key() == other.key();
+}
+
+std::string SetupState::key() const {
+    std::string text;
+    char part[48];
+    for (size_t i = 0; i < rows.size(); i++) {
+        snprintf(part, sizeof(part), "%u:%u:%u,", rows[i].disk, rows[i].kind, rows[i].sizeMb);
+        text += part;
+    }
+    snprintf(part, sizeof(part), "|%u %u %u %u %u", selected, focus, link, button, end);
+    text += part;
+    return text;
+}
+
+static bool isPartition(const DiskRow& row) {
+    return row.kind != ROW_FREE;
+}
+
+bool isLinkEnabled(const SetupState& state, uint8_t link) {
+    if (state.rows.empty()) return link == LINK_REFRESH || link == LINK_LOAD_DRIVER;
+    const DiskRow& row = state.rows[state.selected];
+    switch (link) {
+        case LINK_REFRESH:
+        case LINK_LOAD_DRIVER:
+            return true;
+        case LINK_DELETE:
+        case LINK_FORMAT:
+            return isPartition(row);
+        case LINK_NEW:
+            return !isPartition(row);
+        case LINK_EXTEND:
+            return isPartition(row) && state.selected + 1u < state.rows.size() &&
+                   state.rows[state.selected + 1].disk == row.disk &&
+                   !isPartition(state.rows[state.selected + 1]);
+    }
+    return false;
+}
+
+bool isNextEnabled(const SetupState& state) {
+    if (state.rows.empty()) return false;
+    const DiskRow& row = state.rows[state.selected];
+    return (row.kind == ROW_FREE || row.kind == ROW_PRIMARY) && row.sizeMb >= MIN_INSTALL_MB;
+}
+
+// Neighbouring free space on the same disk becomes one row
+static uint8_t mergeFree(std::vector<DiskRow>& rows, uint8_t index) {
+    if (index + 1u < rows.size() && rows[index + 1].disk == rows[index].disk &&
+        rows[index + 1].kind == ROW_FREE) {
+        rows[index].sizeMb += rows[index + 1].sizeMb;
+        rows.erase(rows.begin() + index + 1);
+    }
+    if (index > 0 && rows[index - 1].disk == rows[index].disk && rows[index - 1].kind == ROW_FREE) {
+        rows[index - 1].sizeMb += rows[index].sizeMb;
+        rows.erase(rows.begin() + index);
+        index--;
+    }
+    return index;
+}
+
+// New on free space: the system partitions too if the disk is empty
+static void createPartitions(SetupState& state) {
+    DiskRow free = state.rows[state.selected];
+    bool diskEmpty = true;
+    for (size_t i = 0; i < state.rows.size(); i++) {
+        if (state.rows[i].disk == free.disk && isPartition(state.rows[i])) diskEmpty = false;
+    }
+
+    std::vector<DiskRow> made;
+    if (diskEmpty && free.sizeMb > 200) {
+        DiskRow system = { free.disk, ROW_SYSTEM, 100 };
+        DiskRow msr = { free.disk, ROW_MSR, 16 };
+        made.push_back(system);
+        made.push_back(msr);
+        free.sizeMb -= 116;
+    }
+    DiskRow primary = { free.disk, ROW_PRIMARY, free.sizeMb };
+    made.push_back(primary);
+
+    state.rows.erase(state.rows.begin() + state.selected);
+    state.rows.insert(state.rows.begin() + state.selected, made.begin(), made.end());
+    state.selected += made.size() - 1;
+    state.created += made.size();
+}
+
+// ===========================================
+// Keys
+// ===========================================
+
+static void moveLink(SetupState& state, int step) {
+    int link = state.link;
+    while (true) {
+        link += step;
+        if (link < 0 || link >= LINK_COUNT) return;     // No wrap
+        if (isLinkEnabled(state, link)) {
+            state.link = link;
+            return;
+        }
+    }
+}
+
+static void activateLink(SetupState& state) {
+    switch (state.link) {
+        case LINK_REFRESH:
+            state.strayActions++;
+            state.selected = 0;
+            state.focus = FOCUS_LIST;
+            break;
+        case LINK_NEW:
+            state.focus = FOCUS_EDITOR;
+            state.button = EDITOR_SIZE;
+            break;
+        case LINK_LOAD_DRIVER:
+            state.strayActions++;
+            state.focus = FOCUS_DIALOG;
+            state.button = BUTTON_CANCEL;
+            break;
+        default:
+            state.focus = FOCUS_DIALOG;
+            state.button = BUTTON_CANCEL;
+            break;
+    }
+}
+
+// OK in a confirmation dialog
+static void confirmDialog(SetupState& state) {
+    DiskRow& row = state.rows[state.selected];
+    uint8_t disk = row.disk < 4 ? row.disk : 3;
+
+    switch (state.link) {
+        case LINK_DELETE:
+            if (isPartition(row)) {
+                row.kind = ROW_FREE;
+                state.deleted[disk]++;
+                state.selected = mergeFree(state.rows, state.selected);
+            }
+            state.focus = FOCUS_LIST;
+            break;
+        case LINK_FORMAT:
+            if (isPartition(row)) state.formatted[disk]++;
+            state.strayActions++;
+            state.focus = FOCUS_LIST;
+            break;
+        case LINK_NEW:
+            if (!isPartition(row)) createPartitions(state);
+            state.focus = FOCUS_LIST;
+            break;
+        case LINK_EXTEND:
+            if (isLinkEnabled(state, LINK_EXTEND)) {
+                row.sizeMb += state.rows[state.selected + 1].sizeMb;
+                state.rows.erase(state.rows.begin() + state.selected + 1);
+            }
+            state.strayActions++;
+            state.focus = FOCUS_LIST;
+            break;
+        default:                                // Load driver: nothing picked
+            state.focus = FOCUS_LINKS;
+            break;
+    }
+}
+
+static void cancelDialog(SetupState& state) {
+    state.focus = FOCUS_LINKS;
+    if (!isLinkEnabled(state, state.link)) state.link = LINK_REFRESH;
+}
+
+void SetupPage::applyKey(SetupState& state, uint8_t usage, uint8_t modifiers) {
+    if (state.end != END_NONE || state.rows.empty()) return;
+    bool shift = (modifiers & SHIFT_BITS) != 0;
+    bool activate = (usage == USAGE_ENTER || usage == USAGE_SPACE);
+    uint8_t last = state.rows.size() - 1;
+
+    switch (state.focus) {
+        case FOCUS_LIST:
+            if (usage == USAGE_UP && state.selected > 0) state.selected--;
+            if (usage == USAGE_DOWN && state.selected < last) state.selected++;
+            if (usage == USAGE_HOME) state.selected = 0;
+            if (usage == USAGE_END) state.selected = last;
+            if (usage == USAGE_PAGE_UP) state.selected = (state.selected > PAGE_ROWS) ? state.selected - PAGE_ROWS : 0;
+            if (usage == USAGE_PAGE_DOWN) state.selected = (state.selected + PAGE_ROWS < last) ? state.selected + PAGE_ROWS : last;
+            if (usage == USAGE_TAB) {
+                if (shift) {
+                    state.focus = FOCUS_BACK;
+                } else {
+                    state.focus = FOCUS_LINKS;
+                    state.link = LINK_REFRESH;
+                }
+            }
+            if (usage == USAGE_ENTER && isNextEnabled(state)) {
+                state.end = END_INSTALL;
+                state.installRow = state.rows[state.selected];
+            }
+            break;
+
+        case FOCUS_LINKS:
+            if (usage == USAGE_RIGHT) moveLink(state, 1);
+            if (usage == USAGE_LEFT) moveLink(state, -1);
+            if (usage == USAGE_TAB) {
+                state.focus = shift ? FOCUS_LIST : (isNextEnabled(state) ? FOCUS_NEXT : FOCUS_BACK);
+            }
+            if (activate) activateLink(state);
+            break;
+
+        case FOCUS_NEXT:
+            if (usage == USAGE_TAB) state.focus = shift ? FOCUS_LINKS : FOCUS_BACK;
+            if (activate) {
+                state.end = END_INSTALL;
+                state.installRow = state.rows[state.selected];
+            }
+            break;
+
+        case FOCUS_BACK:
+            if (usage == USAGE_TAB) {
+                state.focus = shift ? (isNextEnabled(state) ? FOCUS_NEXT : FOCUS_LINKS) : FOCUS_LIST;
+            }
+            if (activate) state.end = END_BACK;
+            break;
+
+        case FOCUS_DIALOG:
+            if (usage == USAGE_TAB || usage == USAGE_LEFT || usage == USAGE_RIGHT) state.button ^= 1;
+            if (usage == USAGE_ESC) cancelDialog(state);
+            if (activate) {
+                if (state.button == BUTTON_OK) {
+                    confirmDialog(state);
+                } else {
+                    cancelDialog(state);
+                }
+            }
+            break;
+
+        case FOCUS_EDITOR:
+            if (usage == USAGE_TAB) state.button = (state.button + (shift ? 2 : 1)) % 3;
+            if (usage == USAGE_ESC) cancelDialog(state);
+            if (activate) {
+                if (state.button == EDITOR_CANCEL) {
+                    cancelDialog(state);
+                } else {
+                    // "Windows might create additional partitions" - OK/Cancel
+                    state.focus = FOCUS_DIALOG;
+                    state.button = BUTTON_CANCEL;
+                }
+            }
+            break;
+    }
+}
+
+static bool opensDialog(const SetupState& before, const SetupState& after) {
+    return (after.focus == FOCUS_DIALOG || after.focus == FOCUS_EDITOR) &&
+           !(before.focus == FOCUS_DIALOG) &&
+           !(before.focus == FOCUS_EDITOR && after.focus == FOCUS_EDITOR);
+}
+
+uint32_t SetupPage::keyLatency(const SetupState& before, const SetupState& after,
+                               const SetupTiming& timing) {
+    if (opensDialog(before, after)) return timing.dialogMs;
+    for (int d = 0; d < 4; d++) {
+        if (after.deleted[d] != before.deleted[d]) return timing.deleteMs;
+        if (after.formatted[d] != before.formatted[d]) return timing.formatMs;
+    }
+    if (after.created != before.created) return timing.createMs;
+    if (after.rows.size() != before.rows.size()) return timing.deleteMs;     // Extend
+    if (after.strayActions != before.strayActions && after.focus == FOCUS_LIST) return timing.refreshMs;
+    return 0;
+}
+
+// ===========================================
+// Timed page
+// ===========================================
+
+SetupPage::SetupPage(const SetupLayout& layout, const SetupTiming& timing)
+    : timing(timing), dialogAt(0), busyUntil(0), dropped(0), endTime(0) {
+    memset(current.deleted, 0, sizeof(current.deleted));
+    memset(current.formatted, 0, sizeof(current.formatted));
+    current.rows = layout.rows;
+    current.selected = 0;
+    current.focus = FOCUS_LIST;
+    current.link = LINK_REFRESH;
+    current.button = 0;
+    current.end = END_NONE;
+    current.installRow = layout.rows.empty() ? DiskRow() : layout.rows[0];
+    current.created = 0;
+    current.strayActions = 0;
+    shown = current;
+}
+
+void SetupPage::catchUp(uint32_t atMs) {
+    // The dialog shows over the page as it is by then
+    if (dialogAt && atMs >= dialogAt) {
+        shown.focus = current.focus;
+        shown.button = current.button;
+        shown.link = current.link;
+        current = shown;
+        dialogAt = 0;
+    }
+}
+
+void SetupPage::press(uint8_t usage, uint8_t modifiers, uint32_t atMs) {
+    catchUp(atMs);
+    if (current.end != END_NONE) return;
+    if (atMs < busyUntil) {
+        dropped++;                              // Page disabled: the key is lost
+        return;
+    }
+
+    SetupState before = shown;
+    SetupState after = shown;
+    applyKey(after, usage, modifiers);
+    uint32_t latency = keyLatency(before, after, timing);
+
+    if (opensDialog(before, after)) {
+        // Keys keep going to the page until the dialog is up
+        current = after;
+        shown = after;
+        shown.focus = before.focus;
+        shown.button = before.button;
+        shown.link = before.link;
+        dialogAt = atMs + latency;
+        return;
+    }
+
+    if (dialogAt) {
+        // A page key while the dialog is still opening
+        SetupState pending = current;
+        current = after;
+        current.focus = pending.focus;
+        current.button = pending.button;
+        current.link = pending.link;
+        shown = after;
+    } else {
+        current = after;
+        shown = after;
+    }
+    if (latency) busyUntil = atMs + latency;
+    if (current.end != END_NONE) endTime = atMs;
+}
+
+void SetupPage::settle() {
+    catchUp(readyAt());
+}
+
+uint32_t SetupPage::readyAt() const {
+    return (dialogAt > busyUntil) ? dialogAt : busyUntil;
+}
+
+// ===========================================
+// Outcome
+// ===========================================
+
+SetupOutcome judgeSetup(const SetupState& state) {
+    SetupOutcome outcome;
+    outcome.collateral = 0;
+    for (int d = 1; d < 4; d++) {
+        outcome.collateral += state.deleted[d] + state.formatted[d];
+    }
+
+    uint16_t left = 0;
+    for (size_t i = 0; i < state.rows.size(); i++) {
+        if (state.rows[i].disk == 0 && isPartition(state.rows[i])) left++;
+    }
+
+    char text[96];
+    outcome.correct = false;
+    if (state.end == END_BACK) {
+        outcome.verdict = "went Back";
+    } else if (state.end != END_INSTALL) {
+        outcome.verdict = "Next never pressed";
+    } else if (state.installRow.disk != 0) {
+        snprintf(text, sizeof(text), "installing on drive %u", state.installRow.disk);
+        outcome.verdict = text;
+    } else if (state.installRow.kind != ROW_FREE) {
+        outcome.verdict = "installing into an old partition";
+    } else if (left) {
+        snprintf(text, sizeof(text), "%u partition(s) left on drive 0", left);
+        outcome.verdict = text;
+    } else if (outcome.collateral) {
+        snprintf(text, sizeof(text), "wiped %u partition(s) on other drives", outcome.collateral);
+        outcome.verdict = text;
+    } else {
+        outcome.correct = true;
+        outcome.verdict = "ok";
+    }
+    return outcome;
+}
+
+std::string rowName(const std::vector<DiskRow>& rows, size_t index) {
+    static const char* const kindNames[] = { "", "Recovery", "System", "MSR (Reserved)", "Primary", "OEM" };
+    const DiskRow& row = rows[index];
+    char text[80];
+    if (row.kind == ROW_FREE) {
+        snprintf(text, sizeof(text), "Drive %u Unallocated Space  %u MB", row.disk, row.sizeMb);
+        return text;
+    }
+    int number = 0;
+    for (size_t i = 0; i <= index; i++) {
+        if (rows[i].disk == row.disk && isPartition(rows[i])) number++;
+    }
+    snprintf(text, sizeof(text), "Drive %u Partition %d: %s  %u MB", row.disk, number,
+             kindNames[row.kind], row.sizeMb);
+    return text;
+}
+
+// ===========================================
+// Layouts
+// ===========================================
+
+static SetupLayout makeLayout(const char* name, const char* description,
+                              const DiskRow* rows, size_t count) {
+    SetupLayout layout;
+    layout.name = name;
+    layout.description = description;
+    layout.rows.assign(rows, rows + count);
+    return layout;
+}
+
+#define LAYOUT(name, description, rows) \
+    makeLayout(name, description, rows, sizeof(rows) / sizeof(rows[0]))
+
+static const DiskRow dellOem[] = {
+    { 0, ROW_SYSTEM, 500 }, { 0, ROW_MSR, 128 }, { 0, ROW_PRIMARY, 241000 },
+    { 0, ROW_RECOVERY, 990 }, { 0, ROW_OEM, 1450 }
+};
+static const DiskRow win10Gpt[] = {
+    { 0, ROW_RECOVERY, 529 }, { 0, ROW_SYSTEM, 99 }, { 0, ROW_MSR, 16 }, { 0, ROW_PRIMARY, 121450 }
+};
+static const DiskRow mbrLegacy[] = {
+    { 0, ROW_SYSTEM, 500 }, { 0, ROW_PRIMARY, 476439 }
+};
+static const DiskRow emptyDisk[] = {
+    { 0, ROW_FREE, 238475 }
+};
+static const DiskRow gapInside[] = {
+    { 0, ROW_SYSTEM, 100 }, { 0, ROW_MSR, 16 }, { 0, ROW_PRIMARY, 100000 },
+    { 0, ROW_FREE, 20000 }, { 0, ROW_PRIMARY, 118359 }
+};
+static const DiskRow oemMany[] = {
+    { 0, ROW_OEM, 1000 }, { 0, ROW_SYSTEM, 260 }, { 0, ROW_MSR, 16 }, { 0, ROW_PRIMARY, 200000 },
+    { 0, ROW_PRIMARY, 40000 }, { 0, ROW_RECOVERY, 900 }, { 0, ROW_OEM, 8000 },
+    { 0, ROW_OEM, 500 }, { 0, ROW_PRIMARY, 25000 }
+};
+static const DiskRow dataDisk[] = {
+    { 0, ROW_RECOVERY, 529 }, { 0, ROW_SYSTEM, 99 }, { 0, ROW_MSR, 16 }, { 0, ROW_PRIMARY, 121450 },
+    { 1, ROW_MSR, 16 }, { 1, ROW_PRIMARY, 953852 }
+};
+static const DiskRow dualOs[] = {
+    { 0, ROW_SYSTEM, 500 }, { 0, ROW_MSR, 128 }, { 0, ROW_PRIMARY, 241000 },
+    { 0, ROW_RECOVERY, 990 }, { 0, ROW_OEM, 1450 },
+    { 1, ROW_SYSTEM, 100 }, { 1, ROW_MSR, 16 }, { 1, ROW_PRIMARY, 930000 }, { 1, ROW_RECOVERY, 500 }
+};
+static const DiskRow emptyPlusData[] = {
+    { 0, ROW_FREE, 238475 }, { 1, ROW_MSR, 16 }, { 1, ROW_PRIMARY, 953852 }
+};
+
+const std::vector<SetupLayout>& setupLayouts() {
+    static std::vector<SetupLayout> layouts;
+    if (layouts.empty()) {
+        layouts.push_back(LAYOUT("dell-oem", "Dell factory GPT: ESP, MSR, OS, WinRE, SupportAssist", dellOem));
+        layouts.push_back(LAYOUT("win10-gpt", "Clean Win10 install: WinRE first, ESP, MSR, OS", win10Gpt));
+        layouts.push_back(LAYOUT("mbr-legacy", "Legacy BIOS/MBR: System Reserved, OS", mbrLegacy));
+        layouts.push_back(LAYOUT("empty", "Disk already wiped", emptyDisk));
+        layouts.push_back(LAYOUT("gap-inside", "GPT with free space between OS and data", gapInside));
+        layouts.push_back(LAYOUT("oem-many", "Nine partitions: OEM tools, images, data", oemMany));
+        layouts.push_back(LAYOUT("data-disk", "Win10 GPT + second drive with data", dataDisk));
+        layouts.push_back(LAYOUT("dual-os", "Dell OEM drive + second drive with an old Windows", dualOs));
+        layouts.push_back(LAYOUT("empty-data", "Empty drive 0 + second drive with data", emptyPlusData));
+    }
+    return layouts;
+}
+
+const SetupLayout* findSetupLayout(const std::string& name) {
+    const std::vector<SetupLayout>& layouts = setupLayouts();
+    for (size_t i = 0; i < layouts.size(); i++) {
+        if (name == layouts[i].name) return &layouts[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,165 @@
+/**
+ * Windows Setup Disk Page Model
+ *
+ * "Where do you want to install Windows?" as a state machine that takes
+ * key presses: the row list across all disks, the link bar (Refresh,
+ * Delete, Format, New, Load driver, Extend), Next and Back, the
+ * confirmation dialogs and the New size editor.
+ *
+ * Rules the model assumes (the ones the firmware's sweep relies on):
+ *  - Tab order: list, link bar, Next (only when enabled), Back. Tab
+ *    into the link bar lands on Refresh; Left/Right move between the
+ *    enabled links
+ *  - Enter in the list is the default button, Next
+ *  - A confirmation dialog opens with Cancel focused; Tab/arrows move
+ *    between OK and Cancel
+ *  - After a delete the rows merge and the merged free space is
+ *    selected, focus back in the list
+ *
+ * Time: a dialog shows dialogMs after its Enter - keys before that
+ * still go to the page. Disk operations (delete, create, format,
+ * refresh) disable the page for their duration; keys typed then are
+ * lost.
+ */
+
+#ifndef SETUP_PAGE_H
+#define SETUP_PAGE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+enum RowKind {
+    ROW_FREE = 0,               // Unallocated space
+    ROW_RECOVERY,
+    ROW_SYSTEM,                 // EFI system partition (MBR: System Reserved)
+    ROW_MSR,
+    ROW_PRIMARY,
+    ROW_OEM                     // OEM tools/diagnostics
+};
+
+struct DiskRow {
+    uint8_t disk;
+    uint8_t kind;               // RowKind
+    uint32_t sizeMb;
+};
+
+struct SetupLayout {
+    const char* name;
+    const char* description;
+    std::vector<DiskRow> rows;
+};
+
+// Latencies of the page (ms)
+struct SetupTiming {
+    uint32_t dialogMs;          // Enter on a link -> dialog/editor takes keys
+    uint32_t deleteMs;          // OK on Delete -> list back with merged rows
+    uint32_t formatMs;
+    uint32_t createMs;          // OK on New -> partitions created
+    uint32_t refreshMs;
+
+    SetupTiming();
+};
+
+enum SetupFocus {
+    FOCUS_LIST = 0,
+    FOCUS_LINKS,
+    FOCUS_NEXT,
+    FOCUS_BACK,
+    FOCUS_DIALOG,               // Confirmation: button 0 = OK, 1 = Cancel
+    FOCUS_EDITOR                // New: 0 = size box, 1 = Apply, 2 = Cancel
+};
+
+enum SetupLink {
+    LINK_REFRESH = 0,
+    LINK_DELETE,
+    LINK_FORMAT,
+    LINK_NEW,
+    LINK_LOAD_DRIVER,
+    LINK_EXTEND,
+    LINK_COUNT
+};
+
+// How the page was left
+enum SetupEnd {
+    END_NONE = 0,               // Still on the page
+    END_INSTALL,                // Next: installing on the selected row
+    END_BACK                    // Back: left the page
+};
+
+// Everything that decides what the next key does (the planner's state)
+struct SetupState {
+    std::vector<DiskRow> rows;
+    uint8_t selected;
+    uint8_t focus;              // SetupFocus
+    uint8_t link;               // SetupLink under focus / that opened the dialog
+    uint8_t button;             // Dialog or editor control
+    uint8_t end;                // SetupEnd
+    DiskRow installRow;
+
+    // What happened to the disks so far
+    uint16_t deleted[4];        // Partitions deleted per disk
+    uint16_t formatted[4];
+    uint16_t created;           // Partitions made with New
+    uint16_t strayActions;      // Refresh, Load driver, Extend, Format
+
+    bool operator==(const SetupState& other) const;
+    std::string key() const;    // Compact form for hashing
+};
+
+struct SetupOutcome {
+    bool correct;               // Disk 0 empty and installing on it
+    std::string verdict;        // Why not, or "ok"
+    uint16_t collateral;        // Partitions deleted/formatted on other disks
+};
+
+class SetupPage {
+public:
+    SetupPage(const SetupLayout& layout, const SetupTiming& timing);
+
+    // A key press reaches the target at atMs (HID usage, modifier bits)
+    void press(uint8_t usage, uint8_t modifiers, uint32_t atMs);
+
+    // Let pending dialogs and disk operations finish
+    void settle();
+
+    // Earliest time the page takes keys again
+    uint32_t readyAt() const;
+
+    const SetupState& state() const { return current; }
+    uint32_t droppedKeys() const { return dropped; }
+    uint32_t endedAt() const { return endTime; }
+
+    // Apply one key to a settled state (no time involved)
+    static void applyKey(SetupState& state, uint8_t usage, uint8_t modifiers);
+
+    // What applyKey() starts that takes time, in ms (0 = immediate)
+    static uint32_t keyLatency(const SetupState& before, const SetupState& after,
+                               const SetupTiming& timing);
+
+private:
+    void catchUp(uint32_t atMs);
+
+    SetupTiming timing;
+    SetupState current;         // What the page will be once pending work is done
+    SetupState shown;           // What keys act on right now
+    uint32_t dialogAt;          // Pending dialog appears (0 = none)
+    uint32_t busyUntil;         // Disk operation running
+    uint32_t dropped;
+    uint32_t endTime;
+};
+
+// Realistic layouts: Dell OEM, clean Win10 GPT, legacy MBR, data disk,
+// dual-disk machines, an already empty disk
+const std::vector<SetupLayout>& setupLayouts();
+const SetupLayout* findSetupLayout(const std::string& name);
+
+// Rows as Setup lists them ("Drive 0 Partition 2: System")
+std::string rowName(const std::vector<DiskRow>& rows, size_t index);
+
+bool isLinkEnabled(const SetupState& state, uint8_t link);
+bool isNextEnabled(const SetupState& state);
+
+SetupOutcome judgeSetup(const SetupState& state);
+
+#endif // SETUP_PAGE_H
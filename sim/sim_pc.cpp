@@ -0,0 +1,37 @@
+/**
+ * Simulated Target PCs Implementation
+ */
+
+#include "sim_pc.h"
+#include "../include/config.h"
+#include <string.h>
+
+bool isKeyPress(const SimKeyReport& before, const SimKeyReport& after, uint8_t usage) {
+    bool was = false;
+    bool is = false;
+    for (int i = 0; i < 6; i++) {
+        if (before.keys[i] == usage) was = true;
+        if (after.keys[i] == usage) is = true;
+    }
+    return is && !was;
+}
+
+BasicPc::BasicPc(uint32_t ledLatencyMs)
+    : ledLatencyMs(ledLatencyMs), leds(0) {
+    memset(&last, 0, sizeof(last));
+}
+
+void BasicPc::onKeyReport(const SimKeyReport& report) {
+    if (isKeyPress(last, report, USAGE_NUM_LOCK)) {
+        echoNumLock();
+    }
+    last = report;
+}
+
+void BasicPc::echoNumLock() {
+    leds ^= 0x01;
+    uint8_t state = leds;
+    simAt(simNow() + SIM_MS(ledLatencyMs), [state]() {
+        simSendOutputReport(HOST_LED_REPORT_ID, state);
+    });
+}
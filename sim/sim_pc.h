@@ -0,0 +1,35 @@
+/**
+ * Simulated Target PCs
+ *
+ * BasicPc is the simplest target that lets every payload finish: it
+ * takes every key and answers the Num Lock readiness probe right away,
+ * the way a machine whose OS is already up would.
+ */
+
+#ifndef SIM_PC_H
+#define SIM_PC_H
+
+#include <SimHost.h>
+
+class BasicPc : public SimPc {
+public:
+    explicit BasicPc(uint32_t ledLatencyMs = 20);
+    void onKeyReport(const SimKeyReport& report);
+
+    uint8_t getLeds() const { return leds; }
+
+protected:
+    // Toggle Num Lock and send the LED report after the latency
+    void echoNumLock();
+
+    uint32_t ledLatencyMs;
+    uint8_t leds;
+    SimKeyReport last;
+};
+
+// True if the report presses usage (not held down in the previous one)
+bool isKeyPress(const SimKeyReport& before, const SimKeyReport& after, uint8_t usage);
+
+#define USAGE_NUM_LOCK      0x53
+
+#endif // SIM_PC_H
@@ -0,0 +1,314 @@
+/**
+ * Native Simulator
+ *
+ * Runs the firmware in src/ against a simulated target PC on a virtual
+ * clock ([env:native], lib/NativeHal) and reports what it did.
+ *
+ *   pio run -e native
+ *   .pio/build/native/program run [options]
+ *
+ *   --payload bios|win10|chain|script   Payload to run (win10)
+ *   --profile tuned|safe|slow           Timing profile (tuned)
+ *   --eeprom FILE                       Start from this EEPROM image
+ *   --save-eeprom FILE                  Save the EEPROM image afterwards
+ *   --keys                              Print every keyboard report
+ *   --lcd                               Print every LCD frame
+ *   --pins                              Print pin edges and reads
+ *   --serial FILE                       Raw Serial output (tools/log_decode.py)
+ *   --timeline FILE                     Chrome trace-event JSON (see timeline.h)
+ *   --limit SECONDS                     Virtual time limit (1800)
+ *   --idle SECONDS                      Keep running after the payload (0)
+ *   --seed N                            Seed for random() (1)
+ *
+ *   .pio/build/native/program bench [options]    (see bench.h)
+ *   .pio/build/native/program trace [options]    (see golden_trace.h)
+ *   .pio/build/native/program setup-page [options]   (see wipe_score.h)
+ *   .pio/build/native/program bios [options]     (see bios_check.h)
+ *   .pio/build/native/program plan [options]     (see plan_keys.h)
+ *   .pio/build/native/program robust [options]   (see robust_timing.h)
+ *
+ * Without PlatformIO (from the repo root):
+ *   g++ -std=gnu++11 -O2 -pthread -DDEBUG=1 -Ilib/NativeHal -Ilib/FrameProtocol \
+ *       $(find src lib/NativeHal lib/FrameProtocol sim -name '*.cpp') -o simulator
+ */
+
+// pio test links its own main (test/test_native) against the same sources
+#ifndef PIO_UNIT_TESTING
+
+#include "bench.h"
+#include "bios_check.h"
+#include "golden_trace.h"
+#include "plan_keys.h"
+#include "robust_timing.h"
+#include "scenario.h"
+#include "sim_pc.h"
+#include "hid_names.h"
+#include "timeline.h"
+#include "wipe_score.h"
+#include "metrics.h"
+#include "../src/log_buffer.h"
+#include "../src/telemetry.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct RunOptions {
+    Scenario scenario;
+    bool keys;
+    bool lcd;
+    bool pins;
+    const char* serialPath;
+    const char* timelinePath;
+    uint32_t seed;
+};
+
+static double toMs(SimTime t) {
+    return t / 1000.0;
+}
+
+static const char* phaseText(uint8_t phase) {
+    return reinterpret_cast<const char*>(getPhaseName(phase));
+}
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator run [--payload bios|win10|chain|script] [--profile tuned|safe|slow]\n"
+        "                     [--eeprom FILE] [--save-eeprom FILE] [--keys] [--lcd] [--pins]\n"
+        "                     [--serial FILE] [--timeline FILE] [--limit SECONDS]\n"
+        "                     [--idle SECONDS] [--seed N]\n"
+        "       simulator bench [--payload P] [--profile P] [--eeprom FILE]\n"
+        "                       [--json FILE|-] [--baseline FILE] [--tolerance PCT]\n"
+        "       simulator trace --check|--update [--payload P] [--profile P] [--golden DIR]\n"
+        "                       [--tolerance-pct N] [--tolerance-ms N]\n"
+        "       simulator setup-page [--layout NAME] [--strategy S]... [--profile P]\n"
+        "                            [--dialog-ms N] [--delete-ms N] [--create-ms N]\n"
+        "                            [--show] [--list]\n"
+        "       simulator bios [--model NAME] [--profile P] [--payload bios|chain]\n"
+        "                      [--latency-scale X] [--show] [--pacing] [--list]\n"
+        "       simulator plan --ui setup|bios [--layout NAME|all]... [--model NAME|all]\n"
+        "                      [--key-gap MS] [--margin PCT] [--max-states N]\n"
+        "                      [--robust] [--script FILE] [--eeprom FILE] [--show]\n"
+        "       simulator robust [--runs N] [--target PCT] [--threads N]\n"
+        "                        [--key-ms MS] [--enter-ms MS] [--sigma X]\n"
+        "                        [--stall-pct PCT] [--stall-ms MS]\n"
+        "                        [--profile-out FILE] [--eeprom FILE]\n");
+}
+
+static bool parseOptions(int argc, char** argv, RunOptions& options) {
+    options.keys = false;
+    options.lcd = false;
+    options.pins = false;
+    options.serialPath = NULL;
+    options.timelinePath = NULL;
+    options.seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool needsValue = true;
+
+        if (strcmp(arg, "--keys") == 0) {
+            options.keys = true;
+            needsValue = false;
+        } else if (strcmp(arg, "--lcd") == 0) {
+            options.lcd = true;
+            needsValue = false;
+        } else if (strcmp(arg, "--pins") == 0) {
+            options.pins = true;
+            options.scenario.recordPinReads = true;
+            needsValue = false;
+        } else if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return false;
+        } else if (strcmp(arg, "--payload") == 0) {
+            if (!parsePayload(value, &options.scenario.payload)) {
+                fprintf(stderr, "unknown payload: %s\n", value);
+                return false;
+            }
+        } else if (strcmp(arg, "--profile") == 0) {
+            if (!parseProfile(value, &options.scenario.profile)) {
+                fprintf(stderr, "unknown profile: %s\n", value);
+                return false;
+            }
+        } else if (strcmp(arg, "--eeprom") == 0) {
+            options.scenario.eepromIn = value;
+        } else if (strcmp(arg, "--save-eeprom") == 0) {
+            options.scenario.eepromOut = value;
+        } else if (strcmp(arg, "--serial") == 0) {
+            options.serialPath = value;
+        } else if (strcmp(arg, "--timeline") == 0) {
+            options.timelinePath = value;
+        } else if (strcmp(arg, "--limit") == 0) {
+            options.scenario.limitMs = strtoul(value, NULL, 10) * 1000;
+        } else if (strcmp(arg, "--idle") == 0) {
+            options.scenario.idleMs = strtoul(value, NULL, 10) * 1000;
+        } else if (strcmp(arg, "--seed") == 0) {
+            options.seed = strtoul(value, NULL, 10);
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        }
+        if (needsValue) i++;
+    }
+    return true;
+}
+
+// ===========================================
+// Traces
+// ===========================================
+
+static void printKeys() {
+    const std::vector<SimKeyReport>& reports = simKeyReports();
+    SimKeyReport last;
+    memset(&last, 0, sizeof(last));
+    printf("\nKeyboard reports (host time):\n");
+    for (size_t i = 0; i < reports.size(); i++) {
+        printf("  %10.3f ms  %s\n", toMs(reports[i].hostAt),
+               describeReportChange(last, reports[i]).c_str());
+        last = reports[i];
+    }
+}
+
+static void printLcd() {
+    const std::vector<SimLcdFrame>& frames = simLcdFrames();
+    printf("\nLCD frames:\n");
+    for (size_t i = 0; i < frames.size(); i++) {
+        const SimLcdFrame& frame = frames[i];
+        for (uint8_t row = 0; row < frame.rows; row++) {
+            char text[21];
+            for (uint8_t col = 0; col <= frame.cols; col++) {
+                char c = frame.text[row][col];
+                // Custom glyphs as their slot number
+                text[col] = (c > 0 && c < 16) ? (char)('0' + (c & 7)) : c;
+            }
+            if (row == 0) {
+                printf("  %10.3f ms  |%s|%s\n", toMs(frame.at), text,
+                       frame.backlight ? "" : "  (backlight off)");
+            } else {
+                printf("                 |%s|\n", text);
+            }
+        }
+    }
+}
+
+static void printPins() {
+    const std::vector<SimPinEdge>& edges = simPinEdges();
+    printf("\nPin edges:\n");
+    for (size_t i = 0; i < edges.size(); i++) {
+        printf("  %10.3f ms  D%-2u -> %s%s\n", toMs(edges[i].at), edges[i].pin,
+               edges[i].level ? "HIGH" : "LOW", edges[i].external ? "  (outside)" : "");
+    }
+    const std::vector<SimPinRead>& reads = simPinReads();
+    printf("\nPin reads: %zu\n", reads.size());
+    for (size_t i = 0; i < reads.size(); i++) {
+        printf("  %10.3f ms  D%-2u = %s\n", toMs(reads[i].at), reads[i].pin,
+               reads[i].level ? "HIGH" : "LOW");
+    }
+}
+
+// ===========================================
+// Summary
+// ===========================================
+
+static void printSummary(const RunOptions& options, const RunResult& result, double wallMs) {
+    const std::vector<SimKeyReport>& reports = simKeyReports();
+    const std::vector<SimI2cTransfer>& transfers = simI2cTransfers();
+    const SimQueueStats& queues = simQueueStats();
+
+    printf("\nPayload:      %s (%s%s)\n", payloadWord(options.scenario.payload),
+           profileWord(options.scenario.profile),
+           isWiredStart(options.scenario) ? ", wired" : ", console");
+    if (!result.started) {
+        printf("Run:          never started%s\n", result.timedOut ? " (time limit)" : "");
+    } else if (!result.finished) {
+        printf("Run:          started at %.1f ms, not finished%s\n", toMs(result.runStart),
+               result.timedOut ? " (time limit)" : "");
+    } else {
+        printf("Run:          %.1f ms (%.1f -> %.1f ms)\n",
+               toMs(result.runEnd - result.runStart), toMs(result.runStart), toMs(result.runEnd));
+    }
+    printf("Virtual time: %.1f ms\n", toMs(simNow()));
+    printf("Wall time:    %.1f ms\n", wallMs);
+    printf("Key reports:  %zu (%u key presses)\n", reports.size(), countKeyPresses(reports));
+    printf("LCD frames:   %zu\n", simLcdFrames().size());
+    printf("I2C:          %zu transfers, %llu bytes\n", transfers.size(),
+           (unsigned long long)countI2cBytes(transfers));
+    printf("Waits:        %zu\n", simWaits().size());
+    printf("EEPROM:       %u byte writes\n", simEepromWrites());
+    printf("Queues:       log peak %u/%u bytes (%u dropped), %u HID waits (%.1f ms), %u CDC waits\n",
+           getLogPeak(), LOG_BUFFER_SIZE, getLogDropCount(), queues.hidWaits,
+           toMs(queues.hidWaitUs), queues.cdcWaits);
+
+    if (result.phases.empty()) return;
+    double total[RUN_PHASE_COUNT] = { 0 };
+    for (size_t i = 0; i < result.phases.size(); i++) {
+        const PhaseSpan& span = result.phases[i];
+        if (span.phase < RUN_PHASE_COUNT) total[span.phase] += toMs(span.end - span.start);
+    }
+    printf("\nPhases:\n");
+    for (uint8_t phase = 0; phase < RUN_PHASE_COUNT; phase++) {
+        if (total[phase] > 0) {
+            printf("  %-12s %10.1f ms\n", phaseText(phase), total[phase]);
+        }
+    }
+}
+
+// ===========================================
+// run
+// ===========================================
+
+static int commandRun(int argc, char** argv) {
+    RunOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    BasicPc pc;
+    simSetPc(&pc);
+    simSeedRandom(options.seed);
+
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    RunResult result = runScenario(options.scenario);
+    double wallMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - wallStart).count();
+
+    if (options.serialPath) {
+        FILE* file = fopen(options.serialPath, "wb");
+        if (!file) {
+            fprintf(stderr, "cannot write %s\n", options.serialPath);
+            return 1;
+        }
+        const std::string& output = simSerialOutput();
+        fwrite(output.data(), 1, output.size(), file);
+        fclose(file);
+    }
+    if (options.timelinePath && !writeTimeline(options.timelinePath, options.scenario, result)) {
+        fprintf(stderr, "cannot write %s\n", options.timelinePath);
+        return 1;
+    }
+
+    if (options.keys) printKeys();
+    if (options.lcd) printLcd();
+    if (options.pins) printPins();
+    printSummary(options, result, wallMs);
+    return result.finished ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    if (strcmp(argv[1], "run") == 0) return commandRun(argc - 1, argv + 1);
+    if (strcmp(argv[1], "bench") == 0) return commandBench(argc - 1, argv + 1);
+    if (strcmp(argv[1], "trace") == 0) return commandTrace(argc - 1, argv + 1);
+    if (strcmp(argv[1], "setup-page") == 0) return commandSetupPage(argc - 1, argv + 1);
+    if (strcmp(argv[1], "bios") == 0) return commandBios(argc - 1, argv + 1);
+    if (strcmp(argv[1], "plan") == 0) return commandPlan(argc - 1, argv + 1);
+    if (strcmp(argv[1], "robust") == 0) return commandRobust(argc - 1, argv + 1);
+    usage();
+    return 2;
+}
+#endif // PIO_UNIT_TESTING
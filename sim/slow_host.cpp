@@ -0,0 +1,61 @@
+/**
+ * Slow Host Target Implementation
+ */
+
+#include "slow_host.h"
+#include "hid_names.h"
+#include "../include/config.h"
+#include "../src/telemetry.h"
+#include <math.h>
+
+#define USAGE_ENTER         0x28
+
+HostLatency::HostLatency()
+    : keyMs(30), enterMs(150), sigma(0.4), stallPct(0.05), stallMs(600) {
+}
+
+SlowHostPc::SlowHostPc(const HostLatency& latency, uint32_t seed)
+    : latency(latency), random(seed), probed(false), busyUntil(0), judged(0), dropped(0) {
+}
+
+uint32_t SlowHostPc::busyFor(uint8_t usage) {
+    double median = (usage == USAGE_ENTER) ? latency.enterMs : latency.keyMs;
+    double ms = median;
+    if (latency.sigma > 0) {
+        std::lognormal_distribution<double> spread(log(median), latency.sigma);
+        ms = spread(random);
+    }
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (unit(random) * 100 < latency.stallPct) ms += unit(random) * latency.stallMs;
+    return (uint32_t)ms;
+}
+
+void SlowHostPc::onKeyReport(const SimKeyReport& report) {
+    SimTime now = simNow();
+    for (int i = 0; i < 6; i++) {
+        uint8_t usage = report.keys[i];
+        if (!usage || !isKeyPress(last, report, usage)) continue;
+
+        if (usage == USAGE_NUM_LOCK) {
+            // The LED report goes out once the host has caught up
+            probed = true;
+            leds ^= 0x01;
+            uint8_t state = leds;
+            SimTime at = (busyUntil > now ? busyUntil : now) + SIM_MS(ledLatencyMs);
+            simAt(at, [state]() { simSendOutputReport(HOST_LED_REPORT_ID, state); });
+            continue;
+        }
+        if (!probed) continue;
+
+        judged++;
+        if (now < busyUntil) {
+            if (!dropped++) {
+                first = usageName(usage) + " in " +
+                        reinterpret_cast<const char*>(getPhaseName(getRunPhase()));
+            }
+            continue;
+        }
+        busyUntil = now + SIM_MS(busyFor(usage));
+    }
+    last = report;
+}
@@ -0,0 +1,54 @@
+/**
+ * Slow Host Target
+ *
+ * A target whose response times are random, for asking how often a
+ * payload's pacing holds up across a fleet of machines. Every key
+ * press keeps the host busy for a while: a short log-normal time for
+ * navigation keys, a longer one for Enter (a screen or dialog change),
+ * and now and then a stall (disk, driver, antivirus). A key that
+ * arrives while the host is busy is dropped. The Num Lock readiness
+ * probe is answered once the host is free again.
+ *
+ * Keys before the first probe (boot spam, boot menu) are not judged:
+ * the drops that count are the ones in Windows Setup.
+ */
+
+#ifndef SLOW_HOST_H
+#define SLOW_HOST_H
+
+#include "sim_pc.h"
+#include <random>
+#include <string>
+
+struct HostLatency {
+    uint32_t keyMs;             // Median busy time after a navigation key
+    uint32_t enterMs;           // Median after Enter
+    double sigma;               // Log-normal spread of both (0 = fixed)
+    double stallPct;            // Chance per key of a stall on top
+    uint32_t stallMs;           // Longest stall (uniform up to this)
+
+    HostLatency();
+};
+
+class SlowHostPc : public BasicPc {
+public:
+    SlowHostPc(const HostLatency& latency, uint32_t seed);
+    void onKeyReport(const SimKeyReport& report);
+
+    uint32_t judgedKeys() const { return judged; }
+    uint32_t droppedKeys() const { return dropped; }
+    const std::string& firstDrop() const { return first; }     // "TAB in PARTITIONS"
+
+private:
+    uint32_t busyFor(uint8_t usage);
+
+    HostLatency latency;
+    std::mt19937 random;
+    bool probed;                // Setup is up: keys count from here on
+    SimTime busyUntil;
+    uint32_t judged;
+    uint32_t dropped;
+    std::string first;
+};
+
+#endif // SLOW_HOST_H
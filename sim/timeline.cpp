@@ -0,0 +1,220 @@
+/**
+ * Run Timeline Export Implementation
+ */
+
+#include "timeline.h"
+#include "hid_names.h"
+#include "sim_pc.h"
+#include "../src/telemetry.h"
+#include <cstdio>
+#include <cstring>
+
+// Track IDs, in the order the viewer shows them
+enum TimelineTrack {
+    TRACK_RUN = 1,
+    TRACK_PHASES,
+    TRACK_KEYS,
+    TRACK_WAITS,
+    TRACK_LCD,
+    TRACK_I2C,
+    TRACK_PINS
+};
+
+static const char* const trackNames[] = {
+    "", "run", "phases", "keys", "waits", "lcd", "i2c", "pins"
+};
+
+// ===========================================
+// JSON
+// ===========================================
+
+static std::string quoted(const std::string& text) {
+    std::string out = "\"";
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20 || c >= 0x7F) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out + "\"";
+}
+
+class EventWriter {
+public:
+    explicit EventWriter(FILE* file) : file(file), count(0) {}
+
+    // Complete event: a span on a track (times in microseconds)
+    void span(int track, const std::string& name, SimTime start, SimTime end,
+              const std::string& args = "") {
+        begin(track, name, "X", start);
+        fprintf(file, ", \"dur\": %llu", (unsigned long long)(end > start ? end - start : 0));
+        finish(args);
+    }
+
+    // Instant event: a point on a track
+    void mark(int track, const std::string& name, SimTime at, const std::string& args = "") {
+        begin(track, name, "i", at);
+        fprintf(file, ", \"s\": \"t\"");
+        finish(args);
+    }
+
+    void meta(int track, const char* name, const std::string& args) {
+        fprintf(file, "%s\n    {\"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"name\": \"%s\", \"args\": {%s}}",
+                count++ ? "," : "", track, name, args.c_str());
+    }
+
+private:
+    void begin(int track, const std::string& name, const char* type, SimTime at) {
+        fprintf(file, "%s\n    {\"ph\": \"%s\", \"pid\": 1, \"tid\": %d, \"name\": %s, \"ts\": %llu",
+                count++ ? "," : "", type, track, quoted(name).c_str(), (unsigned long long)at);
+    }
+
+    void finish(const std::string& args) {
+        if (!args.empty()) fprintf(file, ", \"args\": {%s}", args.c_str());
+        fprintf(file, "}");
+    }
+
+    FILE* file;
+    size_t count;
+};
+
+// ===========================================
+// Tracks
+// ===========================================
+
+static void writeRun(EventWriter& out, const RunResult& result) {
+    if (result.started) {
+        out.span(TRACK_RUN, "run", result.runStart, result.finished ? result.runEnd : simNow());
+    }
+    for (size_t i = 0; i < result.phases.size(); i++) {
+        const PhaseSpan& span = result.phases[i];
+        out.span(TRACK_PHASES, reinterpret_cast<const char*>(getPhaseName(span.phase)),
+                 span.start, span.end);
+    }
+}
+
+// One span per key from the report that pressed it to the one that let go
+static void writeKeys(EventWriter& out) {
+    const std::vector<SimKeyReport>& reports = simKeyReports();
+    SimTime downAt[256] = { 0 };
+    SimTime modifierAt[8] = { 0 };
+    SimKeyReport last;
+    memset(&last, 0, sizeof(last));
+
+    for (size_t r = 0; r < reports.size(); r++) {
+        const SimKeyReport& report = reports[r];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            uint8_t mask = 1 << bit;
+            if ((report.modifiers & mask) && !(last.modifiers & mask)) {
+                modifierAt[bit] = report.hostAt;
+            } else if (!(report.modifiers & mask) && (last.modifiers & mask)) {
+                out.span(TRACK_KEYS, modifierName(bit), modifierAt[bit], report.hostAt);
+            }
+        }
+        for (int i = 0; i < 6; i++) {
+            uint8_t usage = last.keys[i];
+            if (usage && isKeyPress(report, last, usage)) {
+                out.span(TRACK_KEYS, usageName(usage), downAt[usage], report.hostAt);
+            }
+        }
+        for (int i = 0; i < 6; i++) {
+            uint8_t usage = report.keys[i];
+            if (usage && isKeyPress(last, report, usage)) downAt[usage] = report.hostAt;
+        }
+        last = report;
+    }
+}
+
+static void writeWaits(EventWriter& out) {
+    const std::vector<SimWait>& waits = simWaits();
+    for (size_t i = 0; i < waits.size(); i++) {
+        // Named by length, so the viewer sums the time per delay constant
+        char name[24];
+        char args[32];
+        snprintf(name, sizeof(name), "delay(%u)", waits[i].ms);
+        snprintf(args, sizeof(args), "\"ms\": %u", waits[i].ms);
+        out.span(TRACK_WAITS, name, waits[i].start, waits[i].start + SIM_MS(waits[i].ms), args);
+    }
+}
+
+static void writeLcd(EventWriter& out) {
+    const std::vector<SimLcdFrame>& frames = simLcdFrames();
+    for (size_t i = 0; i < frames.size(); i++) {
+        const SimLcdFrame& frame = frames[i];
+        std::string args;
+        for (uint8_t row = 0; row < frame.rows; row++) {
+            std::string text;
+            for (uint8_t col = 0; col < frame.cols; col++) {
+                char c = frame.text[row][col];
+                // Custom glyphs as their slot number
+                text += (c > 0 && c < 16) ? (char)('0' + (c & 7)) : c;
+            }
+            char key[16];
+            snprintf(key, sizeof(key), "%s\"row%u\": ", row ? ", " : "", row);
+            args += key + quoted(text);
+        }
+        out.mark(TRACK_LCD, frame.backlight ? "flush" : "flush (backlight off)", frame.at, args);
+    }
+}
+
+static void writeI2c(EventWriter& out) {
+    const std::vector<SimI2cTransfer>& transfers = simI2cTransfers();
+    for (size_t i = 0; i < transfers.size(); i++) {
+        const SimI2cTransfer& transfer = transfers[i];
+        char name[16];
+        char args[48];
+        snprintf(name, sizeof(name), "0x%02X", transfer.address);
+        snprintf(args, sizeof(args), "\"bytes\": %u, \"acked\": %s",
+                 transfer.length, transfer.acked ? "true" : "false");
+        out.span(TRACK_I2C, name, transfer.start, transfer.end, args);
+    }
+}
+
+static void writePins(EventWriter& out) {
+    const std::vector<SimPinEdge>& edges = simPinEdges();
+    for (size_t i = 0; i < edges.size(); i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "D%u %s", edges[i].pin, edges[i].level ? "HIGH" : "LOW");
+        out.mark(TRACK_PINS, name, edges[i].at,
+                 edges[i].external ? "\"outside\": true" : "\"outside\": false");
+    }
+}
+
+// ===========================================
+// File
+// ===========================================
+
+bool writeTimeline(const char* path, const Scenario& scenario, const RunResult& result) {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [");
+    EventWriter out(file);
+
+    std::string process = std::string(payloadWord(scenario.payload)) + " (" +
+                          profileWord(scenario.profile) + ")";
+    out.meta(0, "process_name", "\"name\": " + quoted(process));
+    for (int track = TRACK_RUN; track <= TRACK_PINS; track++) {
+        char sort[24];
+        snprintf(sort, sizeof(sort), "\"sort_index\": %d", track);
+        out.meta(track, "thread_name", std::string("\"name\": \"") + trackNames[track] + "\"");
+        out.meta(track, "thread_sort_index", sort);
+    }
+
+    writeRun(out, result);
+    writeKeys(out);
+    writeWaits(out);
+    writeLcd(out);
+    writeI2c(out);
+    writePins(out);
+
+    fprintf(file, "\n  ]\n}\n");
+    return fclose(file) == 0;
+}
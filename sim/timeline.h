@@ -0,0 +1,25 @@
+/**
+ * Run Timeline Export
+ *
+ * Writes the SimHost records of the run that just finished as Chrome
+ * trace-event JSON, for chrome://tracing or ui.perfetto.dev. One track
+ * each for the run and its phases, the keys (press to release, host
+ * time), delay() waits, LCD flushes, I2C transfers and pin edges.
+ * Selecting a range in the viewer sums the time per name, so the share
+ * of fixed waits or of the partition sweep is one drag away.
+ *
+ *   simulator run --payload win10 --timeline win10.json
+ *
+ * tools/log_decode.py --timeline writes the same tracks (those the log
+ * has: phases, waits, events) from a device capture or journal.
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "scenario.h"
+
+// False if the file can't be written
+bool writeTimeline(const char* path, const Scenario& scenario, const RunResult& result);
+
+#endif // TIMELINE_H
@@ -0,0 +1,342 @@
+/**
+ * Wipe Strategy Scoring Implementation
+ */
+
+#include "wipe_score.h"
+#include "hid_names.h"
+#include "isolated.h"
+#include "scenario.h"
+#include "sim_pc.h"
+#include "../include/config.h"
+#include "../src/telemetry.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define USAGE_ENTER         0x28
+#define USAGE_TAB           0x2B
+#define USAGE_RIGHT         0x4F
+#define USAGE_DOWN          0x51
+#define USAGE_UP            0x52
+
+// pressKey(): press, hold, release, keyDelay - then the caller's gap
+#define PRESS_MS            (KEY_HOLD_DELAY + KEY_DELAY)
+
+struct SetupPageOptions {
+    std::string layout;         // "" = all
+    std::vector<std::string> strategies;
+    uint8_t profile;
+    SetupTiming timing;
+    bool show;
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: simulator setup-page [--layout NAME] [--strategy S]... [--profile P]\n"
+        "                            [--dialog-ms N] [--delete-ms N] [--create-ms N]\n"
+        "                            [--show] [--list]\n"
+        "       strategies: firmware, sweeps:N, down:N\n");
+}
+
+static void listLayouts() {
+    const std::vector<SetupLayout>& layouts = setupLayouts();
+    for (size_t i = 0; i < layouts.size(); i++) {
+        printf("%-12s %s\n", layouts[i].name, layouts[i].description);
+        for (size_t row = 0; row < layouts[i].rows.size(); row++) {
+            printf("             %s\n", rowName(layouts[i].rows, row).c_str());
+        }
+    }
+}
+
+// 0 = ok, 1 = done (--list), 2 = bad arguments
+static int parseOptions(int argc, char** argv, SetupPageOptions& options) {
+    options.profile = PROFILE_TUNED;
+    options.show = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--show") == 0) {
+            options.show = true;
+            continue;
+        }
+        if (strcmp(arg, "--list") == 0) {
+            listLayouts();
+            return 1;
+        }
+        const char* value = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return 2;
+        }
+        if (strcmp(arg, "--layout") == 0) {
+            if (!findSetupLayout(value)) {
+                fprintf(stderr, "unknown layout: %s (see --list)\n", value);
+                return 2;
+            }
+            options.layout = value;
+        } else if (strcmp(arg, "--strategy") == 0) {
+            options.strategies.push_back(value);
+        } else if (strcmp(arg, "--profile") == 0) {
+            if (!parseProfile(value, &options.profile)) {
+                fprintf(stderr, "unknown profile: %s\n", value);
+                return 2;
+            }
+        } else if (strcmp(arg, "--dialog-ms") == 0) {
+            options.timing.dialogMs = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--delete-ms") == 0) {
+            options.timing.deleteMs = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--create-ms") == 0) {
+            options.timing.createMs = strtoul(value, NULL, 10);
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return 2;
+        }
+    }
+    if (options.strategies.empty()) {
+        options.strategies.push_back("firmware");
+        options.strategies.push_back("sweeps:2");
+        options.strategies.push_back("down:10");
+    }
+    return 0;
+}
+
+// ===========================================
+// Strategies
+// ===========================================
+
+bool recordFirmwareKeys(uint8_t profile, KeySequence& keys) {
+    std::string text;
+    bool ok = runIsolated([profile](std::string& out) {
+        Scenario scenario;
+        scenario.payload = PAYLOAD_WIN10;
+        scenario.profile = profile;
+
+        BasicPc pc;
+        simSetPc(&pc);
+        RunResult result = runScenario(scenario);
+
+        SimTime from = 0;
+        for (size_t i = 0; i < result.phases.size(); i++) {
+            if (result.phases[i].phase == PHASE_PARTITIONS) {
+                from = result.phases[i].start;
+                break;
+            }
+        }
+        if (!from) return;
+
+        // Every new key in a report is a press; the readiness probe's
+        // Num Lock means nothing to the page
+        const std::vector<SimKeyReport>& reports = simKeyReports();
+        SimKeyReport last;
+        memset(&last, 0, sizeof(last));
+        char line[48];
+        for (size_t i = 0; i < reports.size(); i++) {
+            const SimKeyReport& report = reports[i];
+            if (report.hostAt >= from) {
+                for (int slot = 0; slot < 6; slot++) {
+                    uint8_t usage = report.keys[slot];
+                    if (!usage || usage == USAGE_NUM_LOCK || !isKeyPress(last, report, usage)) continue;
+                    snprintf(line, sizeof(line), "%u %u %llu\n", usage, report.modifiers,
+                             (unsigned long long)report.hostAt);
+                    out += line;
+                }
+            }
+            last = report;
+        }
+    }, text);
+    if (!ok) return false;
+
+    keys.clear();
+    unsigned int usage, modifiers;
+    unsigned long long at, first = 0;
+    const char* cursor = text.c_str();
+    int used;
+    while (sscanf(cursor, "%u %u %llu%n", &usage, &modifiers, &at, &used) == 3) {
+        cursor += used;
+        if (keys.empty()) first = at;
+        TimedKey key = { (uint8_t)usage, (uint8_t)modifiers, (uint32_t)((at - first) / 1000) };
+        keys.push_back(key);
+    }
+    return !keys.empty();
+}
+
+// Builds a sequence the way the firmware paces it
+struct Typist {
+    KeySequence& keys;
+    uint32_t now;
+
+    explicit Typist(KeySequence& keys) : keys(keys), now(0) { keys.clear(); }
+
+    void press(uint8_t usage, uint32_t gapMs) {
+        TimedKey key = { usage, 0, now };
+        keys.push_back(key);
+        now += PRESS_MS + gapMs;
+    }
+
+    void repeat(uint8_t usage, int times, uint32_t gapMs) {
+        for (int i = 0; i < times; i++) press(usage, gapMs);
+    }
+
+    // Tab, Right, Enter (Delete), Tab, Enter (OK)
+    void deleteAttempt() {
+        static const uint16_t click[3] = { TUNE_DELETE_CLICK };
+        static const uint16_t confirm[3] = { TUNE_DELETE_CONFIRM };
+        press(USAGE_TAB, DELETE_KEY_GAP);
+        press(USAGE_RIGHT, DELETE_KEY_GAP);
+        press(USAGE_ENTER, click[0]);
+        press(USAGE_TAB, NAV_KEY_GAP);
+        press(USAGE_ENTER, confirm[0]);
+    }
+
+    // Top, "skip header", Tab to Next, Enter, Enter
+    void startInstall() {
+        static const uint16_t installStart[3] = { TUNE_INSTALL_START };
+        repeat(USAGE_UP, 10, LIST_STEP_GAP);
+        press(USAGE_DOWN, NAV_KEY_GAP);
+        repeat(USAGE_TAB, 6, NEXT_TAB_GAP);
+        press(USAGE_ENTER, installStart[0]);
+        press(USAGE_ENTER, FINAL_ENTER_WAIT);
+    }
+};
+
+static void makeSweeps(KeySequence& keys, int sweeps) {
+    Typist typist(keys);
+    typist.repeat(USAGE_UP, 10, LIST_STEP_GAP);
+    typist.now += LIST_SETTLE;
+    typist.press(USAGE_DOWN, LIST_SETTLE);
+    for (int sweep = 0; sweep < sweeps; sweep++) {
+        bool goingDown = (sweep % 2 == 0);
+        for (int pos = 0; pos < 8; pos++) {
+            typist.deleteAttempt();
+            typist.press(goingDown ? USAGE_DOWN : USAGE_UP, NAV_KEY_GAP);
+        }
+        if (goingDown) {
+            typist.repeat(USAGE_UP, 10, LIST_FAST_GAP);
+            typist.press(USAGE_DOWN, HEADER_SKIP_GAP);
+        } else {
+            typist.repeat(USAGE_DOWN, 10, LIST_FAST_GAP);
+        }
+        typist.now += LIST_SETTLE;
+    }
+    typist.startInstall();
+}
+
+static void makeDown(KeySequence& keys, int attempts) {
+    Typist typist(keys);
+    typist.repeat(USAGE_UP, 10, LIST_STEP_GAP);
+    typist.now += LIST_SETTLE;
+    for (int i = 0; i < attempts; i++) {
+        typist.deleteAttempt();
+        typist.press(USAGE_DOWN, NAV_KEY_GAP);
+    }
+    typist.repeat(USAGE_UP, 10, LIST_STEP_GAP);
+    typist.press(USAGE_ENTER, FINAL_ENTER_WAIT);
+}
+
+bool makeStrategy(const std::string& spec, KeySequence& keys) {
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) return false;
+    std::string name = spec.substr(0, colon);
+    int count = atoi(spec.c_str() + colon + 1);
+    if (count <= 0 || count > 64) return false;
+
+    if (name == "sweeps") {
+        makeSweeps(keys, count);
+    } else if (name == "down") {
+        makeDown(keys, count);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ===========================================
+// Scoring
+// ===========================================
+
+WipeScore scoreSequence(const SetupLayout& layout, const SetupTiming& timing,
+                        const KeySequence& keys) {
+    SetupPage page(layout, timing);
+    WipeScore score;
+    score.keys = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (page.state().end != END_NONE) break;
+        page.press(keys[i].usage, keys[i].modifiers, keys[i].atMs);
+        score.keys++;
+    }
+    page.settle();
+    score.final = page.state();
+    score.outcome = judgeSetup(score.final);
+    score.doneMs = page.endedAt() ? page.endedAt() : (keys.empty() ? 0 : keys.back().atMs);
+    score.dropped = page.droppedKeys();
+    return score;
+}
+
+static void showRows(const SetupState& state) {
+    for (size_t i = 0; i < state.rows.size(); i++) {
+        bool marked = (state.end == END_INSTALL) ? (i == state.selected) : false;
+        printf("      %s %s\n", marked ? ">" : " ", rowName(state.rows, i).c_str());
+    }
+    if (state.rows.empty()) printf("        (no rows)\n");
+}
+
+// ===========================================
+// setup-page
+// ===========================================
+
+int commandSetupPage(int argc, char** argv) {
+    SetupPageOptions options;
+    int parsed = parseOptions(argc, argv, options);
+    if (parsed == 1) return 0;
+    if (parsed) {
+        usage();
+        return 2;
+    }
+
+    std::vector<KeySequence> sequences(options.strategies.size());
+    for (size_t s = 0; s < options.strategies.size(); s++) {
+        const std::string& spec = options.strategies[s];
+        bool ok = (spec == "firmware") ? recordFirmwareKeys(options.profile, sequences[s])
+                                       : makeStrategy(spec, sequences[s]);
+        if (!ok && spec == "firmware") {
+            fprintf(stderr, "firmware run produced no partition keys\n");
+            return 1;
+        }
+        if (!ok) {
+            fprintf(stderr, "unknown strategy: %s\n", spec.c_str());
+            usage();
+            return 2;
+        }
+    }
+
+    printf("Timing: dialog %u ms, delete %u ms, create %u ms\n\n", options.timing.dialogMs,
+           options.timing.deleteMs, options.timing.createMs);
+    printf("%-12s %-10s %-6s %6s %9s %4s %4s %4s %4s  %s\n", "layout", "strategy", "result",
+           "keys", "ms", "del", "coll", "new", "lost", "verdict");
+
+    const std::vector<SetupLayout>& layouts = setupLayouts();
+    int correct[16] = { 0 };
+    int tried = 0;
+    for (size_t l = 0; l < layouts.size(); l++) {
+        if (!options.layout.empty() && options.layout != layouts[l].name) continue;
+        tried++;
+        for (size_t s = 0; s < options.strategies.size(); s++) {
+            WipeScore score = scoreSequence(layouts[l], options.timing, sequences[s]);
+            int deleted = 0;
+            for (int d = 0; d < 4; d++) deleted += score.final.deleted[d];
+            printf("%-12s %-10s %-6s %6u %9u %4d %4u %4u %4u  %s\n", layouts[l].name,
+                   options.strategies[s].c_str(), score.outcome.correct ? "ok" : "FAIL",
+                   score.keys, score.doneMs, deleted, score.outcome.collateral,
+                   score.final.created, score.dropped, score.outcome.verdict.c_str());
+            if (options.show) showRows(score.final);
+            if (score.outcome.correct && s < 16) correct[s]++;
+        }
+    }
+
+    printf("\n");
+    for (size_t s = 0; s < options.strategies.size() && s < 16; s++) {
+        printf("%-10s %d/%d layouts, %zu keys typed\n", options.strategies[s].c_str(),
+               correct[s], tried, sequences[s].size());
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * Wipe Strategy Scoring
+ *
+ * Plays key sequences against the Setup disk page model (setup_page.h)
+ * on every layout and scores them: did disk 0 end up empty with the
+ * install started on it, how many keys, how long, what else got hit.
+ *
+ *   simulator setup-page [--layout NAME] [--strategy S]... [--profile P]
+ *                        [--dialog-ms N] [--delete-ms N] [--create-ms N]
+ *                        [--show] [--list]
+ *
+ * Strategies:
+ *   firmware     What the firmware really types from the partition
+ *                phase on (recorded from a win10 run, --profile)
+ *   sweeps:N     The firmware's sweep structure with N sweeps
+ *   down:N       N delete attempts going down from the top, then Next
+ *                on the top row
+ *
+ * Times are page time: 0 is the firmware's first key on the page.
+ */
+
+#ifndef WIPE_SCORE_H
+#define WIPE_SCORE_H
+
+#include "setup_page.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct TimedKey {
+    uint8_t usage;
+    uint8_t modifiers;
+    uint32_t atMs;              // Press reaches the page
+};
+
+typedef std::vector<TimedKey> KeySequence;
+
+struct WipeScore {
+    SetupOutcome outcome;
+    SetupState final;
+    uint32_t keys;
+    uint32_t doneMs;            // Install started (or the last key)
+    uint32_t dropped;           // Keys typed while the page was busy
+};
+
+// Key presses of a firmware win10 run from the partition phase on
+bool recordFirmwareKeys(uint8_t profile, KeySequence& keys);
+
+// A generated strategy ("sweeps:4", "down:12"); false if unknown
+bool makeStrategy(const std::string& spec, KeySequence& keys);
+
+WipeScore scoreSequence(const SetupLayout& layout, const SetupTiming& timing,
+                        const KeySequence& keys);
+
+int commandSetupPage(int argc, char** argv);
+
+#endif // WIPE_SCORE_H
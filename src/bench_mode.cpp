@@ -0,0 +1,180 @@
+/**
+ * Bench Mode Implementation
+ */
+
+#include "bench_mode.h"
+#include "display.h"
+#include <Keyboard.h>
+#include <Wire.h>
+
+struct BenchStats {
+    uint16_t samples;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t totalUs;
+};
+
+static void resetStats(BenchStats& stats) {
+    stats.samples = 0;
+    stats.minUs = 0xFFFFFFFFUL;
+    stats.maxUs = 0;
+    stats.totalUs = 0;
+}
+
+static void addSample(BenchStats& stats, uint32_t us) {
+    stats.samples++;
+    stats.totalUs += us;
+    if (us < stats.minUs) stats.minUs = us;
+    if (us > stats.maxUs) stats.maxUs = us;
+}
+
+static void printStats(const __FlashStringHelper* name, const BenchStats& stats) {
+    Serial.print(F("BENCH,"));
+    Serial.print(name);
+    Serial.print(',');
+    Serial.print(stats.samples);
+    Serial.print(',');
+    Serial.print(stats.samples ? stats.minUs : 0);
+    Serial.print(',');
+    Serial.print(stats.samples ? stats.totalUs / stats.samples : 0);
+    Serial.print(',');
+    Serial.println(stats.maxUs);
+}
+
+// Empty keyboard reports: the host sees "no keys down", nothing is typed
+static void benchHidReports() {
+    BenchStats stats;
+    resetStats(stats);
+    Keyboard.begin();
+    delay(500);
+
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < BENCH_HID_REPORTS; i++) {
+        unsigned long t = micros();
+        Keyboard.releaseAll();      // Sends one report, blocks until the endpoint takes it
+        addSample(stats, micros() - t);
+    }
+    unsigned long elapsed = micros() - start;
+
+    printStats(F("hid_report_send"), stats);
+    Serial.print(F("BENCH,hid_throughput,"));
+    Serial.print(BENCH_HID_REPORTS);
+    Serial.print(',');
+    Serial.println(elapsed ? (uint32_t)BENCH_HID_REPORTS * 1000000UL / elapsed : 0);
+}
+
+static void benchLcd(bool lcdAvailable) {
+    if (!lcdAvailable) {
+        Serial.println(F("BENCH,lcd,0,0,0,0"));
+        return;
+    }
+
+    BenchStats full;
+    BenchStats partial;
+    resetStats(full);
+    resetStats(partial);
+    LiquidCrystal_I2C& lcd = getLCD();
+
+    for (uint8_t i = 0; i < BENCH_LCD_SAMPLES; i++) {
+        unsigned long t = micros();
+        showStatus(F("BENCH MODE"), F("Full redraw"));
+        addSample(full, micros() - t);
+
+        // Countdown-style update: cursor move + 3 characters
+        t = micros();
+        lcd.setCursor(13, 1);
+        lcd.print(i % 10);
+        lcd.print(i % 10);
+        lcd.print(F("s"));
+        addSample(partial, micros() - t);
+    }
+
+    printStats(F("lcd_full_redraw"), full);
+    printStats(F("lcd_partial_update"), partial);
+}
+
+static void benchWire() {
+    BenchStats stats;
+    resetStats(stats);
+
+    for (uint16_t i = 0; i < BENCH_WIRE_SAMPLES; i++) {
+        unsigned long t = micros();
+        Wire.beginTransmission(LCD_ADDRESS);
+        Wire.endTransmission();
+        addSample(stats, micros() - t);
+    }
+
+    printStats(F("wire_address_probe"), stats);
+}
+
+static void benchDigitalRead() {
+    // Too fast for micros() one at a time - time a block and divide
+    const uint16_t reads = 1000;
+    BenchStats stats;
+    resetStats(stats);
+    volatile uint8_t sink = 0;
+
+    for (uint8_t block = 0; block < 10; block++) {
+        unsigned long t = micros();
+        for (uint16_t i = 0; i < reads; i++) {
+            sink += digitalRead(ARM_BUTTON_PIN);
+        }
+        // Nanoseconds per read, reported in the us columns
+        addSample(stats, (micros() - t) * 1000UL / reads);
+    }
+    (void)sink;
+
+    printStats(F("digital_read_ns"), stats);
+}
+
+static void benchDelayJitter(uint16_t ms, const __FlashStringHelper* name) {
+    BenchStats stats;
+    resetStats(stats);
+
+    for (uint8_t i = 0; i < BENCH_DELAY_SAMPLES; i++) {
+        unsigned long t = micros();
+        delay(ms);
+        addSample(stats, micros() - t);
+    }
+
+    printStats(name, stats);
+}
+
+void runBenchMode() {
+    pinMode(LED_PIN, OUTPUT);
+
+    // Results are useless without someone reading them
+    while (!Serial) {
+        digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+        delay(100);
+    }
+    delay(500);
+
+    bool lcdAvailable = initDisplay();
+    if (lcdAvailable) {
+        showStatus(F("BENCH MODE"), F("Running..."));
+    }
+
+    Serial.println(F("BENCH,begin"));
+    Serial.println(F("BENCH,name,samples,min_us,avg_us,max_us"));
+
+    benchHidReports();
+    benchLcd(lcdAvailable);
+    benchWire();
+    benchDigitalRead();
+    benchDelayJitter(1, F("delay_1ms"));
+    benchDelayJitter(10, F("delay_10ms"));
+
+    Serial.println(F("BENCH,end"));
+
+    if (lcdAvailable) {
+        showStatus(F("BENCH MODE"), F("Done-see Serial"));
+    }
+
+    while (true) {
+        digitalWrite(LED_PIN, HIGH);
+        delay(1000);
+        digitalWrite(LED_PIN, LOW);
+        delay(1000);
+    }
+}
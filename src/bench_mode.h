@@ -0,0 +1,22 @@
+/**
+ * Bench Mode
+ *
+ * Measures the hardware costs the payload timing is built on and
+ * prints them as machine-readable lines:
+ *   BENCH,<name>,<samples>,<min_us>,<avg_us>,<max_us>
+ *   BENCH,hid_throughput,<reports>,<reports_per_s>
+ * Covers HID report sends (empty reports - nothing is typed), full and
+ * partial LCD redraws, an I2C address probe, digitalRead() and the
+ * jitter of delay(1)/delay(10). Enable with BENCH_MODE in config.h.
+ */
+
+#ifndef BENCH_MODE_H
+#define BENCH_MODE_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Run all benchmarks once, then blink forever (never returns)
+void runBenchMode();
+
+#endif // BENCH_MODE_H
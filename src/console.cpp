@@ -0,0 +1,398 @@
+/**
+ * Serial Command Console Implementation
+ */
+
+#include "console.h"
+#include "display.h"
+#include "key_script.h"
+#include "log_buffer.h"
+#include "serial_link.h"
+#include "stack_monitor.h"
+#include "telemetry.h"
+#include "timing_config.h"
+#include <FrameProtocol.h>
+
+#if CONSOLE_ENABLED
+
+static char line[CONSOLE_LINE_MAX + 1];
+static uint8_t lineLength = 0;
+static bool lineOverflow = false;
+
+// Choice for the next console run (0xFF = same as the last run)
+static uint8_t choicePayload = 0xFF;
+static uint8_t choiceProfile = 0xFF;
+
+static uint16_t armToken = 0;           // 0 = not armed
+static unsigned long armedAt = 0;
+static bool runQueued = false;
+
+static bool attached = false;           // A command line arrived since boot
+static bool singleStep = false;
+static bool paused = false;
+static bool stepGranted = false;
+static bool skipRequested = false;
+static bool abortRequested = false;
+
+// Console words for payloads and profiles, in PAYLOAD_* / PROFILE_* order
+static const char wordBios[] PROGMEM = "bios";
+static const char wordWin10[] PROGMEM = "win10";
+static const char wordChain[] PROGMEM = "chain";
+static const char wordScript[] PROGMEM = "script";
+
+static const char* const payloadWords[PAYLOAD_COUNT] PROGMEM = {
+    wordBios, wordWin10, wordChain, wordScript
+};
+
+static const char wordTuned[] PROGMEM = "tuned";
+static const char wordSafe[] PROGMEM = "safe";
+static const char wordSlow[] PROGMEM = "slow";
+
+static const char* const profileWords[PROFILE_COUNT] PROGMEM = {
+    wordTuned, wordSafe, wordSlow
+};
+
+static bool isD7Removed() {
+    return digitalRead(ARM_BUTTON_PIN) == HIGH;
+}
+
+static bool isRunning() {
+    return getLinkState() == FRAME_STATE_RUNNING;
+}
+
+// Index of word in a PROGMEM table, or 0xFF
+static uint8_t findWord(const char* word, const char* const* table, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp_P(word, (const char*)pgm_read_word(&table[i])) == 0) return i;
+    }
+    return 0xFF;
+}
+
+static void printWord(const char* const* table, uint8_t index) {
+    if (index == 0xFF) {
+        Log.print(F("last"));
+    } else {
+        Log.print((const __FlashStringHelper*)pgm_read_word(&table[index]));
+    }
+}
+
+// Live keystrokes need the safety wire out, every time
+static bool checkD7(const __FlashStringHelper* what) {
+    if (isD7Removed()) return true;
+    Log.print(F("ERR D7 connected - remove it to "));
+    Log.println(what);
+    return false;
+}
+
+static void printHelp() {
+    Log.println(F("status               state, wires, choice"));
+    Log.println(F("payload bios|win10|chain|script"));
+    Log.println(F("profile tuned|safe|slow"));
+    Log.println(F("single on|off        pause before each phase"));
+    Log.println(F("arm                  get a go token"));
+    Log.println(F("go <token>           run (D7 must be removed)"));
+    Log.println(F("next / cont          step one phase / run on"));
+    Log.println(F("skip                 end the current wait"));
+    Log.println(F("abort                stop the run, no more keys"));
+    Log.println(F("get [name]           timing config"));
+    Log.println(F("set <name> <ms>      change and save"));
+    Log.println(F("defaults             timing back to config.h"));
+    #if TEACH_ENABLED
+    Log.println(F("teach                record a key script live"));
+    #endif
+    Log.println(F("script               list the taught script"));
+}
+
+static void printStatus() {
+    Log.print(F("status state="));
+    switch (getLinkState()) {
+        case FRAME_STATE_RUNNING: Log.print(paused ? F("paused") : F("running")); break;
+        case FRAME_STATE_DONE:    Log.print(F("idle")); break;
+        default:                  Log.print(F("safe")); break;
+    }
+    uint8_t phase = getRunPhase();
+    Log.print(F(" phase="));
+    if (phase < RUN_PHASE_COUNT) {
+        Log.print(getPhaseName(phase));
+    } else {
+        Log.print(F("-"));
+    }
+    Log.print(F(" d7="));
+    Log.print(isD7Removed() ? F("out") : F("in"));
+    Log.print(F(" d10="));
+    Log.print(digitalRead(MODE_SELECT_PIN) == HIGH ? F("out") : F("in"));
+    Log.print(F(" payload="));
+    printWord(payloadWords, choicePayload);
+    Log.print(F(" profile="));
+    printWord(profileWords, choiceProfile);
+    Log.print(F(" single="));
+    Log.print(singleStep ? F("on") : F("off"));
+    Log.print(F(" armed="));
+    Log.print(armToken ? F("yes") : F("no"));
+    Log.print(F(" runs="));
+    Log.print(getRunCount());
+    Log.print(F(" free="));
+    Log.println(getFreeRamNow());
+}
+
+static void commandArm() {
+    if (isRunning()) {
+        Log.println(F("ERR run in progress"));
+        return;
+    }
+    if (!checkD7(F("arm"))) return;
+
+    // Timing of the keystroke that sent "arm" is random enough here
+    armToken = 1000 + (uint16_t)((micros() ^ (millis() << 3)) % 9000);
+    armedAt = millis();
+    Log.print(F("OK type: go "));
+    Log.print(armToken);
+    Log.print(F(" (valid "));
+    Log.print(CONSOLE_ARM_TIMEOUT / 1000);
+    Log.println(F("s)"));
+}
+
+static void commandGo(const char* arg) {
+    uint16_t token = armToken;
+    armToken = 0;       // One try per token
+
+    if (isRunning()) {
+        Log.println(F("ERR run in progress"));
+        return;
+    }
+    if (token == 0 || millis() - armedAt > CONSOLE_ARM_TIMEOUT) {
+        Log.println(F("ERR not armed - send arm first"));
+        return;
+    }
+    if (arg == NULL || (uint16_t)atoi(arg) != token) {
+        Log.println(F("ERR wrong token - disarmed"));
+        return;
+    }
+    if (!checkD7(F("run"))) return;
+
+    runQueued = true;
+    Log.println(F("OK running"));
+}
+
+static void commandStep(bool keepStepping) {
+    if (!paused) {
+        Log.println(F("ERR not paused"));
+        return;
+    }
+    if (!checkD7(keepStepping ? F("step") : F("continue"))) return;
+    if (!keepStepping) singleStep = false;
+    stepGranted = true;
+    Log.println(F("OK"));
+}
+
+static void runLine() {
+    char* command = strtok(line, " ");
+    char* arg = strtok(NULL, " ");
+    if (command == NULL) return;
+
+    if (strcmp_P(command, PSTR("help")) == 0) {
+        printHelp();
+    } else if (strcmp_P(command, PSTR("status")) == 0) {
+        printStatus();
+    } else if (strcmp_P(command, PSTR("payload")) == 0 ||
+               strcmp_P(command, PSTR("profile")) == 0) {
+        bool isPayload = (command[1] == 'a');
+        uint8_t choice = (arg == NULL) ? 0xFF :
+            isPayload ? findWord(arg, payloadWords, PAYLOAD_COUNT)
+                      : findWord(arg, profileWords, PROFILE_COUNT);
+        if (choice == 0xFF) {
+            Log.println(F("ERR unknown choice"));
+        } else if (isRunning()) {
+            Log.println(F("ERR run in progress"));
+        } else {
+            if (isPayload) choicePayload = choice;
+            else choiceProfile = choice;
+            armToken = 0;   // Confirm what will actually run
+            Log.println(F("OK"));
+        }
+    } else if (strcmp_P(command, PSTR("single")) == 0) {
+        singleStep = (arg != NULL && strcmp_P(arg, PSTR("on")) == 0);
+        Log.println(singleStep ? F("OK single on") : F("OK single off"));
+    } else if (strcmp_P(command, PSTR("arm")) == 0) {
+        commandArm();
+    } else if (strcmp_P(command, PSTR("go")) == 0) {
+        commandGo(arg);
+    } else if (strcmp_P(command, PSTR("next")) == 0) {
+        commandStep(true);
+    } else if (strcmp_P(command, PSTR("cont")) == 0) {
+        commandStep(false);
+    } else if (strcmp_P(command, PSTR("skip")) == 0) {
+        if (isRunning()) {
+            skipRequested = true;
+            Log.println(F("OK"));
+        } else {
+            Log.println(F("ERR no run"));
+        }
+    } else if (strcmp_P(command, PSTR("get")) == 0) {
+        if (arg == NULL) {
+            printTimingConfig();
+        } else if (findTimingField(arg) < 0) {
+            Log.println(F("ERR unknown name (get lists them)"));
+        } else {
+            printTimingField(findTimingField(arg));
+        }
+    } else if (strcmp_P(command, PSTR("set")) == 0) {
+        char* value = strtok(NULL, " ");
+        int8_t field = (arg != NULL) ? findTimingField(arg) : -1;
+        if (field < 0 || value == NULL) {
+            Log.println(F("ERR set <name> <value>"));
+        } else if (isRunning()) {
+            Log.println(F("ERR run in progress"));
+        } else {
+            setTimingValue(field, strtoul(value, NULL, 10));
+            Log.print(F("OK "));
+            printTimingField(field);
+        }
+    } else if (strcmp_P(command, PSTR("defaults")) == 0) {
+        if (isRunning()) {
+            Log.println(F("ERR run in progress"));
+        } else {
+            resetTimingConfig();
+            Log.println(F("OK timing defaults"));
+        }
+    #if TEACH_ENABLED
+    } else if (strcmp_P(command, PSTR("teach")) == 0) {
+        if (isRunning()) {
+            Log.println(F("ERR run in progress"));
+        } else if (checkD7(F("teach"))) {
+            beginConsoleRun();      // Clears a leftover abort - keys go out live
+            beginTeach();
+        }
+    #endif
+    } else if (strcmp_P(command, PSTR("script")) == 0) {
+        printKeyScript();
+    } else if (strcmp_P(command, PSTR("abort")) == 0) {
+        armToken = 0;
+        runQueued = false;
+        if (isRunning()) abortRequested = true;
+        Log.println(F("OK aborted"));
+    } else {
+        Log.println(F("ERR unknown command (help)"));
+    }
+}
+
+#endif // CONSOLE_ENABLED
+
+void consoleInput(char c) {
+    #if CONSOLE_ENABLED
+    if (c == '\r' || c == '\n') {
+        if (lineOverflow) {
+            Log.println(F("ERR line too long"));
+        } else if (lineLength > 0) {
+            line[lineLength] = '\0';
+            attached = true;
+            if (isTeaching()) {
+                teachLine(line);
+            } else {
+                runLine();
+            }
+        }
+        lineLength = 0;
+        lineOverflow = false;
+        return;
+    }
+
+    if (c == '\b' || c == 0x7F) {
+        if (lineLength > 0) lineLength--;
+        return;
+    }
+
+    // Capital letter on an empty line: one-letter telemetry command.
+    // Not while a run is live - a dump would hold up the keystrokes.
+    if (lineLength == 0 && c >= 'A' && c <= 'Z') {
+        if (!isRunning()) handleTelemetryCommand(c);
+        return;
+    }
+
+    if (lineLength < CONSOLE_LINE_MAX) {
+        line[lineLength++] = c;
+    } else {
+        lineOverflow = true;
+    }
+    #else
+    handleTelemetryCommand(c);
+    #endif
+}
+
+bool takeConsoleRun(uint8_t* payload, uint8_t* profile) {
+    #if CONSOLE_ENABLED
+    if (!runQueued) return false;
+    runQueued = false;
+
+    // The wire may have gone back in since "go"
+    if (!checkD7(F("run"))) return false;
+
+    if (choicePayload != 0xFF) *payload = choicePayload;
+    if (choiceProfile != 0xFF) *profile = choiceProfile;
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+void beginConsoleRun() {
+    #if CONSOLE_ENABLED
+    armToken = 0;
+    runQueued = false;
+    skipRequested = false;
+    abortRequested = false;
+    #endif
+}
+
+bool consoleStep(uint8_t phase) {
+    #if CONSOLE_ENABLED
+    pollSerialLink();
+    skipRequested = false;      // A skip only reaches the waits of its own phase
+    if (abortRequested) return false;
+    if (!singleStep) return true;
+
+    Log.print(F("STEP paused before "));
+    Log.print(getPhaseName(phase));
+    Log.println(F(" - next / cont / abort"));
+    showStatus(F("STEP PAUSED"), F("Serial: next"));
+
+    paused = true;
+    stepGranted = false;
+    while (!stepGranted && !abortRequested) {
+        pollSerialLink();
+        delay(20);
+    }
+    paused = false;
+    return !abortRequested;
+    #else
+    (void)phase;
+    return true;
+    #endif
+}
+
+ConsoleWaitEvent pollConsoleWait() {
+    #if CONSOLE_ENABLED
+    pollSerialLink();
+    if (abortRequested) return CONSOLE_WAIT_ABORT;
+    if (skipRequested) {
+        skipRequested = false;
+        return CONSOLE_WAIT_SKIP;
+    }
+    #endif
+    return CONSOLE_WAIT_NONE;
+}
+
+bool isRunAborted() {
+    #if CONSOLE_ENABLED
+    return abortRequested;
+    #else
+    return false;
+    #endif
+}
+
+bool isConsoleAttached() {
+    #if CONSOLE_ENABLED
+    return attached;
+    #else
+    return false;
+    #endif
+}
@@ -0,0 +1,51 @@
+/**
+ * Serial Command Console
+ *
+ * Line commands on the USB Serial port for bench testing: pick a
+ * payload and profile, arm with a one-time confirmation token and run
+ * again without rewiring or rebooting. During a run the console can
+ * single-step phase by phase, skip a wait or abort. Nothing is typed
+ * on the target while D7 is connected - "go", "next" and "cont" all
+ * check the wire first.
+ *
+ * Commands are lowercase words ending in a newline. A capital letter
+ * at the start of a line is still the one-letter telemetry command.
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+enum ConsoleWaitEvent {
+    CONSOLE_WAIT_NONE = 0,
+    CONSOLE_WAIT_SKIP,      // "skip": end this wait now
+    CONSOLE_WAIT_ABORT      // "abort": end this wait, the run is stopping
+};
+
+// One byte of Serial text (everything outside binary frames)
+void consoleInput(char c);
+
+// While idle after a run: true once a confirmed "go" wants a new run.
+// payload/profile are set to the console's choice (left as they are
+// if none was picked, i.e. the last run's).
+bool takeConsoleRun(uint8_t* payload, uint8_t* profile);
+
+// A run is starting: clear skip/abort left over from the last one
+void beginConsoleRun();
+
+// Top of each phase: reads Serial and, in single-step mode, waits for
+// "next". Returns false once the run was aborted.
+bool consoleStep(uint8_t phase);
+
+// Inside wait loops: reads Serial and reports skip/abort
+ConsoleWaitEvent pollConsoleWait();
+
+// True after "abort" until the next run starts (no more keys are sent)
+bool isRunAborted();
+
+// True once any command line arrived: a terminal is driving the device
+bool isConsoleAttached();
+
+#endif // CONSOLE_H
@@ -3,6 +3,8 @@
  */
 
 #include "display.h"
+#include "log_buffer.h"
+#include "probes.h"
 #include <Wire.h>
 
 // LCD instance (address, columns, rows)
@@ -84,12 +86,16 @@ LiquidCrystal_I2C& getLCD() {
     return lcd;
 }
 
-void showStatus(const char* line1, const char* line2) {
+void showStatus(const __FlashStringHelper* line1, const __FlashStringHelper* line2) {
+    PROBE_BEGIN(PROBE_SHOW_STATUS);
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.print(line1);
+    PROBE_BEGIN(PROBE_LCD_COMMAND);
     lcd.setCursor(0, 1);
+    PROBE_END(PROBE_LCD_COMMAND);
     lcd.print(line2);
+    PROBE_END(PROBE_SHOW_STATUS);
     
     DEBUG_PRINT(F("LCD: "));
     DEBUG_PRINT(line1);
@@ -97,22 +103,22 @@ void showStatus(const char* line1, const char* line2) {
     DEBUG_PRINTLN(line2);
 }
 
-void showProgress(int current, int total, const char* title, const char* message) {
+void showProgress(int current, int total, const __FlashStringHelper* title, const __FlashStringHelper* message) {
     lcd.clear();
     
     // Line 1: Title with progress counter
     lcd.setCursor(0, 0);
     lcd.print(title);
-    lcd.print(" [");
+    lcd.print(F(" ["));
     lcd.print(current);
-    lcd.print("/");
+    lcd.print(F("/"));
     lcd.print(total);
-    lcd.print("]");
+    lcd.print(F("]"));
     
     // Line 2: Message
     lcd.setCursor(0, 1);
     lcd.write(0);  // Arrow character
-    lcd.print(" ");
+    lcd.print(F(" "));
     lcd.print(message);
     
     DEBUG_PRINT(F("Progress: "));
@@ -123,7 +129,7 @@ void showProgress(int current, int total, const char* title, const char* message
     DEBUG_PRINTLN(message);
 }
 
-void showCountdown(const char* title, const char* prefix, int seconds) {
+void showCountdown(const __FlashStringHelper* title, const __FlashStringHelper* prefix, int seconds) {
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.print(title);
@@ -131,12 +137,12 @@ void showCountdown(const char* title, const char* prefix, int seconds) {
     for (int i = seconds; i > 0; i--) {
         lcd.setCursor(0, 1);
         lcd.print(prefix);
-        lcd.print(" ");
+        lcd.print(F(" "));
         
         // Right-align the countdown
-        if (i < 10) lcd.print(" ");
+        if (i < 10) lcd.print(F(" "));
         lcd.print(i);
-        lcd.print("s   ");  // Extra spaces to clear old digits
+        lcd.print(F("s   "));  // Extra spaces to clear old digits
         
         delay(1000);
     }
@@ -146,20 +152,20 @@ void showComplete() {
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.write(1);  // Checkmark
-    lcd.print(" COMPLETE ");
+    lcd.print(F(" COMPLETE "));
     lcd.write(1);  // Checkmark
     
     lcd.setCursor(0, 1);
-    lcd.print("Installing Win!");
+    lcd.print(F("Installing Win!"));
     
     DEBUG_PRINTLN(F("=== COMPLETE ==="));
 }
 
-void showError(const char* message) {
+void showError(const __FlashStringHelper* message) {
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.write(2);  // Warning
-    lcd.print(" ERROR ");
+    lcd.print(F(" ERROR "));
     lcd.write(2);  // Warning
     
     lcd.setCursor(0, 1);
@@ -169,7 +175,7 @@ void showError(const char* message) {
     DEBUG_PRINTLN(message);
 }
 
-void showError(const char* codeLine, const char* detailLine) {
+void showError(const __FlashStringHelper* codeLine, const __FlashStringHelper* detailLine) {
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.write(2);  // Warning
@@ -192,10 +198,10 @@ bool isLCDConnected() {
 void showSafeMode() {
     lcd.clear();
     lcd.setCursor(0, 0);
-    lcd.print("  SAFE MODE");
+    lcd.print(F("  SAFE MODE"));
     
     lcd.setCursor(0, 1);
-    lcd.print("Switch is OFF");
+    lcd.print(F("Switch is OFF"));
     
     DEBUG_PRINTLN(F("Safe mode - switch is OFF"));
 }
@@ -203,9 +209,9 @@ void showSafeMode() {
 void showScanMode() {
     lcd.clear();
     lcd.setCursor(0, 0);
-    lcd.print("I2C SCAN MODE");
+    lcd.print(F("I2C SCAN MODE"));
     lcd.setCursor(0, 1);
-    lcd.print("Check Serial...");
+    lcd.print(F("Check Serial..."));
 }
 
 void flashDisplay(int times, int delayMs) {
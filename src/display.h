@@ -18,23 +18,24 @@ bool initDisplay();
 // Get LCD instance for direct access
 LiquidCrystal_I2C& getLCD();
 
-// Clear display and show two lines of text
-void showStatus(const char* line1, const char* line2);
+// Clear display and show two lines of text. Text arguments are F()
+// strings throughout this module: literals left in RAM cost SRAM on AVR.
+void showStatus(const __FlashStringHelper* line1, const __FlashStringHelper* line2);
 
 // Show progress with step counter (e.g., "SETUP [2/5]")
-void showProgress(int current, int total, const char* title, const char* message);
+void showProgress(int current, int total, const __FlashStringHelper* title, const __FlashStringHelper* message);
 
 // Show countdown timer (updates in place)
-void showCountdown(const char* title, const char* prefix, int seconds);
+void showCountdown(const __FlashStringHelper* title, const __FlashStringHelper* prefix, int seconds);
 
 // Show completion screen
 void showComplete();
 
 // Show error message (single line)
-void showError(const char* message);
+void showError(const __FlashStringHelper* message);
 
 // Show error with code and detail (two lines)
-void showError(const char* codeLine, const char* detailLine);
+void showError(const __FlashStringHelper* codeLine, const __FlashStringHelper* detailLine);
 
 // Check if LCD is responding
 bool isLCDConnected();
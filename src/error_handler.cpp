@@ -3,6 +3,8 @@
  */
 
 #include "error_handler.h"
+#include "log_buffer.h"
+#include "log_tokens.h"
 #include "display.h"
 #include <Wire.h>
 
@@ -14,77 +16,77 @@ ErrorInfo getErrorInfo(ErrorCode code) {
     
     switch (code) {
         case ERR_NONE:
-            info.shortMsg = "NO ERROR";
-            info.detailMsg = "All OK";
+            info.shortMsg = F("NO ERROR");
+            info.detailMsg = F("All OK");
             info.ledBlinks = 0;
             break;
             
         // Hardware Errors
         case ERR_LCD_NOT_FOUND:
-            info.shortMsg = "E01:LCD MISSING";
-            info.detailMsg = "Check I2C wiring";
+            info.shortMsg = F("E01:LCD MISSING");
+            info.detailMsg = F("Check I2C wiring");
             info.ledBlinks = 1;
             break;
             
         case ERR_LCD_INIT_FAILED:
-            info.shortMsg = "E02:LCD FAILED";
-            info.detailMsg = "Wrong address?";
+            info.shortMsg = F("E02:LCD FAILED");
+            info.detailMsg = F("Wrong address?");
             info.ledBlinks = 2;
             break;
             
         case ERR_I2C_BUS_ERROR:
-            info.shortMsg = "E03:I2C ERROR";
-            info.detailMsg = "SDA/SCL wiring";
+            info.shortMsg = F("E03:I2C ERROR");
+            info.detailMsg = F("SDA/SCL wiring");
             info.ledBlinks = 3;
             break;
             
         case ERR_KEYBOARD_INIT:
-            info.shortMsg = "E04:USB ERROR";
-            info.detailMsg = "HID init failed";
+            info.shortMsg = F("E04:USB ERROR");
+            info.detailMsg = F("HID init failed");
             info.ledBlinks = 4;
             break;
             
         // Wiring Errors
         case ERR_SWITCH_FLOATING:
-            info.shortMsg = "E10:BAD BUTTON";
-            info.detailMsg = "Pin floating";
+            info.shortMsg = F("E10:BAD BUTTON");
+            info.detailMsg = F("Pin floating");
             info.ledBlinks = 10;
             break;
             
         case ERR_NO_PULLUP:
-            info.shortMsg = "E11:NO PULLUP";
-            info.detailMsg = "Check pin 7";
+            info.shortMsg = F("E11:NO PULLUP");
+            info.detailMsg = F("Check pin 7");
             info.ledBlinks = 11;
             break;
             
         // Runtime Errors
         case ERR_BOOT_TIMEOUT:
-            info.shortMsg = "E20:BOOT FAIL";
-            info.detailMsg = "No boot menu";
+            info.shortMsg = F("E20:BOOT FAIL");
+            info.detailMsg = F("No boot menu");
             info.ledBlinks = 20;
             break;
             
         case ERR_SETUP_TIMEOUT:
-            info.shortMsg = "E21:SETUP FAIL";
-            info.detailMsg = "Win not loaded";
+            info.shortMsg = F("E21:SETUP FAIL");
+            info.detailMsg = F("Win not loaded");
             info.ledBlinks = 21;
             break;
             
         case ERR_PARTITION_FAILED:
-            info.shortMsg = "E22:WIPE FAIL";
-            info.detailMsg = "Partition error";
+            info.shortMsg = F("E22:WIPE FAIL");
+            info.detailMsg = F("Partition error");
             info.ledBlinks = 22;
             break;
             
         case ERR_INSTALL_FAILED:
-            info.shortMsg = "E23:INSTALL ERR";
-            info.detailMsg = "Didn't start";
+            info.shortMsg = F("E23:INSTALL ERR");
+            info.detailMsg = F("Didn't start");
             info.ledBlinks = 23;
             break;
             
         default:
-            info.shortMsg = "E99:UNKNOWN";
-            info.detailMsg = "Unknown error";
+            info.shortMsg = F("E99:UNKNOWN");
+            info.detailMsg = F("Unknown error");
             info.ledBlinks = 99;
             break;
     }
@@ -193,17 +195,18 @@ void blinkErrorPattern(int errorNum) {
 
 void displayError(ErrorCode code) {
     ErrorInfo info = getErrorInfo(code);
+    LOG_ERROR(MSG_ERROR, (uint8_t)code);
     
     // Print to Serial
-    Serial.println(F("\n!!! ERROR !!!"));
-    Serial.print(F("Code: E"));
-    if (code < 10) Serial.print("0");
-    Serial.println((int)code);
-    Serial.print(F("Message: "));
-    Serial.println(info.shortMsg);
-    Serial.print(F("Detail: "));
-    Serial.println(info.detailMsg);
-    Serial.println();
+    Log.println(F("\n!!! ERROR !!!"));
+    Log.print(F("Code: E"));
+    if (code < 10) Log.print(F("0"));
+    Log.println((int)code);
+    Log.print(F("Message: "));
+    Log.println(info.shortMsg);
+    Log.print(F("Detail: "));
+    Log.println(info.detailMsg);
+    Log.println();
     
     // Try to display on LCD
     showError(info.shortMsg, info.detailMsg);
@@ -39,9 +39,9 @@ enum ErrorCode {
 // Error information structure
 struct ErrorInfo {
     ErrorCode code;
-    const char* shortMsg;    // 16 chars max for LCD line 1
-    const char* detailMsg;   // 16 chars max for LCD line 2
-    int ledBlinks;           // LED blink pattern (number of blinks)
+    const __FlashStringHelper* shortMsg;    // 16 chars max for LCD line 1
+    const __FlashStringHelper* detailMsg;   // 16 chars max for LCD line 2
+    int ledBlinks;                          // LED blink pattern (number of blinks)
 };
 
 // Get error info for a given code
@@ -0,0 +1,88 @@
+/**
+ * Host LED Report Capture Implementation
+ */
+
+#include "host_leds.h"
+#include <HID.h>
+
+static volatile uint8_t hostLeds = 0;
+static volatile uint16_t hostLedReportCount = 0;
+
+#if HOST_LED_CAPTURE
+
+// LED-only keyboard collection (5 LED bits + 3 bits padding)
+static const uint8_t ledReportDescriptor[] PROGMEM = {
+    0x05, 0x01,                 // USAGE_PAGE (Generic Desktop)
+    0x09, 0x06,                 // USAGE (Keyboard)
+    0xa1, 0x01,                 // COLLECTION (Application)
+    0x85, HOST_LED_REPORT_ID,   //   REPORT_ID
+    0x05, 0x08,                 //   USAGE_PAGE (LEDs)
+    0x19, 0x01,                 //   USAGE_MINIMUM (Num Lock)
+    0x29, 0x05,                 //   USAGE_MAXIMUM (Kana)
+    0x15, 0x00,                 //   LOGICAL_MINIMUM (0)
+    0x25, 0x01,                 //   LOGICAL_MAXIMUM (1)
+    0x95, 0x05,                 //   REPORT_COUNT (5)
+    0x75, 0x01,                 //   REPORT_SIZE (1)
+    0x91, 0x02,                 //   OUTPUT (Data,Var,Abs)
+    0x95, 0x01,                 //   REPORT_COUNT (1)
+    0x75, 0x03,                 //   REPORT_SIZE (3)
+    0x91, 0x03,                 //   OUTPUT (Cnst,Var,Abs)
+    0xc0                        // END_COLLECTION
+};
+
+// Plugged in after the HID module so it only sees the control
+// requests HID declines - the stock HID code ignores SET_REPORT.
+// Owns no interfaces or endpoints of its own.
+class HostLedListener : public PluggableUSBModule {
+public:
+    HostLedListener()
+        : PluggableUSBModule(0, 0, NULL),
+          descriptorNode(ledReportDescriptor, sizeof(ledReportDescriptor)) {
+        HID().AppendDescriptor(&descriptorNode);
+        PluggableUSB().plug(this);
+    }
+
+protected:
+    int getInterface(uint8_t*) { return 0; }
+    int getDescriptor(USBSetup&) { return 0; }
+
+    // Runs in the USB interrupt
+    bool setup(USBSetup& setup) {
+        if (setup.bmRequestType != REQUEST_HOSTTODEVICE_CLASS_INTERFACE) return false;
+        if (setup.bRequest != HID_SET_REPORT) return false;
+        if (setup.wValueH != HID_REPORT_TYPE_OUTPUT) return false;
+
+        uint8_t data[2] = {0, 0};
+        uint8_t length = (setup.wLength > 2) ? 2 : setup.wLength;
+        USB_RecvControl(data, length);
+
+        // The first byte is the report ID when the host sends one
+        if (length == 2 && data[0] == HOST_LED_REPORT_ID) {
+            hostLeds = data[1];
+        } else if (length == 1) {
+            hostLeds = data[0];
+        }
+        hostLedReportCount++;
+        return true;
+    }
+
+private:
+    HIDSubDescriptor descriptorNode;
+};
+
+// Must exist before USB enumeration, so it lives at file scope
+static HostLedListener hostLedListener;
+
+#endif // HOST_LED_CAPTURE
+
+uint8_t getHostLeds() {
+    return hostLeds;
+}
+
+uint16_t getHostLedReportCount() {
+    uint16_t count;
+    noInterrupts();
+    count = hostLedReportCount;
+    interrupts();
+    return count;
+}
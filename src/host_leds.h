@@ -0,0 +1,31 @@
+/**
+ * Host LED Report Capture
+ *
+ * Listens for the keyboard LED output reports (Num/Caps/Scroll Lock)
+ * that the target PC sends back to us. A host that echoes a lock-key
+ * press has a running keyboard driver, which makes it a cheap
+ * "is the target alive yet?" signal.
+ *
+ * The stock Keyboard report descriptor has no LED output report, so
+ * this module appends a small LED-only keyboard collection to the HID
+ * descriptor and catches the SET_REPORT requests for it.
+ */
+
+#ifndef HOST_LEDS_H
+#define HOST_LEDS_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// LED bits as sent by the host
+#define HOST_LED_NUM_LOCK       0x01
+#define HOST_LED_CAPS_LOCK      0x02
+#define HOST_LED_SCROLL_LOCK    0x04
+
+// Last LED state reported by the host
+uint8_t getHostLeds();
+
+// Number of LED reports received since power-up (wraps)
+uint16_t getHostLedReportCount();
+
+#endif // HOST_LEDS_H
@@ -23,7 +23,7 @@ uint8_t scanI2C() {
         
         if (error == 0) {
             Serial.print(F("  >> FOUND device at address 0x"));
-            if (address < 16) Serial.print("0");
+            if (address < 16) Serial.print(F("0"));
             Serial.print(address, HEX);
             
             // Identify common devices
@@ -51,7 +51,7 @@ uint8_t scanI2C() {
         Serial.println();
         Serial.println(F("*** UPDATE config.h with: ***"));
         Serial.print(F("    #define LCD_ADDRESS  0x"));
-        if (foundAddress < 16) Serial.print("0");
+        if (foundAddress < 16) Serial.print(F("0"));
         Serial.println(foundAddress, HEX);
         Serial.println();
     } else {
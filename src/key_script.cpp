@@ -0,0 +1,490 @@
+/**
+ * Taught Key Scripts Implementation
+ */
+
+#include "key_script.h"
+#include "console.h"
+#include "display.h"
+#include "keyboard_utils.h"
+#include "log_buffer.h"
+#include "log_tokens.h"
+#include "serial_link.h"
+#include <EEPROM.h>
+#include <FrameProtocol.h>
+
+#define SCRIPT_MAGIC_0      'K'
+#define SCRIPT_MAGIC_1      'S'
+#define SCRIPT_STEPS_ADDR   (EEPROM_SCRIPT_ADDR + KEY_SCRIPT_HEADER_SIZE)
+#define GAP_UNIT_MS         10
+#define GAP_MAX_UNITS       0x7FFF
+
+#if TEACH_ENABLED
+// Teach session
+static bool teaching = false;
+static uint16_t reactionMs = TEACH_REACTION_DEFAULT;
+static uint16_t stepBytes = 0;              // Steps recorded so far
+static uint16_t undoPos = 0xFFFF;           // Start of the last command (0xFFFF = none)
+static uint16_t undoKeyCount = 0;           // keyCount and lastKeyAt before it
+static unsigned long undoLastKeyAt = 0;
+static uint16_t keyCount = 0;
+static unsigned long lastKeyAt = 0;
+static bool oldScriptErased = false;        // First key taught, old script invalid
+#endif // TEACH_ENABLED
+
+struct KeyName {
+    char name[6];
+    uint8_t key;
+};
+
+static const KeyName keyNames[] PROGMEM = {
+    { "up",    KEY_UP_ARROW },
+    { "down",  KEY_DOWN_ARROW },
+    { "left",  KEY_LEFT_ARROW },
+    { "right", KEY_RIGHT_ARROW },
+    { "enter", KEY_RETURN },
+    { "tab",   KEY_TAB },
+    { "esc",   KEY_ESC },
+    { "space", ' ' },
+    { "bksp",  KEY_BACKSPACE },
+    { "del",   KEY_DELETE },
+    { "ins",   KEY_INSERT },
+    { "home",  KEY_HOME },
+    { "end",   KEY_END },
+    { "pgup",  KEY_PAGE_UP },
+    { "pgdn",  KEY_PAGE_DOWN },
+    { "ctrl",  KEY_LEFT_CTRL },
+    { "shift", KEY_LEFT_SHIFT },
+    { "alt",   KEY_LEFT_ALT },
+    { "gui",   KEY_LEFT_GUI }
+};
+
+#define KEY_NAME_COUNT  (sizeof(keyNames) / sizeof(keyNames[0]))
+
+static bool isModifier(uint8_t key) {
+    return key >= KEY_LEFT_CTRL && key <= KEY_RIGHT_GUI;
+}
+
+#if TEACH_ENABLED
+// Key code for a name, F-key ("f1".."f12") or single character; 0 if unknown
+static uint8_t parseKey(const char* word) {
+    for (uint8_t i = 0; i < KEY_NAME_COUNT; i++) {
+        if (strcmp_P(word, keyNames[i].name) == 0) {
+            return pgm_read_byte(&keyNames[i].key);
+        }
+    }
+    if (word[0] == 'f' && word[1] >= '1' && word[1] <= '9') {
+        int n = atoi(word + 1);
+        if (n >= 1 && n <= 12) return KEY_F1 + n - 1;
+    }
+    if (word[0] > ' ' && word[0] < 0x7F && word[1] == '\0') {
+        return word[0];
+    }
+    return 0;
+}
+#endif // TEACH_ENABLED
+
+static void printKeyName(uint8_t key) {
+    for (uint8_t i = 0; i < KEY_NAME_COUNT; i++) {
+        if (pgm_read_byte(&keyNames[i].key) == key) {
+            Log.print((const __FlashStringHelper*)keyNames[i].name);
+            return;
+        }
+    }
+    if (key >= KEY_F1 && key <= KEY_F12) {
+        Log.print('f');
+        Log.print(key - KEY_F1 + 1);
+    } else if (key > ' ' && key < 0x7F) {
+        Log.print((char)key);
+    } else {
+        Log.print(F("0x"));
+        Log.print(key, HEX);
+    }
+}
+
+#if TEACH_ENABLED
+static bool isD7Removed() {
+    return digitalRead(ARM_BUTTON_PIN) == HIGH;
+}
+#endif // TEACH_ENABLED
+
+// ===========================================
+// Script storage
+// ===========================================
+
+static uint8_t scriptChecksum(uint16_t length) {
+    uint8_t sum = 0xA5;
+    sum = (sum << 1 | sum >> 7) ^ (uint8_t)length;
+    sum = (sum << 1 | sum >> 7) ^ (uint8_t)(length >> 8);
+    for (uint16_t i = 0; i < length; i++) {
+        sum = (sum << 1 | sum >> 7) ^ EEPROM.read(SCRIPT_STEPS_ADDR + i);
+    }
+    return sum;
+}
+
+// Length of the stored steps, or -1 if there is no valid script
+static int scriptLength() {
+    if (EEPROM.read(EEPROM_SCRIPT_ADDR) != SCRIPT_MAGIC_0 ||
+        EEPROM.read(EEPROM_SCRIPT_ADDR + 1) != SCRIPT_MAGIC_1 ||
+        EEPROM.read(EEPROM_SCRIPT_ADDR + 2) != KEY_SCRIPT_VERSION) {
+        return -1;
+    }
+    uint16_t length = EEPROM.read(EEPROM_SCRIPT_ADDR + 4) |
+                      (EEPROM.read(EEPROM_SCRIPT_ADDR + 5) << 8);
+    if (length > KEY_SCRIPT_MAX_STEPS) return -1;
+    if (EEPROM.read(EEPROM_SCRIPT_ADDR + 3) != scriptChecksum(length)) return -1;
+    return length;
+}
+
+#if TEACH_ENABLED
+static void writeHeader(uint16_t length) {
+    EEPROM.update(EEPROM_SCRIPT_ADDR + 2, KEY_SCRIPT_VERSION);
+    EEPROM.update(EEPROM_SCRIPT_ADDR + 3, scriptChecksum(length));
+    EEPROM.update(EEPROM_SCRIPT_ADDR + 4, length & 0xFF);
+    EEPROM.update(EEPROM_SCRIPT_ADDR + 5, length >> 8);
+    EEPROM.update(EEPROM_SCRIPT_ADDR + 1, SCRIPT_MAGIC_1);
+    EEPROM.update(EEPROM_SCRIPT_ADDR, SCRIPT_MAGIC_0);     // Valid from here on
+}
+#endif // TEACH_ENABLED
+
+// Read one step at pos; returns the step's size, 0 if it runs past length
+static uint8_t readStep(uint16_t pos, uint16_t length,
+                        uint32_t* gapMs, uint8_t* modifier, uint8_t* key) {
+    uint16_t start = pos;
+    if (pos >= length) return 0;
+    uint16_t units = EEPROM.read(SCRIPT_STEPS_ADDR + pos++);
+    if (units & 0x80) {
+        if (pos >= length) return 0;
+        units = ((units & 0x7F) << 8) | EEPROM.read(SCRIPT_STEPS_ADDR + pos++);
+    }
+    *gapMs = (uint32_t)units * GAP_UNIT_MS;     // Up to 327 s - past uint16_t
+
+    if (pos >= length) return 0;
+    *modifier = 0;
+    *key = EEPROM.read(SCRIPT_STEPS_ADDR + pos++);
+    if (isModifier(*key)) {
+        if (pos >= length) return 0;
+        *modifier = *key;
+        *key = EEPROM.read(SCRIPT_STEPS_ADDR + pos++);
+    }
+    return pos - start;
+}
+
+#if TEACH_ENABLED
+
+// ===========================================
+// Teach mode
+// ===========================================
+
+// Time from "NOW" on the LCD to Enter arriving over Serial: the part
+// of every taught gap that was the technician, not the target.
+// The fastest trial is kept so no gap is trimmed too far.
+static uint16_t measureReaction() {
+    Log.println(F("Teach: reaction test - press Enter when the LCD says NOW"));
+    uint16_t best = 0xFFFF;
+
+    for (uint8_t trial = 0; trial < TEACH_REACTION_TRIALS; trial++) {
+        showStatus(F("REACTION TEST"), F("Enter on NOW"));
+        delay(1000 + random(2000));
+        while (Serial.available()) Serial.read();   // Early presses don't count
+
+        showStatus(F("REACTION TEST"), F(">>> NOW <<<"));
+        unsigned long shownAt = millis();
+        bool pressed = false;
+        while (millis() - shownAt < TEACH_REACTION_TIMEOUT) {
+            if (Serial.available()) {
+                char c = Serial.read();
+                if (c == '\r' || c == '\n') {
+                    pressed = true;
+                    break;
+                }
+            }
+        }
+        uint16_t ms = millis() - shownAt;
+
+        delay(50);
+        while (Serial.available()) Serial.read();   // Rest of a CR LF
+
+        if (pressed) {
+            Log.print(F("  trial "));
+            Log.print(trial + 1);
+            Log.print(F(": "));
+            Log.print(ms);
+            Log.println(F("ms"));
+            if (ms < best) best = ms;
+        }
+    }
+
+    if (best == 0xFFFF) {
+        Log.println(F("  no valid trial - using default"));
+        best = TEACH_REACTION_DEFAULT;
+    }
+    return best;
+}
+
+static void showTeachState() {
+    LiquidCrystal_I2C& lcd = getLCD();
+    lcd.clear();
+    lcd.setCursor(0, 0);
+    lcd.print(F("TEACHING"));
+    lcd.setCursor(0, 1);
+    lcd.print(keyCount);
+    lcd.print(F(" keys "));
+    lcd.print(stepBytes);
+    lcd.print(F("B"));
+}
+
+static void writeStepByte(uint8_t value) {
+    // The steps overwrite the old script - it stops being valid here
+    if (!oldScriptErased) {
+        EEPROM.update(EEPROM_SCRIPT_ADDR, 0);
+        oldScriptErased = true;
+    }
+    EEPROM.update(SCRIPT_STEPS_ADDR + stepBytes++, value);
+}
+
+// Send one key live and record it with the gap that preceded it
+static void teachKey(uint8_t modifier, uint8_t key, unsigned long gapMs) {
+    uint32_t units = (gapMs + GAP_UNIT_MS - 1) / GAP_UNIT_MS;
+    if (units > GAP_MAX_UNITS) units = GAP_MAX_UNITS;
+    if (units < 0x80) {
+        writeStepByte(units);
+    } else {
+        writeStepByte(0x80 | (units >> 8));
+        writeStepByte(units & 0xFF);
+    }
+    if (modifier) writeStepByte(modifier);
+    writeStepByte(key);
+
+    tapKey(modifier, key);
+    lastKeyAt = millis();
+    keyCount++;
+}
+
+bool beginTeach() {
+    if (!isD7Removed()) return false;
+
+    reactionMs = measureReaction();
+    Log.print(F("Teach: reaction "));
+    Log.print(reactionMs);
+    Log.println(F("ms is taken off every gap"));
+    Log.println(F("Keys: up down left right enter tab esc space bksp del ins"));
+    Log.println(F("      home end pgup pgdn f1-f12 a-z ... alt+d  [count]"));
+    Log.println(F("      \"text  undo  save  quit"));
+
+    initKeyboard();
+    teaching = true;
+    stepBytes = 0;
+    undoPos = 0xFFFF;
+    keyCount = 0;
+    lastKeyAt = 0;
+    oldScriptErased = false;
+    setLinkState(FRAME_STATE_RUNNING, PAYLOAD_SCRIPT, PROFILE_TUNED);
+    showTeachState();
+    return true;
+}
+
+bool isTeaching() {
+    return teaching;
+}
+
+static void endTeach() {
+    teaching = false;
+    releaseAllKeys();
+    setLinkState(FRAME_STATE_DONE, PAYLOAD_SCRIPT, PROFILE_TUNED);
+}
+
+void teachLine(char* line) {
+    // Gap the technician left since the last key, less their reaction
+    // time - the first key of a command gets it, the rest go at the minimum
+    unsigned long humanGap = (keyCount == 0) ? 0 : millis() - lastKeyAt;
+    unsigned long firstGap = (humanGap > reactionMs) ? humanGap - reactionMs : 0;
+    if (firstGap < TEACH_MIN_GAP) firstGap = TEACH_MIN_GAP;
+    if (keyCount == 0) firstGap = 0;    // Script starts with its first key
+    unsigned long gap = firstGap;
+
+    if (strcmp_P(line, PSTR("save")) == 0) {
+        writeHeader(stepBytes);
+        endTeach();
+        Log.print(F("OK saved "));
+        Log.print(keyCount);
+        Log.print(F(" keys, "));
+        Log.print(stepBytes);
+        Log.println(F(" bytes - run as payload script"));
+        showStatus(F("SCRIPT SAVED"), F("payload script"));
+        return;
+    }
+    if (strcmp_P(line, PSTR("quit")) == 0) {
+        endTeach();
+        if (oldScriptErased) {
+            Log.println(F("OK teach ended, nothing saved - the old script is erased"));
+            showStatus(F("TEACH ENDED"), F("Old script gone"));
+        } else {
+            Log.println(F("OK teach ended, old script kept"));
+            showStatus(F("TEACH ENDED"), F("Not saved"));
+        }
+        return;
+    }
+    if (strcmp_P(line, PSTR("undo")) == 0) {
+        if (undoPos == 0xFFFF) {
+            Log.println(F("ERR nothing to undo"));
+        } else {
+            stepBytes = undoPos;
+            keyCount = undoKeyCount;
+            lastKeyAt = undoLastKeyAt;
+            undoPos = 0xFFFF;
+            Log.println(F("OK last command removed (undo it on screen by hand)"));
+            showTeachState();
+        }
+        return;
+    }
+
+    if (!isD7Removed()) {
+        Log.println(F("ERR D7 connected - remove it to send keys"));
+        return;
+    }
+
+    uint16_t commandStart = stepBytes;
+    uint16_t keysBefore = keyCount;
+    unsigned long lastKeyBefore = lastKeyAt;
+
+    // "text: each character is one key
+    if (line[0] == '"') {
+        const char* text = line + 1;
+        if (stepBytes + strlen(text) * 3 > KEY_SCRIPT_MAX_STEPS) {
+            Log.println(F("ERR script full"));
+            return;
+        }
+        // Bytes 0x80+ (UTF-8) would replay as modifier or special keys
+        for (const char* c = text; *c; c++) {
+            if (*c < ' ' || *c > '~') {
+                Log.println(F("ERR text must be printable ASCII"));
+                return;
+            }
+        }
+        for (; *text; text++) {
+            teachKey(0, *text, gap);
+            gap = TEACH_MIN_GAP;
+            delay(TEACH_MIN_GAP);
+        }
+    } else {
+        char* word = strtok(line, " ");
+        char* countArg = strtok(NULL, " ");
+        if (word == NULL) return;
+
+        uint8_t modifier = 0;
+        char* plus = strchr(word, '+');
+        if (plus != NULL) {
+            *plus = '\0';
+            modifier = parseKey(word);
+            word = plus + 1;
+            if (!isModifier(modifier)) modifier = 0xFF;
+        }
+        uint8_t key = parseKey(word);
+        int count = countArg ? atoi(countArg) : 1;
+        if (key == 0 || modifier == 0xFF || count < 1 || count > 50) {
+            Log.println(F("ERR unknown key"));
+            return;
+        }
+        if (stepBytes + count * 4 > KEY_SCRIPT_MAX_STEPS) {
+            Log.println(F("ERR script full"));
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            teachKey(modifier, key, gap);
+            gap = TEACH_MIN_GAP;
+            if (i + 1 < count) delay(TEACH_MIN_GAP);
+        }
+    }
+
+    undoPos = commandStart;
+    undoKeyCount = keysBefore;
+    undoLastKeyAt = lastKeyBefore;
+    Log.print(F("OK "));
+    Log.print(keyCount);
+    Log.print(F(" keys, gap "));
+    Log.print(humanGap);
+    Log.print(F("ms -> "));
+    Log.print(firstGap);
+    Log.println(F("ms"));
+    showTeachState();
+}
+
+#endif // TEACH_ENABLED
+
+// ===========================================
+// Replay
+// ===========================================
+
+bool hasKeyScript() {
+    return scriptLength() > 0;
+}
+
+bool replayKeyScript() {
+    int length = scriptLength();
+    if (length <= 0) {
+        LOG_WARN(MSG_SCRIPT_MISSING);
+        showStatus(F("NO SCRIPT"), F("Teach one first"));
+        return false;
+    }
+
+    initKeyboard();
+    showStatus(F("SCRIPT"), F("Replaying..."));
+
+    uint16_t pos = 0;
+    uint32_t gapMs;
+    uint8_t modifier, key;
+    while (uint8_t size = readStep(pos, length, &gapMs, &modifier, &key)) {
+        pos += size;
+
+        // Long gaps can be skipped/aborted from the console
+        if (gapMs >= TUNE_GESTURE_MIN_WAIT) {
+            unsigned long start = millis();
+            while (millis() - start < gapMs) {
+                if (pollConsoleWait() != CONSOLE_WAIT_NONE) break;
+                delay(20);
+            }
+        } else {
+            delay(gapMs);
+        }
+        if (isRunAborted()) return false;
+
+        tapKey(modifier, key);
+    }
+    return true;
+}
+
+void printKeyScript() {
+    int length = scriptLength();
+    if (length < 0) {
+        Log.println(F("No taught key script"));
+        return;
+    }
+
+    uint16_t pos = 0;
+    uint32_t gapMs;
+    uint8_t modifier, key;
+    uint32_t totalMs = 0;
+    uint16_t keys = 0;
+    while (uint8_t size = readStep(pos, length, &gapMs, &modifier, &key)) {
+        pos += size;
+        totalMs += gapMs;
+        keys++;
+
+        Log.print(F("  +"));
+        Log.print(gapMs);
+        Log.print(F("ms "));
+        if (modifier) {
+            printKeyName(modifier);
+            Log.print('+');
+        }
+        printKeyName(key);
+        Log.println();
+    }
+    Log.print(F("Script: "));
+    Log.print(keys);
+    Log.print(F(" keys, "));
+    Log.print(length);
+    Log.print(F(" bytes, "));
+    Log.print(totalMs);
+    Log.println(F("ms of gaps"));
+}
@@ -0,0 +1,53 @@
+/**
+ * Taught Key Scripts
+ *
+ * Teach mode: with D7 out, keys typed as Serial console lines ("down",
+ * "enter 2", "f2", "alt+d", "\"text") go to the target right away and
+ * are recorded into the EEPROM script area together with the gap that
+ * worked before each one. The technician's reaction time is measured
+ * at the start and taken off every gap, so the script replays at full
+ * speed as the PAYLOAD_SCRIPT payload.
+ *
+ * Script format at EEPROM_SCRIPT_ADDR (also written by FRAME_SCRIPT_WRITE):
+ *   'K' 'S' version checksum length(u16 LE)   then length bytes of steps
+ *   step = gap, key            or   gap, modifier (0x80-0x87), key
+ *   gap  = 10 ms units: 0xxxxxxx (0-1.27 s) or 1xxxxxxx xxxxxxxx (to 327 s)
+ */
+
+#ifndef KEY_SCRIPT_H
+#define KEY_SCRIPT_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+#define KEY_SCRIPT_VERSION      1
+#define KEY_SCRIPT_HEADER_SIZE  6
+#define KEY_SCRIPT_MAX_STEPS    (EEPROM_SCRIPT_SIZE - KEY_SCRIPT_HEADER_SIZE)
+
+#if TEACH_ENABLED
+// Start teaching: measures the technician's reaction time (blocks for
+// a few seconds), then records. False if D7 is connected.
+bool beginTeach();
+
+// True while a teach session is open
+bool isTeaching();
+
+// One console line while teaching: a key to send and record, or
+// "undo", "save", "quit"
+void teachLine(char* line);
+#else
+inline bool isTeaching() { return false; }
+inline void teachLine(char*) {}
+#endif
+
+// True if EEPROM holds a valid script
+bool hasKeyScript();
+
+// Replay the script at its recorded pace. False if there is none or
+// the run was aborted.
+bool replayKeyScript();
+
+// Print the script's steps to the log
+void printKeyScript();
+
+#endif // KEY_SCRIPT_H
@@ -3,10 +3,15 @@
  */
 
 #include "keyboard_utils.h"
+#include "console.h"
+#include "log_buffer.h"
+#include "probes.h"
+#include "telemetry.h"
+#include "timing_config.h"
 
 void initKeyboard() {
     #if DEMO_MODE
-        Serial.println(F("[DEMO] Keyboard disabled - demo mode active"));
+        Log.println(F("[DEMO] Keyboard disabled - demo mode active"));
     #else
         Keyboard.begin();
         DEBUG_PRINTLN(F("Keyboard initialized"));
@@ -14,128 +19,167 @@ void initKeyboard() {
 }
 
 void pressKey(uint8_t key) {
+    if (isRunAborted()) return;     // Aborted from the console: no more keys
+    PROBE_BEGIN(PROBE_PRESS_KEY);
+    countRunKey();
     #if DEMO_MODE
-        Serial.print(F("[DEMO] Press key: 0x"));
-        Serial.println(key, HEX);
+        Log.print(F("[DEMO] Press key: 0x"));
+        Log.println(key, HEX);
     #else
         Keyboard.press(key);
-        delay(KEY_HOLD_DELAY);
+        delay(Timing.keyHoldDelay);
         Keyboard.release(key);
     #endif
-    delay(KEY_DELAY);
+    delay(Timing.keyDelay);
+    PROBE_END(PROBE_PRESS_KEY);
 }
 
 void pressChar(char c) {
+    if (isRunAborted()) return;
+    countRunKey();
     #if DEMO_MODE
-        Serial.print(F("[DEMO] Press char: "));
-        Serial.println(c);
+        Log.print(F("[DEMO] Press char: "));
+        Log.println(c);
     #else
         Keyboard.write(c);
     #endif
-    delay(KEY_DELAY);
+    delay(Timing.keyDelay);
 }
 
 void typeString(const char* str) {
+    if (isRunAborted()) return;
     #if DEMO_MODE
-        Serial.print(F("[DEMO] Type string: "));
-        Serial.println(str);
+        Log.print(F("[DEMO] Type string: "));
+        Log.println(str);
     #else
         while (*str) {
+            countRunKey();
             Keyboard.write(*str++);
-            delay(KEY_DELAY / 2);
+            delay(Timing.keyDelay / 2);
         }
     #endif
-    delay(KEY_DELAY);
+    delay(Timing.keyDelay);
 }
 
 void pressCombo(uint8_t modifier, uint8_t key) {
+    if (isRunAborted()) return;
+    countRunKey();
     #if DEMO_MODE
-        Serial.print(F("[DEMO] Combo: 0x"));
-        Serial.print(modifier, HEX);
-        Serial.print(F(" + 0x"));
-        Serial.println(key, HEX);
+        Log.print(F("[DEMO] Combo: 0x"));
+        Log.print(modifier, HEX);
+        Log.print(F(" + 0x"));
+        Log.println(key, HEX);
     #else
         Keyboard.press(modifier);
-        delay(KEY_HOLD_DELAY);
+        delay(Timing.keyHoldDelay);
         Keyboard.press(key);
-        delay(KEY_HOLD_DELAY);
+        delay(Timing.keyHoldDelay);
         Keyboard.releaseAll();
     #endif
-    delay(KEY_DELAY * 2);
+    delay(Timing.keyDelay * 2);
 }
 
 void pressCombo3(uint8_t mod1, uint8_t mod2, uint8_t key) {
+    if (isRunAborted()) return;
+    countRunKey();
     #if DEMO_MODE
-        Serial.print(F("[DEMO] Combo3: 0x"));
-        Serial.print(mod1, HEX);
-        Serial.print(F(" + 0x"));
-        Serial.print(mod2, HEX);
-        Serial.print(F(" + 0x"));
-        Serial.println(key, HEX);
+        Log.print(F("[DEMO] Combo3: 0x"));
+        Log.print(mod1, HEX);
+        Log.print(F(" + 0x"));
+        Log.print(mod2, HEX);
+        Log.print(F(" + 0x"));
+        Log.println(key, HEX);
     #else
         Keyboard.press(mod1);
-        delay(KEY_HOLD_DELAY);
+        delay(Timing.keyHoldDelay);
         Keyboard.press(mod2);
-        delay(KEY_HOLD_DELAY);
+        delay(Timing.keyHoldDelay);
         Keyboard.press(key);
-        delay(KEY_HOLD_DELAY);
+        delay(Timing.keyHoldDelay);
         Keyboard.releaseAll();
     #endif
-    delay(KEY_DELAY * 2);
+    delay(Timing.keyDelay * 2);
 }
 
 void holdKey(uint8_t key, int durationMs) {
+    if (isRunAborted()) return;
+    countRunKey();
     #if DEMO_MODE
-        Serial.print(F("[DEMO] Hold key 0x"));
-        Serial.print(key, HEX);
-        Serial.print(F(" for "));
-        Serial.print(durationMs);
-        Serial.println(F("ms"));
+        Log.print(F("[DEMO] Hold key 0x"));
+        Log.print(key, HEX);
+        Log.print(F(" for "));
+        Log.print(durationMs);
+        Log.println(F("ms"));
         delay(durationMs);
     #else
         Keyboard.press(key);
         delay(durationMs);
         Keyboard.release(key);
     #endif
-    delay(KEY_DELAY);
+    delay(Timing.keyDelay);
+}
+
+void tapKey(uint8_t modifier, uint8_t key) {
+    if (isRunAborted()) return;
+    countRunKey();
+    #if DEMO_MODE
+        Log.print(F("[DEMO] Tap: 0x"));
+        if (modifier) {
+            Log.print(modifier, HEX);
+            Log.print(F(" + 0x"));
+        }
+        Log.println(key, HEX);
+    #else
+        if (modifier) Keyboard.press(modifier);
+        Keyboard.press(key);
+        delay(Timing.keyHoldDelay);
+        Keyboard.releaseAll();
+    #endif
 }
 
 int spamKey(uint8_t key, int durationMs, int intervalMs) {
     int count = 0;
     unsigned long startTime = millis();
     
-    while (millis() - startTime < (unsigned long)durationMs) {
+    while (millis() - startTime < (unsigned long)durationMs && !isRunAborted()) {
         #if DEMO_MODE
             // Just count, don't actually press
         #else
             Keyboard.press(key);
-            delay(KEY_HOLD_DELAY);
+            delay(Timing.keyHoldDelay);
             Keyboard.release(key);
         #endif
-        delay(intervalMs - KEY_HOLD_DELAY);
+        delay(intervalMs - Timing.keyHoldDelay);
+        countRunKey();
         count++;
     }
     
-    Serial.print(F("[DEMO] Spammed key 0x"));
-    Serial.print(key, HEX);
-    Serial.print(F(" "));
-    Serial.print(count);
-    Serial.println(F(" times"));
+    #if DEMO_MODE
+        Log.print(F("[DEMO] Spammed key 0x"));
+        Log.print(key, HEX);
+        Log.print(F(" "));
+        Log.print(count);
+        Log.println(F(" times"));
+    #endif
     
     return count;
 }
 
 void pressDownMultiple(int times) {
-    Serial.print(F("[DEMO] DOWN x"));
-    Serial.println(times);
+    #if DEMO_MODE
+        Log.print(F("[DEMO] DOWN x"));
+        Log.println(times);
+    #endif
     for (int i = 0; i < times; i++) {
         pressKey(KEY_DOWN_ARROW);
     }
 }
 
 void pressTabMultiple(int times) {
-    Serial.print(F("[DEMO] TAB x"));
-    Serial.println(times);
+    #if DEMO_MODE
+        Log.print(F("[DEMO] TAB x"));
+        Log.println(times);
+    #endif
     for (int i = 0; i < times; i++) {
         pressKey(KEY_TAB);
     }
@@ -33,6 +33,10 @@ void pressCombo3(uint8_t mod1, uint8_t mod2, uint8_t key);
 // Hold a key for a duration
 void holdKey(uint8_t key, int durationMs);
 
+// Press and release a key (with an optional modifier, 0 = none) and
+// return without the KEY_DELAY gap - the caller paces (key scripts)
+void tapKey(uint8_t modifier, uint8_t key);
+
 // Spam a key repeatedly for a duration (returns actual key presses sent)
 int spamKey(uint8_t key, int durationMs, int intervalMs);
 
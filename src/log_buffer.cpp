@@ -0,0 +1,153 @@
+/**
+ * Buffered Logging Implementation
+ */
+
+#include "log_buffer.h"
+#include "log_tokens.h"
+#include <FrameProtocol.h>
+
+LogBuffer Log;
+
+static uint8_t buffer[LOG_BUFFER_SIZE];
+static uint16_t head = 0;           // Next write
+static uint16_t tail = 0;           // Next read
+static uint16_t used = 0;
+static uint16_t peak = 0;           // Most bytes buffered at once
+static uint16_t dropped = 0;        // Total since boot
+static uint16_t droppedUnreported = 0;
+static bool realtimeMode = false;
+static bool draining = false;       // drainLog() runs from yield() too
+static bool rawOutput = true;
+static uint8_t recordLeft = 0;      // Bytes of a half-sent record still to go
+
+// True once there is room for size bytes. Outside a run this gives
+// the host a moment to read; otherwise the bytes are counted as dropped.
+static bool makeRoom(uint8_t size) {
+    if (LOG_BUFFER_SIZE - used < size && !realtimeMode && rawOutput) {
+        unsigned long start = millis();
+        while (LOG_BUFFER_SIZE - used < size && millis() - start < LOG_IDLE_WAIT) {
+            drainLog();
+        }
+    }
+
+    if (LOG_BUFFER_SIZE - used < size) {
+        dropped = (dropped + size > 0xFFFF) ? 0xFFFF : dropped + size;
+        droppedUnreported = (droppedUnreported + size > 0xFFFF) ? 0xFFFF : droppedUnreported + size;
+        return false;
+    }
+    return true;
+}
+
+size_t LogBuffer::write(uint8_t c) {
+    if (!makeRoom(1)) return 0;
+
+    buffer[head] = c;
+    head = (head + 1) % LOG_BUFFER_SIZE;
+    used++;
+    if (used > peak) peak = used;
+    return 1;
+}
+
+void logRecord(uint8_t id, const uint8_t* args, uint8_t length) {
+    // Half a record would garble the decoder - room for all of it or drop it
+    if (!makeRoom(LOG_RECORD_HEADER + length)) return;
+
+    uint32_t now = millis();
+    Log.write((uint8_t)LOG_RECORD_START);
+    Log.write(id);
+    Log.write(length);
+    Log.write((const uint8_t*)&now, sizeof(now));
+    Log.write(args, length);
+}
+
+// Send the oldest buffered byte, escaped so a 0x00 in a record can't
+// be taken for a frame delimiter
+static void sendNextByte() {
+    uint8_t c = buffer[tail];
+    if (recordLeft == 0 && c == LOG_RECORD_START) {
+        recordLeft = LOG_RECORD_HEADER + buffer[(tail + 2) % LOG_BUFFER_SIZE];
+    }
+    if (recordLeft > 0) recordLeft--;
+
+    uint8_t wire[2];
+    Serial.write(wire, frameTextEscape(c, wire));
+    tail = (tail + 1) % LOG_BUFFER_SIZE;
+    used--;
+}
+
+void drainLog() {
+    if (draining || !rawOutput) return;
+    draining = true;
+
+    // Only what fits in the CDC endpoint now - Serial.write() never waits then
+    int space = Serial.availableForWrite();
+    while (used > 0 && space >= frameTextSize(buffer[tail])) {
+        space -= frameTextSize(buffer[tail]);
+        sendNextByte();
+    }
+
+    // Say how much went missing once the backlog is out
+    if (used == 0 && droppedUnreported > 0 && space >= 24) {
+        Serial.print(F("\n[LOG DROPPED "));
+        Serial.print(droppedUnreported);
+        Serial.println(F("]"));
+        droppedUnreported = 0;
+    }
+
+    draining = false;
+}
+
+void finishLogRecord() {
+    if (draining) return;
+    draining = true;
+
+    // At most LOG_MAX_RECORD bytes, so waiting for the endpoint is short
+    while (recordLeft > 0 && used > 0) {
+        sendNextByte();
+    }
+    recordLeft = 0;
+
+    draining = false;
+}
+
+void setLogRealtime(bool realtime) {
+    realtimeMode = realtime;
+}
+
+uint16_t getLogDropCount() {
+    return dropped;
+}
+
+uint16_t getLogPeak() {
+    return peak;
+}
+
+void setLogRawOutput(bool raw) {
+    finishLogRecord();
+    rawOutput = raw;
+}
+
+uint8_t readLog(uint8_t* out, uint8_t max) {
+    finishLogRecord();
+
+    uint8_t count = 0;
+    while (used > 0 && count < max) {
+        uint8_t size = 1;
+        if (buffer[tail] == LOG_RECORD_START) {
+            size = LOG_RECORD_HEADER + buffer[(tail + 2) % LOG_BUFFER_SIZE];
+        }
+        if (count + size > max) break;      // Whole records only
+
+        while (size--) {
+            out[count++] = buffer[tail];
+            tail = (tail + 1) % LOG_BUFFER_SIZE;
+            used--;
+        }
+    }
+    return count;
+}
+
+// delay() calls yield() while it waits - drain the log there
+void yield() {
+    drainLog();
+}
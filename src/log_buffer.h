@@ -0,0 +1,54 @@
+/**
+ * Buffered Logging
+ *
+ * Log output goes into a fixed RAM ring buffer instead of straight to
+ * Serial. The buffer drains in idle time (every delay() via yield(),
+ * and the idle loops) and only as fast as the USB CDC endpoint takes
+ * it, so a terminal that is open but not reading can never stall a
+ * keystroke. While a payload runs, a full buffer drops bytes and
+ * counts them; the count is printed once there is room again.
+ */
+
+#ifndef LOG_BUFFER_H
+#define LOG_BUFFER_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+class LogBuffer : public Print {
+public:
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+// Use Log.print()/Log.println() instead of Serial for log output
+extern LogBuffer Log;
+
+// Move what the USB endpoint can take right now to Serial (never waits).
+// 0x00 is escaped on the way out (see lib/FrameProtocol). May stop in
+// the middle of a binary record.
+void drainLog();
+
+// Send the rest of a record drainLog() stopped in, so the next thing
+// written to Serial (a frame, a dump) starts on a record boundary
+void finishLogRecord();
+
+// Realtime (payload running): a full buffer drops instead of waiting.
+// Outside a run a full buffer waits up to LOG_IDLE_WAIT ms for the host.
+void setLogRealtime(bool realtime);
+
+// Bytes dropped since boot
+uint16_t getLogDropCount();
+
+// Most bytes the buffer held at once since boot (LOG_BUFFER_SIZE = full)
+uint16_t getLogPeak();
+
+// Off: nothing is sent as raw Serial bytes, the log is only read with
+// readLog() (binary frame protocol). On by default.
+void setLogRawOutput(bool raw);
+
+// Take up to max bytes out of the buffer, returns the count. Never
+// splits a record: max below LOG_MAX_RECORD can return 0 with data left.
+uint8_t readLog(uint8_t* out, uint8_t max);
+
+#endif // LOG_BUFFER_H
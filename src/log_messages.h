@@ -0,0 +1,48 @@
+/**
+ * Tokenized Log Message Table
+ *
+ * X(id, level, format) - one line per message. The message ID is the
+ * position in this list, so only ever append; tools/log_decode.py reads
+ * this file to turn binary records back into text.
+ *
+ * Argument formats (pass arguments cast to exactly this width):
+ *   %b = uint8_t   %u = uint16_t   %d = int16_t
+ *   %lu = uint32_t %ld = int32_t   %w = wait step name (uint8_t)
+ */
+
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+#define LOG_MESSAGE_TABLE(X) \
+    X(MSG_RUN_START,        LOG_LEVEL_INFO,  "Run start: payload %b, profile %b") \
+    X(MSG_RUN_SAVED,        LOG_LEVEL_INFO,  "Run %u saved: %u keys, completed %b") \
+    X(MSG_RUN_OUTCOME,      LOG_LEVEL_INFO,  "Run outcome: good %b") \
+    X(MSG_PHASE,            LOG_LEVEL_DEBUG, "Phase %b") \
+    X(MSG_READY_ECHO,       LOG_LEVEL_INFO,  "READY %w: %lu ms, probes=%u") \
+    X(MSG_READY_TIMEOUT,    LOG_LEVEL_WARN,  "TIMEOUT %w: %lu ms, probes=%u") \
+    X(MSG_READY_SKIPPED,    LOG_LEVEL_INFO,  "SKIPPED %w: %lu ms, probes=%u") \
+    X(MSG_WAIT_SKIP,        LOG_LEVEL_INFO,  "SKIP %w after %lu ms, now %u") \
+    X(MSG_WAIT_GROW,        LOG_LEVEL_INFO,  "Tuning: grew %w to %u") \
+    X(MSG_ADJUST_START,     LOG_LEVEL_DEBUG, "Adjustment: payload %b, saved position +%d") \
+    X(MSG_ADJUST_TOUCH,     LOG_LEVEL_DEBUG, "Adjustment touch: extra DOWNs now %d") \
+    X(MSG_ADJUST_DONE,      LOG_LEVEL_INFO,  "Adjustment done: extra DOWNs %d, confirmed %b") \
+    X(MSG_USB_DROPPED,      LOG_LEVEL_INFO,  "USB link dropped after %lu ms") \
+    X(MSG_USB_BACK,         LOG_LEVEL_INFO,  "USB re-enumerated after %lu ms") \
+    X(MSG_USB_TIMEOUT,      LOG_LEVEL_WARN,  "Reboot wait timed out, link dropped %b") \
+    X(MSG_ERROR,            LOG_LEVEL_ERROR, "Error E%b") \
+    X(MSG_STACK_PHASE,      LOG_LEVEL_DEBUG, "Stack: phase %b left %u bytes free") \
+    X(MSG_CHAIN_RESUMED,    LOG_LEVEL_INFO,  "Chain resumed after power loss: Win10 install") \
+    X(MSG_CHAIN_NO_REBOOT,  LOG_LEVEL_WARN,  "Chain stopped: target did not reboot") \
+    X(MSG_RUN_ABORTED,      LOG_LEVEL_INFO,  "Run aborted from the console") \
+    X(MSG_SCRIPT_MISSING,   LOG_LEVEL_WARN,  "No taught key script in EEPROM") \
+    X(MSG_ADJUST_UNSAVED,   LOG_LEVEL_DEBUG, "Adjustment: payload %b, no saved position")
+
+#define LOG_MESSAGE_ENUM(id, level, format)     id,
+#define LOG_MESSAGE_LEVEL(id, level, format)    level,
+
+enum LogMessage {
+    LOG_MESSAGE_TABLE(LOG_MESSAGE_ENUM)
+    LOG_MESSAGE_COUNT
+};
+
+#endif // LOG_MESSAGES_H
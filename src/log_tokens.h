@@ -0,0 +1,96 @@
+/**
+ * Tokenized Logging
+ *
+ * LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG(MSG_x, args...) write a small
+ * binary record into the log buffer instead of formatting text:
+ *   0x1F, message ID, argument bytes, millis() (4 bytes), arguments
+ * No format strings are stored on the device; tools/log_decode.py
+ * rebuilds the text from log_messages.h. Levels above LOG_LEVEL
+ * compile to nothing - their arguments are not even evaluated.
+ * Records hold 0x00 bytes; on Serial drainLog() escapes them
+ * (frameTextEscape()) so they can't be taken for a frame delimiter.
+ */
+
+#ifndef LOG_TOKENS_H
+#define LOG_TOKENS_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+#include "log_messages.h"
+
+#define LOG_RECORD_START    0x1F        // ASCII unit separator, never in text
+#define LOG_MAX_ARG_BYTES   12
+#define LOG_RECORD_HEADER   7           // Start, ID, length, millis
+#define LOG_MAX_RECORD      (LOG_RECORD_HEADER + LOG_MAX_ARG_BYTES)
+
+// Write one record, or drop it whole if the buffer is full
+void logRecord(uint8_t id, const uint8_t* args, uint8_t length);
+
+// Level of each message, for the compile-time check in the macros
+constexpr uint8_t logMessageLevels[LOG_MESSAGE_COUNT] = {
+    LOG_MESSAGE_TABLE(LOG_MESSAGE_LEVEL)
+};
+
+// Total size of the argument types
+template <typename... Args>
+struct LogArgBytes {
+    static const uint8_t value = 0;
+};
+
+template <typename T, typename... Rest>
+struct LogArgBytes<T, Rest...> {
+    static const uint8_t value = sizeof(T) + LogArgBytes<Rest...>::value;
+};
+
+inline void packLogArgs(uint8_t*) {
+}
+
+template <typename T, typename... Rest>
+inline void packLogArgs(uint8_t* out, T value, Rest... rest) {
+    memcpy(out, &value, sizeof(T));
+    packLogArgs(out + sizeof(T), rest...);
+}
+
+template <typename... Args>
+inline void logToken(uint8_t id, Args... args) {
+    static_assert(LogArgBytes<Args...>::value <= LOG_MAX_ARG_BYTES, "Too many log argument bytes");
+    uint8_t data[LOG_MAX_ARG_BYTES];
+    packLogArgs(data, args...);
+    logRecord(id, data, LogArgBytes<Args...>::value);
+}
+
+#define LOG_TOKEN_CHECKED(level, id, ...) do { \
+        static_assert(logMessageLevels[id] == level, #id " is logged at the wrong level"); \
+        logToken(id, ##__VA_ARGS__); \
+    } while (0)
+
+// Disabled level: sizeof() keeps the arguments "used" without evaluating them
+#define LOG_TOKEN_NONE(id, ...) do { \
+        (void)sizeof((packLogArgs((uint8_t*)0, ##__VA_ARGS__), 0)); \
+    } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+    #define LOG_ERROR(id, ...)  LOG_TOKEN_CHECKED(LOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#else
+    #define LOG_ERROR(id, ...)  LOG_TOKEN_NONE(id, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+    #define LOG_WARN(id, ...)   LOG_TOKEN_CHECKED(LOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#else
+    #define LOG_WARN(id, ...)   LOG_TOKEN_NONE(id, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+    #define LOG_INFO(id, ...)   LOG_TOKEN_CHECKED(LOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#else
+    #define LOG_INFO(id, ...)   LOG_TOKEN_NONE(id, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(id, ...)  LOG_TOKEN_CHECKED(LOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+#else
+    #define LOG_DEBUG(id, ...)  LOG_TOKEN_NONE(id, ##__VA_ARGS__)
+#endif
+
+#endif // LOG_TOKENS_H
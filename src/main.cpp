@@ -5,6 +5,7 @@
  * DUAL MODE OPERATION:
  *   D7 only removed  -> BIOS Password Removal (types ls3gt1)
  *   D7 AND D10 removed -> Windows 10 Clean Install
+ *   CHAIN_PAYLOADS 1: D7 only removed -> BIOS password, reboot, Win10 install
  * 
  * SAFETY WIRES:
  *   - D7 to GND: Primary safety (must remove to do anything)
@@ -22,11 +23,27 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <FrameProtocol.h>
 #include "../include/config.h"
+#include "bench_mode.h"
+#include "console.h"
 #include "display.h"
 #include "keyboard_utils.h"
 #include "i2c_scanner.h"
+#include "key_script.h"
 #include "error_handler.h"
+#include "log_buffer.h"
+#include "log_tokens.h"
+#include "payload_menu.h"
+#include "probes.h"
+#include "readiness.h"
+#include "serial_link.h"
+#include "settings.h"
+#include "telemetry.h"
+#include "timing_config.h"
+#include "touch_input.h"
+#include "usb_link.h"
+#include "wait_tuning.h"
 
 // ============================================
 // State tracking
@@ -34,6 +51,15 @@
 bool payloadExecuted = false;
 bool lcdAvailable = false;
 
+// Payload/profile chosen at arming (batch mode re-runs it)
+uint8_t armedPayload = PAYLOAD_BIOS;
+uint8_t armedProfile = PROFILE_TUNED;
+bool batchActive = false;
+
+// Run outcome feedback for the wait tuning
+bool runOutcomePending = false;
+unsigned long runFinishedAt = 0;
+
 // ============================================
 // Safety Wire Pins
 // ============================================
@@ -64,6 +90,42 @@ bool isWin10Mode() {
     return isSafety1Off() && isSafety2Off();
 }
 
+// Payload the wires select: D10 removed = Win10, otherwise BIOS
+// (or both chained when CHAIN_PAYLOADS is set)
+uint8_t wiredPayload() {
+    if (isWin10Mode()) return PAYLOAD_WIN10;
+    return CHAIN_PAYLOADS ? PAYLOAD_CHAIN : PAYLOAD_BIOS;
+}
+
+// True if this power-up would arm the chain: the wires select it, or
+// the menu's saved choice is the chain and D10 is still in
+bool isChainSelected() {
+    if (wiredPayload() == PAYLOAD_CHAIN) return true;
+    #if PAYLOAD_MENU
+    uint8_t payload, profile;
+    return !isWin10Mode() && loadMenuChoice(&payload, &profile) && payload == PAYLOAD_CHAIN;
+    #else
+    return false;
+    #endif
+}
+
+// Once armed, short D7 touches are gestures - only a wire held to GND
+// for SAFETY_RECONNECT_TIME counts as the safety going back on
+bool isSafetyReconnected() {
+    static unsigned long lowSince = 0;
+    static bool wasLow = false;
+    
+    if (isSafety1Off()) {
+        wasLow = false;
+        return false;
+    }
+    if (!wasLow) {
+        wasLow = true;
+        lowSince = millis();
+    }
+    return millis() - lowSince >= SAFETY_RECONNECT_TIME;
+}
+
 // ============================================
 // LED Status Functions
 // ============================================
@@ -137,11 +199,11 @@ bool waitForArmHold() {
         if (remaining != lastSecond) {
             lastSecond = remaining;
             lcd.setCursor(0, 0);
-            lcd.print("HOLD TO ARM:  ");
+            lcd.print(F("HOLD TO ARM:  "));
             lcd.print(remaining);
-            lcd.print("s");
+            lcd.print(F("s"));
             lcd.setCursor(0, 1);
-            lcd.print("Release=Cancel  ");
+            lcd.print(F("Release=Cancel  "));
             
             // Blink LED with countdown
             ledOn();
@@ -173,7 +235,7 @@ bool waitForArmHold() {
 // Phase 1: Boot Menu
 // ============================================
 void executeBootMenuPhase() {
-    showStatus("OPENING BIOS", "Spamming F12...");
+    showStatus(F("OPENING BIOS"), F("Spamming F12..."));
     
     // Spam F12 immediately and continuously for 10 seconds
     LiquidCrystal_I2C& lcd = getLCD();
@@ -187,9 +249,9 @@ void executeBootMenuPhase() {
         // Update LCD with countdown
         int remaining = (BOOT_SPAM_DURATION - (millis() - startTime)) / 1000;
         lcd.setCursor(13, 1);
-        if (remaining < 10) lcd.print(" ");
+        if (remaining < 10) lcd.print(F(" "));
         lcd.print(remaining);
-        lcd.print("s");
+        lcd.print(F("s"));
     }
     
     DEBUG_PRINT(F("Sent F12 "));
@@ -197,10 +259,10 @@ void executeBootMenuPhase() {
     DEBUG_PRINTLN(F(" times"));
     
     // Wait for boot menu to appear
-    showCountdown("BOOT MENU", "Waiting...", 3);
+    showCountdown(F("BOOT MENU"), F("Waiting..."), 3);
     
     // Navigate to 3rd option (DOWN twice) and select
-    showStatus("BOOT MENU", "Selecting USB..");
+    showStatus(F("BOOT MENU"), F("Selecting USB.."));
     pressDownMultiple(BOOT_MENU_POSITION);
     delay(500);
     pressKey(KEY_RETURN);
@@ -212,7 +274,7 @@ void executeBootMenuPhase() {
 // Phase 2: Wait for Windows Setup
 // ============================================
 void waitForWindowsSetup() {
-    showCountdown("WAITING", "Win Setup..", WIN_SETUP_WAIT);
+    showCountdown(F("WAITING"), F("Win Setup.."), WIN_SETUP_WAIT);
     DEBUG_PRINTLN(F("Windows Setup should be loaded"));
 }
 
@@ -223,17 +285,17 @@ void executeWindowsSetup() {
     const int TOTAL_STEPS = 5;
     
     // Step 1: Language Selection - Just press Enter (accept defaults)
-    showProgress(1, TOTAL_STEPS, "SETUP", "Language");
+    showProgress(1, TOTAL_STEPS, F("SETUP"), F("Language"));
     delay(SCREEN_DELAY);
     pressKey(KEY_RETURN);  // Click "Next"
     
     // Step 2: Install Now
-    showProgress(2, TOTAL_STEPS, "SETUP", "Install Now");
+    showProgress(2, TOTAL_STEPS, F("SETUP"), F("Install Now"));
     delay(SCREEN_DELAY);
     pressKey(KEY_RETURN);  // Click "Install now"
     
     // Step 3: Product Key - Skip it
-    showProgress(3, TOTAL_STEPS, "SETUP", "Skip Key");
+    showProgress(3, TOTAL_STEPS, F("SETUP"), F("Skip Key"));
     delay(SCREEN_DELAY);
     // Tab to "I don't have a product key" and press Enter
     pressKey(KEY_TAB);
@@ -241,7 +303,7 @@ void executeWindowsSetup() {
     pressKey(KEY_RETURN);
     
     // Step 4: License Terms - Accept
-    showProgress(4, TOTAL_STEPS, "SETUP", "License");
+    showProgress(4, TOTAL_STEPS, F("SETUP"), F("License"));
     delay(SCREEN_DELAY);
     pressKey(' ');         // Check "I accept" (spacebar)
     delay(200);
@@ -250,7 +312,7 @@ void executeWindowsSetup() {
     pressKey(KEY_RETURN);  // Click Next
     
     // Step 5: Installation Type - Select Custom
-    showProgress(5, TOTAL_STEPS, "SETUP", "Custom Install");
+    showProgress(5, TOTAL_STEPS, F("SETUP"), F("Custom Install"));
     delay(SCREEN_DELAY);
     // "Custom: Install Windows only (advanced)" is the second option
     pressKey(KEY_TAB);     // Tab to Custom option
@@ -264,7 +326,7 @@ void executeWindowsSetup() {
 // Phase 4: Partition Deletion
 // ============================================
 void executePartitionWipe() {
-    showStatus("WIPING DISK", "Deleting...");
+    showStatus(F("WIPING DISK"), F("Deleting..."));
     LiquidCrystal_I2C& lcd = getLCD();
     
     delay(SCREEN_DELAY);  // Wait for partition screen to load
@@ -275,9 +337,9 @@ void executePartitionWipe() {
     
     for (int attempt = 1; attempt <= DELETE_ATTEMPTS; attempt++) {
         lcd.setCursor(0, 1);
-        lcd.print("Deleting... #");
+        lcd.print(F("Deleting... #"));
         lcd.print(attempt);
-        lcd.print("   ");
+        lcd.print(F("   "));
         
         DEBUG_PRINT(F("Delete attempt "));
         DEBUG_PRINTLN(attempt);
@@ -306,7 +368,7 @@ void executePartitionWipe() {
 // Phase 5: Start Installation
 // ============================================
 void startInstallation() {
-    showStatus("STARTING", "Installing...");
+    showStatus(F("STARTING"), F("Installing..."));
     
     delay(SCREEN_DELAY);
     
@@ -340,29 +402,29 @@ void startInstallation() {
 // ============================================
 void executeOOBESetup() {
     // Wait for Windows installation to complete and OOBE to start
-    showCountdown("INSTALLING", "Wait for OOBE", OOBE_WAIT_TIME);
+    showCountdown(F("INSTALLING"), F("Wait for OOBE"), OOBE_WAIT_TIME);
     
     const int TOTAL_STEPS = 8;
     
     // Step 1: Region selection - accept default, click Yes
-    showProgress(1, TOTAL_STEPS, "OOBE", "Region");
+    showProgress(1, TOTAL_STEPS, F("OOBE"), F("Region"));
     delay(OOBE_SCREEN_DELAY);
     pressKey(KEY_RETURN);  // Yes/Next
     
     // Step 2: Keyboard layout - accept default, click Yes
-    showProgress(2, TOTAL_STEPS, "OOBE", "Keyboard");
+    showProgress(2, TOTAL_STEPS, F("OOBE"), F("Keyboard"));
     delay(OOBE_SCREEN_DELAY);
     pressKey(KEY_RETURN);  // Yes
     
     // Step 3: Second keyboard layout - Skip
-    showProgress(3, TOTAL_STEPS, "OOBE", "Skip 2nd KB");
+    showProgress(3, TOTAL_STEPS, F("OOBE"), F("Skip 2nd KB"));
     delay(OOBE_SCREEN_DELAY);
     pressKey(KEY_TAB);     // Tab to Skip
     delay(200);
     pressKey(KEY_RETURN);  // Skip
     
     // Step 4: Network - Skip (for offline setup)
-    showProgress(4, TOTAL_STEPS, "OOBE", "Skip Network");
+    showProgress(4, TOTAL_STEPS, F("OOBE"), F("Skip Network"));
     delay(OOBE_SCREEN_DELAY);
     // Press "I don't have internet" or skip
     pressKey(KEY_TAB);
@@ -375,14 +437,14 @@ void executeOOBESetup() {
     pressKey(KEY_RETURN);
     
     // Step 5: Enter username (use "Admin" or similar)
-    showProgress(5, TOTAL_STEPS, "OOBE", "Username");
+    showProgress(5, TOTAL_STEPS, F("OOBE"), F("Username"));
     delay(OOBE_SCREEN_DELAY);
     typeString("Admin");
     delay(200);
     pressKey(KEY_RETURN);  // Next
     
     // Step 6: Password - leave blank (no password)
-    showProgress(6, TOTAL_STEPS, "OOBE", "Skip Password");
+    showProgress(6, TOTAL_STEPS, F("OOBE"), F("Skip Password"));
     delay(OOBE_SCREEN_DELAY);
     // Don't type anything - just press Next for blank password
     pressKey(KEY_RETURN);  // Next (blank password)
@@ -392,7 +454,7 @@ void executeOOBESetup() {
     
     // Privacy settings - just accept defaults and click Accept
     delay(OOBE_SCREEN_DELAY * 2);  // Extra wait for privacy screen
-    showStatus("OOBE", "Privacy...");
+    showStatus(F("OOBE"), F("Privacy..."));
     
     // Tab through privacy toggles and click Accept
     for (int i = 0; i < 6; i++) {
@@ -421,7 +483,7 @@ void executePayload() {
     // Flash display to indicate starting
     if (lcdAvailable) flashDisplay(3, 200);
     
-    showStatus("\x03 ARMED \x03", "Executing...");
+    showStatus(F("\x03 ARMED \x03"), F("Executing..."));
     blinkLED(5, 100);  // Fast blink = running
     
     // Initialize keyboard HID
@@ -431,38 +493,38 @@ void executePayload() {
     // Note: There's no easy way to test this, but we log it
     DEBUG_PRINTLN(F("Keyboard HID initialized"));
     if (lcdAvailable) {
-        showStatus("HID KEYBOARD", "Initialized OK");
+        showStatus(F("HID KEYBOARD"), F("Initialized OK"));
         delay(500);
     }
     
     // PHASE 1: Boot Menu
     // NO DELAY - Start immediately to catch BIOS POST
-    showStatus("PHASE 1/6", "Boot Menu...");
+    showStatus(F("PHASE 1/6"), F("Boot Menu..."));
     delay(300);
     executeBootMenuPhase();
     
     // PHASE 2: Wait for Windows Setup to load
-    showStatus("PHASE 2/6", "Waiting...");
+    showStatus(F("PHASE 2/6"), F("Waiting..."));
     delay(300);
     waitForWindowsSetup();
     
     // PHASE 3: Navigate Windows Setup screens
-    showStatus("PHASE 3/6", "Win Setup Nav");
+    showStatus(F("PHASE 3/6"), F("Win Setup Nav"));
     delay(300);
     executeWindowsSetup();
     
     // PHASE 4: Delete all partitions
-    showStatus("PHASE 4/6", "Wiping Disk...");
+    showStatus(F("PHASE 4/6"), F("Wiping Disk..."));
     delay(300);
     executePartitionWipe();
     
     // PHASE 5: Start installation
-    showStatus("PHASE 5/6", "Installing...");
+    showStatus(F("PHASE 5/6"), F("Installing..."));
     delay(300);
     startInstallation();
     
     // PHASE 6: OOBE Setup (after Windows installs)
-    showStatus("PHASE 6/6", "OOBE Setup...");
+    showStatus(F("PHASE 6/6"), F("OOBE Setup..."));
     delay(300);
     executeOOBESetup();
     
@@ -525,7 +587,7 @@ void runScannerMode() {
         
         if (error == 0) {
             Serial.print(F("  >> FOUND device at 0x"));
-            if (addr < 16) Serial.print("0");
+            if (addr < 16) Serial.print(F("0"));
             Serial.print(addr, HEX);
             
             if (addr >= 0x20 && addr <= 0x27) {
@@ -550,7 +612,7 @@ void runScannerMode() {
         Serial.println();
         Serial.println(F("*** UPDATE config.h with: ***"));
         Serial.print(F("#define LCD_ADDRESS  0x"));
-        if (foundAddr < 16) Serial.print("0");
+        if (foundAddr < 16) Serial.print(F("0"));
         Serial.println(foundAddr, HEX);
         
         // Try to display on LCD
@@ -559,10 +621,10 @@ void runScannerMode() {
         lcd.backlight();
         lcd.clear();
         lcd.setCursor(0, 0);
-        lcd.print("Found: 0x");
+        lcd.print(F("Found: 0x"));
         lcd.print(foundAddr, HEX);
         lcd.setCursor(0, 1);
-        lcd.print("Adjust contrast!");
+        lcd.print(F("Adjust contrast!"));
         
         Serial.println();
         Serial.println(F("LCD initialized. If blank, adjust contrast potentiometer!"));
@@ -587,24 +649,39 @@ void runScannerMode() {
     }
 }
 
+// ============================================
+// Phase boundary: time it for telemetry, then let the Serial
+// console single-step. False once the run was aborted.
+// ============================================
+bool beginPhase(RunPhase phase) {
+    if (!consoleStep(phase)) return false;
+    telemetryPhase(phase);
+    return true;
+}
+
 // ============================================
 // BIOS Admin Password Removal Payload
 // Dell BIOS Navigation sequence (user-specified)
 // ============================================
 
 // Dynamic DOWN adjustment function
-// Waits for initial window, then adds DOWNs when D7 is touched
-// Each touch: press DOWN once and wait another 5 seconds
+// Applies the last confirmed extra-DOWN count for this payload right away,
+// then opens a window for corrections:
+//   Touch D7        = press DOWN, wait another 5 seconds
+//   Long touch D7   = press UP instead, wait another 5 seconds
+//   Double touch D7 = confirm and close the window now
+// A touch only moves once DOUBLE_TOUCH_WINDOW has passed without a
+// second one, so a double touch sends nothing to the target.
 // If no touch for the wait period, proceed
+// Only a confirmed count (double touch, console "skip") is saved for next time
 // Returns total number of extra DOWNs pressed
-int dynamicDownAdjustment(int initialWaitSec, int touchWaitSec, const char* title) {
-    const unsigned long INITIAL_WAIT = initialWaitSec * 1000UL;  // Initial wait (10 sec)
+int dynamicDownAdjustment(uint8_t payload, int initialWaitSec, int touchWaitSec, const __FlashStringHelper* title) {
     const unsigned long TOUCH_WAIT = touchWaitSec * 1000UL;      // Wait after each touch (5 sec)
     
-    unsigned long windowStart = millis();
-    unsigned long currentWait = INITIAL_WAIT;
+    // Known station: apply the saved position and only allow a short correction
+    int learned = loadBootPosition(payload);
+    int windowSec = (learned >= 0) ? ADJUST_CONFIRM_WINDOW : initialWaitSec;
     int extraDowns = 0;
-    bool wasConnected = false;
     
     if (lcdAvailable) {
         LiquidCrystal_I2C& lcd = getLCD();
@@ -612,14 +689,35 @@ int dynamicDownAdjustment(int initialWaitSec, int touchWaitSec, const char* titl
         lcd.setCursor(0, 0);
         lcd.print(title);
         lcd.setCursor(0, 1);
-        lcd.print("Touch D7    ");
-        lcd.print(initialWaitSec);
-        lcd.print("s");
+        if (learned >= 0) {
+            lcd.print(F("Saved +"));
+            lcd.print(learned);
+        } else {
+            lcd.print(F("Touch D7"));
+        }
+    }
+    if (learned >= 0) {
+        LOG_DEBUG(MSG_ADJUST_START, payload, (int16_t)learned);
+    } else {
+        LOG_DEBUG(MSG_ADJUST_UNSAVED, payload);
+    }
+    
+    if (learned > 0) {
+        for (int i = 0; i < learned; i++) {
+            pressKey(KEY_DOWN_ARROW);
+        }
+        extraDowns = learned;
     }
-    DEBUG_PRINT(F("Dynamic adjustment window: "));
-    DEBUG_PRINTLN(title);
+    
+    resetTouchInput();
+    unsigned long windowStart = millis();
+    unsigned long currentWait = windowSec * 1000UL;
+    bool confirmed = false;
+    bool pressPending = false;      // Touch seen, might still become a double
+    unsigned long pressTime = 0;
     
     while (true) {
+        PROBE_BEGIN(PROBE_ADJUST_LOOP);
         unsigned long elapsed = millis() - windowStart;
         int remaining = (currentWait - elapsed) / 1000;
         
@@ -629,66 +727,93 @@ int dynamicDownAdjustment(int initialWaitSec, int touchWaitSec, const char* titl
             break;
         }
         
-        // Check if D7 is touched to GND (LOW = connected)
-        bool isConnected = (digitalRead(SAFETY_PIN_1) == LOW);
+        // "skip" on the console takes the position as it is
+        if (pollConsoleWait() != CONSOLE_WAIT_NONE) {
+            confirmed = true;
+            break;
+        }
         
-        // Edge detection: register when wire connects to GND
-        if (isConnected && !wasConnected) {
-            // Touch detected! Press DOWN and reset timer
-            extraDowns++;
-            
-            DEBUG_PRINT(F("Touch detected! Pressing DOWN #"));
-            DEBUG_PRINTLN(extraDowns);
-            
-            // Visual feedback
+        TouchEvent touch = pollTouchInput();
+        bool moved = false;
+        
+        if (touch == TOUCH_DOUBLE) {
+            countRunTouch();
+            confirmed = true;
+            DEBUG_PRINTLN(F("Double touch - position confirmed"));
+            break;
+        }
+        
+        if (touch == TOUCH_PRESS) {
+            countRunTouch();
+            pressPending = true;
+            pressTime = millis();
+        } else if (touch == TOUCH_LONG) {
+            // Held: the press never moved, go one UP instead
+            pressPending = false;
             ledOn();
-            
-            // Press DOWN arrow
+            if (extraDowns > 0) {
+                pressKey(KEY_UP_ARROW);
+                extraDowns--;
+            }
+            moved = true;
+        } else if (pressPending && !isTouching() &&
+                   millis() - pressTime > DOUBLE_TOUCH_WINDOW) {
+            // No second touch came: it was a single one, press DOWN
+            pressPending = false;
+            ledOn();
+            extraDowns++;
             pressKey(KEY_DOWN_ARROW);
-            delay(200);
+            moved = true;
+        }
+        
+        if (moved) {
+            delay(Timing.adjustTouchGap);
             
             ledOff();
             
+            LOG_DEBUG(MSG_ADJUST_TOUCH, (int16_t)extraDowns);
+            
             // Update LCD
             if (lcdAvailable) {
                 LiquidCrystal_I2C& lcd = getLCD();
                 lcd.setCursor(0, 1);
-                lcd.print("+");
+                lcd.print(F("+"));
                 lcd.print(extraDowns);
-                lcd.print(" DOWN   ");
-                lcd.print(touchWaitSec);
-                lcd.print("s");
+                lcd.print(F(" DOWN      "));
             }
-            
+        }
+        if (touch == TOUCH_PRESS || moved) {
             // Reset timer for another wait period
             windowStart = millis();
             currentWait = TOUCH_WAIT;
         }
-        wasConnected = isConnected;
         
         // Update countdown on LCD
         if (lcdAvailable) {
             LiquidCrystal_I2C& lcd = getLCD();
             lcd.setCursor(12, 1);
-            if (remaining < 10) lcd.print(" ");
+            if (remaining < 10) lcd.print(F(" "));
             lcd.print(remaining);
-            lcd.print("s");
+            lcd.print(F("s"));
         }
         
-        delay(50);  // Poll every 50ms
+        PROBE_END(PROBE_ADJUST_LOOP);
+        delay(20);  // Poll every 20ms
     }
     
+    if (isRunAborted()) return extraDowns;     // Don't learn from a stopped run
+    if (confirmed) saveBootPosition(payload, extraDowns);
+    
     // Window complete - show result briefly
     if (lcdAvailable) {
         LiquidCrystal_I2C& lcd = getLCD();
         lcd.setCursor(0, 1);
-        lcd.print("Done: +");
+        lcd.print(confirmed ? F("OK: +") : F("Done: +"));
         lcd.print(extraDowns);
-        lcd.print(" DOWNs  ");
+        lcd.print(F(" DOWNs  "));
     }
-    DEBUG_PRINT(F("Dynamic adjustment done. Extra DOWNs: "));
-    DEBUG_PRINTLN(extraDowns);
-    delay(500);
+    LOG_INFO(MSG_ADJUST_DONE, (int16_t)extraDowns, (uint8_t)confirmed);
+    delay(Timing.adjustDoneWait);
     
     return extraDowns;
 }
@@ -704,8 +829,9 @@ void executeBIOSPasswordRemoval() {
     // ==========================================
     // PHASE 1: Spam F2 to enter BIOS Setup
     // ==========================================
+    if (!beginPhase(PHASE_BOOT_SPAM)) return;
     if (lcdAvailable) {
-        showStatus("ENTERING BIOS", "Spamming F2...");
+        showStatus(F("ENTERING BIOS"), F("Spamming F2..."));
     }
     DEBUG_PRINTLN(F("Spamming F2 to enter BIOS Setup..."));
     
@@ -713,18 +839,21 @@ void executeBIOSPasswordRemoval() {
     int keyCount = 0;
     
     // Spam F2 for 10 seconds to catch BIOS POST
-    while (millis() - startTime < BOOT_SPAM_DURATION) {
+    while (millis() - startTime < Timing.bootSpamDuration) {
         pressKey(KEY_F2);  // F2 for Dell BIOS Setup
         keyCount++;
         
+        // "skip" on the console: BIOS is already up
+        if (pollConsoleWait() != CONSOLE_WAIT_NONE) break;
+        
         // Update LCD with countdown if available
         if (lcdAvailable) {
             LiquidCrystal_I2C& lcd = getLCD();
-            int remaining = (BOOT_SPAM_DURATION - (millis() - startTime)) / 1000;
+            int remaining = (Timing.bootSpamDuration - (millis() - startTime)) / 1000;
             lcd.setCursor(13, 1);
-            if (remaining < 10) lcd.print(" ");
+            if (remaining < 10) lcd.print(F(" "));
             lcd.print(remaining);
-            lcd.print("s");
+            lcd.print(F("s"));
         }
     }
     
@@ -733,148 +862,142 @@ void executeBIOSPasswordRemoval() {
     DEBUG_PRINTLN(F(" times"));
     
     // ==========================================
-    // PHASE 2: Wait for BIOS to fully load
+    // PHASE 2: Wait for BIOS to fully load (tuned, 5s default)
+    // Still PHASE_BOOT_SPAM: getting into BIOS Setup
     // ==========================================
     if (lcdAvailable) {
-        showStatus("BIOS LOADING", "Waiting...");
+        showStatus(F("BIOS LOADING"), F("Waiting..."));
     }
     DEBUG_PRINTLN(F("Waiting for BIOS to load..."));
     
-    // Countdown for 5 seconds
-    for (int i = 5; i > 0; i--) {
-        if (lcdAvailable) {
-            LiquidCrystal_I2C& lcd = getLCD();
-            lcd.setCursor(14, 1);
-            lcd.print(i);
-            lcd.print("s");
-        }
-        delay(1000);
-    }
+    tunedDelay(WAIT_BIOS_LOAD);
     
     // ==========================================
     // PHASE 3: Initial navigation - Down 5 times
     // ==========================================
+    if (!beginPhase(PHASE_BIOS_NAV)) return;
     if (lcdAvailable) {
-        showStatus("NAVIGATING", "Down 5...");
+        showStatus(F("NAVIGATING"), F("Down 5..."));
     }
     DEBUG_PRINTLN(F("Navigating BIOS - Down 5 times"));
     
     for (int i = 0; i < 5; i++) {
         pressKey(KEY_DOWN_ARROW);
-        delay(300);
+        delay(Timing.navKeyGap);
         
         if (lcdAvailable) {
             LiquidCrystal_I2C& lcd = getLCD();
             lcd.setCursor(11, 1);
             lcd.print(i + 1);
-            lcd.print("/5");
+            lcd.print(F("/5"));
         }
     }
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // ==========================================
     // PHASE 4: Dynamic adjustment window
-    // Wait 10s, touch D7 to add DOWN + 5s more
+    // Saved position is applied at once, then 4s to correct
+    // (first run: wait 10s, touch D7 to add DOWN + 5s more)
     // ==========================================
-    int extraDowns = dynamicDownAdjustment(10, 5, "BIOS ADJUST");
-    DEBUG_PRINT(F("Total extra DOWNs from adjustment: "));
-    DEBUG_PRINTLN(extraDowns);
+    if (!beginPhase(PHASE_ADJUST)) return;
+    dynamicDownAdjustment(PAYLOAD_BIOS, 10, 5, F("BIOS ADJUST"));  // Logs MSG_ADJUST_DONE
     
     // ==========================================
     // PHASE 5: Continue BIOS navigation
-    // Enter, Down 1, Tab, Enter
+    // Enter, Down 1, Tab, Enter (adds to the Down 5 time)
     // ==========================================
+    if (!beginPhase(PHASE_BIOS_NAV)) return;
     if (lcdAvailable) {
-        showStatus("BIOS NAV", "Selecting...");
+        showStatus(F("BIOS NAV"), F("Selecting..."));
     }
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(500);
+    tunedDelay(WAIT_BIOS_DIALOG);
     
     // Down once
     pressKey(KEY_DOWN_ARROW);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Tab
     pressKey(KEY_TAB);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(500);
+    tunedDelay(WAIT_BIOS_DIALOG);
     
     // ==========================================
     // PHASE 6: Enter OLD password
     // Type ls3gt1, Tab, Enter
     // ==========================================
     if (lcdAvailable) {
-        showStatus("OLD PASSWORD", "Typing...");
+        showStatus(F("OLD PASSWORD"), F("Typing..."));
     }
     DEBUG_PRINTLN(F("Entering old password: ls3gt1"));
     
     typeString("ls3gt1");
-    delay(200);
+    delay(Timing.typeSettle);
     
     // Tab
     pressKey(KEY_TAB);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(500);
+    tunedDelay(WAIT_BIOS_DIALOG);
     
     // ==========================================
     // PHASE 5: Confirm/Clear password
     // Tab, ls3gt1, Tab 3 times, Enter
     // ==========================================
     if (lcdAvailable) {
-        showStatus("CONFIRMING", "Password...");
+        showStatus(F("CONFIRMING"), F("Password..."));
     }
     DEBUG_PRINTLN(F("Confirming password change..."));
     
     // Tab
     pressKey(KEY_TAB);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Type ls3gt1 again
     typeString("ls3gt1");
-    delay(200);
+    delay(Timing.typeSettle);
     
     // Tab 3 times
     for (int i = 0; i < 3; i++) {
         pressKey(KEY_TAB);
-        delay(300);
+        delay(Timing.navKeyGap);
     }
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(500);
+    tunedDelay(WAIT_BIOS_DIALOG);
     
     // ==========================================
     // PHASE 6: Final confirmation
     // Tab 2 times, Enter
     // ==========================================
     if (lcdAvailable) {
-        showStatus("SAVING", "Confirming...");
+        showStatus(F("SAVING"), F("Confirming..."));
     }
     DEBUG_PRINTLN(F("Final confirmation..."));
     
     // Tab 2 times
     for (int i = 0; i < 2; i++) {
         pressKey(KEY_TAB);
-        delay(300);
+        delay(Timing.navKeyGap);
     }
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(500);
+    tunedDelay(WAIT_BIOS_DIALOG);
     
     // ==========================================
     // COMPLETE
     // ==========================================
     if (lcdAvailable) {
-        showStatus("PASS REMOVED!", "Rebooting...");
+        showStatus(F("PASS REMOVED!"), F("Rebooting..."));
     }
     
     DEBUG_PRINTLN(F("\n========================================"));
@@ -900,25 +1023,29 @@ void executeWindows10Install() {
     // ==========================================
     // STEP 1: Spam F12 for 10 seconds
     // ==========================================
+    if (!beginPhase(PHASE_BOOT_SPAM)) return;
     if (lcdAvailable) {
-        showStatus("BOOT MENU", "Spamming F12...");
+        showStatus(F("BOOT MENU"), F("Spamming F12..."));
     }
     DEBUG_PRINTLN(F("Spamming F12 for 10 seconds..."));
     
     unsigned long startTime = millis();
     int keyCount = 0;
     
-    while (millis() - startTime < BOOT_SPAM_DURATION) {
+    while (millis() - startTime < Timing.bootSpamDuration) {
         pressKey(KEY_F12);
         keyCount++;
         
+        // "skip" on the console: boot menu is already up
+        if (pollConsoleWait() != CONSOLE_WAIT_NONE) break;
+        
         if (lcdAvailable) {
             LiquidCrystal_I2C& lcd = getLCD();
-            int remaining = (BOOT_SPAM_DURATION - (millis() - startTime)) / 1000;
+            int remaining = (Timing.bootSpamDuration - (millis() - startTime)) / 1000;
             lcd.setCursor(13, 1);
-            if (remaining < 10) lcd.print(" ");
+            if (remaining < 10) lcd.print(F(" "));
             lcd.print(remaining);
-            lcd.print("s");
+            lcd.print(F("s"));
         }
     }
     
@@ -929,118 +1056,109 @@ void executeWindows10Install() {
     // ==========================================
     // STEP 2: Down 1 time (initial position)
     // ==========================================
+    if (!beginPhase(PHASE_ADJUST)) return;
     if (lcdAvailable) {
-        showStatus("BOOT MENU", "Down 1...");
+        showStatus(F("BOOT MENU"), F("Down 1..."));
     }
     DEBUG_PRINTLN(F("Down 1 time..."));
     
     pressKey(KEY_DOWN_ARROW);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // ==========================================
     // STEP 3: Dynamic adjustment window for USB
-    // Wait 10s, touch D7 to add DOWN + 5s more
+    // Saved position is applied at once, then 4s to correct
+    // (first run: wait 10s, touch D7 to add DOWN + 5s more)
     // USB position varies so this allows dynamic selection
     // ==========================================
-    int extraDowns = dynamicDownAdjustment(10, 5, "USB ADJUST");
-    DEBUG_PRINT(F("Total extra DOWNs from adjustment: "));
-    DEBUG_PRINTLN(extraDowns);
+    dynamicDownAdjustment(PAYLOAD_WIN10, 10, 5, F("USB ADJUST"));  // Logs MSG_ADJUST_DONE
     
     // ==========================================
     // STEP 4: Enter to select boot device
     // ==========================================
     if (lcdAvailable) {
-        showStatus("BOOT MENU", "Selecting...");
+        showStatus(F("BOOT MENU"), F("Selecting..."));
     }
     DEBUG_PRINTLN(F("Enter to select..."));
     pressKey(KEY_RETURN);
     
     // ==========================================
-    // STEP 4: Wait 30 seconds
+    // STEP 4: Wait for Windows Setup (tuned max, 30s default)
+    // Num Lock probe ends the wait once WinPE has re-enumerated us
+    // and echoes
     // ==========================================
+    if (!beginPhase(PHASE_SETUP_LOAD)) return;
     if (lcdAvailable) {
-        showStatus("LOADING", "Win Setup...");
-    }
-    DEBUG_PRINTLN(F("Waiting 30 seconds..."));
-    
-    for (int i = 30; i > 0; i--) {
-        if (lcdAvailable) {
-            LiquidCrystal_I2C& lcd = getLCD();
-            lcd.setCursor(13, 1);
-            if (i < 10) lcd.print(" ");
-            lcd.print(i);
-            lcd.print("s");
-        }
-        delay(1000);
+        showStatus(F("LOADING"), F("Win Setup..."));
     }
+    DEBUG_PRINTLN(F("Waiting for Windows Setup..."));
+    waitForTargetReady(READY_MIN_SETUP_LOAD, WAIT_SETUP_LOAD, lcdAvailable);
     
     // ==========================================
     // STEP 5: Tab 3 times
     // ==========================================
+    if (!beginPhase(PHASE_SETUP)) return;
     if (lcdAvailable) {
-        showStatus("SETUP", "Tab 3...");
+        showStatus(F("SETUP"), F("Tab 3..."));
     }
     DEBUG_PRINTLN(F("Tab 3 times..."));
     
     for (int i = 0; i < 3; i++) {
         pressKey(KEY_TAB);
-        delay(200);
+        delay(Timing.setupTabGap);
     }
     
     // ==========================================
     // STEP 6: Enter 2 times
     // ==========================================
     if (lcdAvailable) {
-        showStatus("SETUP", "Enter 2...");
+        showStatus(F("SETUP"), F("Enter 2..."));
     }
     DEBUG_PRINTLN(F("Enter 2 times..."));
     
     pressKey(KEY_RETURN);
-    delay(300);
+    delay(Timing.navKeyGap);
     pressKey(KEY_RETURN);
     
     // ==========================================
-    // STEP 7: Wait 30 seconds
+    // STEP 7: Wait for license screen (tuned, 30s default)
+    // Fixed: WinPE echoes Num Lock on every screen
     // ==========================================
     if (lcdAvailable) {
-        showStatus("SETUP", "Waiting...");
-    }
-    DEBUG_PRINTLN(F("Waiting 30 seconds..."));
-    
-    for (int i = 30; i > 0; i--) {
-        if (lcdAvailable) {
-            LiquidCrystal_I2C& lcd = getLCD();
-            lcd.setCursor(13, 1);
-            if (i < 10) lcd.print(" ");
-            lcd.print(i);
-            lcd.print("s");
-        }
-        delay(1000);
+        showStatus(F("SETUP"), F("Waiting..."));
     }
+    DEBUG_PRINTLN(F("Waiting for license screen..."));
+    tunedDelay(WAIT_SETUP_SCREEN);
     
     // ==========================================
     // STEP 8: Space, Enter, Down, Enter
     // ==========================================
     if (lcdAvailable) {
-        showStatus("SETUP", "License...");
+        showStatus(F("SETUP"), F("License..."));
     }
     DEBUG_PRINTLN(F("Space, Enter, Down, Enter..."));
     
     // Space
     pressKey(' ');
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Down
     pressKey(KEY_DOWN_ARROW);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Enter
     pressKey(KEY_RETURN);
-    delay(2000);  // Wait for partition screen to load
+    
+    // Wait for the partition list to load and populate (tuned, 4s default)
+    if (!beginPhase(PHASE_PARTITIONS)) return;
+    if (lcdAvailable) {
+        showStatus(F("WIPING DISK"), F("Partitions..."));
+    }
+    tunedDelay(WAIT_PARTITION_LOAD);
     
     // ==========================================
     // STEP 9: Delete ALL Partitions - SMART ALGORITHM
@@ -1048,25 +1166,23 @@ void executeWindows10Install() {
     // Strategy: Sweep up and down through the list, trying to delete at each position
     // ==========================================
     if (lcdAvailable) {
-        showStatus("WIPING DISK", "Smart delete...");
+        showStatus(F("WIPING DISK"), F("Smart delete..."));
     }
     DEBUG_PRINTLN(F("Starting smart partition deletion..."));
     
-    delay(2000);  // Wait for partition list to fully populate
-    
     const int MAX_SWEEPS = 4;         // Number of up/down sweeps
     int totalAttempts = 0;
     
     // First, go to top of list
     for (int i = 0; i < 10; i++) {
         pressKey(KEY_UP_ARROW);
-        delay(80);
+        delay(Timing.listStepGap);
     }
-    delay(200);
+    delay(Timing.listSettle);
     
     // Skip the drive header - move down once
     pressKey(KEY_DOWN_ARROW);
-    delay(200);
+    delay(Timing.listSettle);
     
     // Perform sweeps: down then up, repeat
     for (int sweep = 0; sweep < MAX_SWEEPS; sweep++) {
@@ -1076,13 +1192,13 @@ void executeWindows10Install() {
             LiquidCrystal_I2C& lcd = getLCD();
             lcd.clear();
             lcd.setCursor(0, 0);
-            lcd.print("SWEEP ");
+            lcd.print(F("SWEEP "));
             lcd.print(sweep + 1);
-            lcd.print("/");
+            lcd.print(F("/"));
             lcd.print(MAX_SWEEPS);
-            lcd.print(goingDown ? " DN" : " UP");
+            lcd.print(goingDown ? F(" DN") : F(" UP"));
             lcd.setCursor(0, 1);
-            lcd.print("Deleting...");
+            lcd.print(F("Deleting..."));
         }
         
         DEBUG_PRINT(F("Sweep "));
@@ -1091,15 +1207,16 @@ void executeWindows10Install() {
         
         // Try to delete at each position in this sweep
         for (int pos = 0; pos < 8; pos++) {
+            if (isRunAborted()) return;
             totalAttempts++;
             
             // Update LCD with position
             if (lcdAvailable) {
                 LiquidCrystal_I2C& lcd = getLCD();
                 lcd.setCursor(11, 1);
-                lcd.print("P");
+                lcd.print(F("P"));
                 lcd.print(pos + 1);
-                lcd.print(" ");
+                lcd.print(F(" "));
             }
             
             // DELETE SEQUENCE:
@@ -1111,23 +1228,23 @@ void executeWindows10Install() {
             
             // TAB to change to delete panel
             pressKey(KEY_TAB);
-            delay(400);
+            delay(Timing.deleteKeyGap);
             
             // RIGHT to delete button
             pressKey(KEY_RIGHT_ARROW);
-            delay(400);
+            delay(Timing.deleteKeyGap);
             
             // ENTER to click delete
             pressKey(KEY_RETURN);
-            delay(500);
+            tunedDelay(WAIT_DELETE_CLICK);
             
             // TAB to OK button
             pressKey(KEY_TAB);
-            delay(300);
+            delay(Timing.navKeyGap);
             
             // ENTER to confirm
             pressKey(KEY_RETURN);
-            delay(600);
+            tunedDelay(WAIT_DELETE_CONFIRM);
             
             // Move to next partition row (UP or DOWN)
             if (goingDown) {
@@ -1135,7 +1252,7 @@ void executeWindows10Install() {
             } else {
                 pressKey(KEY_UP_ARROW);
             }
-            delay(300);
+            delay(Timing.navKeyGap);
         }
         
         // After each sweep, go to opposite end to start next sweep
@@ -1143,56 +1260,57 @@ void executeWindows10Install() {
             // We were going down, now go to top for up sweep
             for (int i = 0; i < 10; i++) {
                 pressKey(KEY_UP_ARROW);
-                delay(60);
+                delay(Timing.listFastGap);
             }
             pressKey(KEY_DOWN_ARROW);  // Skip header
-            delay(100);
+            delay(Timing.headerSkipGap);
         } else {
             // We were going up, now go to bottom for down sweep
             for (int i = 0; i < 10; i++) {
                 pressKey(KEY_DOWN_ARROW);
-                delay(60);
+                delay(Timing.listFastGap);
             }
         }
-        delay(200);
+        delay(Timing.listSettle);
     }
     
     DEBUG_PRINT(F("Smart deletion complete. Total attempts: "));
     DEBUG_PRINTLN(totalAttempts);
     
     // Final cleanup - select unallocated space and start install
+    if (!beginPhase(PHASE_INSTALL)) return;
     if (lcdAvailable) {
-        showStatus("FINALIZING", "Starting...");
+        showStatus(F("FINALIZING"), F("Starting..."));
     }
     DEBUG_PRINTLN(F("Selecting unallocated space and starting install..."));
     
     // Go to top
     for (int i = 0; i < 10; i++) {
         pressKey(KEY_UP_ARROW);
-        delay(80);
+        delay(Timing.listStepGap);
     }
     
     // Select first item (should be unallocated space)
     pressKey(KEY_DOWN_ARROW);
-    delay(300);
+    delay(Timing.navKeyGap);
     
     // Tab to Next button and press Enter
     for (int i = 0; i < 6; i++) {
         pressKey(KEY_TAB);
-        delay(120);
+        delay(Timing.nextTabGap);
     }
     pressKey(KEY_RETURN);
-    delay(800);
+    tunedDelay(WAIT_INSTALL_START);
     
     // Press Enter again in case of any confirmation dialog
     pressKey(KEY_RETURN);
-    delay(500);
+    delay(Timing.finalEnterWait);
     
     // ==========================================
     // COMPLETE
     // ==========================================
     if (lcdAvailable) {
-        showStatus("DONE!", "Install started");
+        showStatus(F("DONE!"), F("Install started"));
     }
     
     DEBUG_PRINTLN(F("\n========================================"));
@@ -1203,6 +1321,292 @@ void executeWindows10Install() {
     payloadExecuted = true;
 }
 
+// ============================================
+// Chained BIOS Password -> Windows 10 Install
+// One arm cycle for machines that need both: clear the password,
+// wait for the target to reboot, then go straight into the F12
+// boot-menu phase of the Win10 install.
+// The pending stage is kept in EEPROM so that if the reboot also cuts
+// our USB power, setup() resumes the install on the next power-up
+// (that one only, and only if the wires still select the chain).
+// Returns false if the target never came back
+// ============================================
+bool executeChainedInstall() {
+    executeBIOSPasswordRemoval();
+    if (isRunAborted()) return false;
+    
+    saveChainStage(CHAIN_STAGE_WIN10, getRunCount());
+    telemetryPhase(PHASE_REBOOT);
+    bool rebooted = waitForUsbReenumeration(F("CHAIN: REBOOT"), CHAIN_REBOOT_TIMEOUT);
+    saveChainStage(CHAIN_STAGE_NONE, 0);
+    
+    if (!rebooted) {
+        // Don't send Win10 keys into a screen we know nothing about
+        if (lcdAvailable) {
+            showStatus(F("CHAIN STOPPED"), F("No reboot seen"));
+        }
+        LOG_WARN(MSG_CHAIN_NO_REBOOT);
+        return false;
+    }
+    
+    // Target is in POST right now - F12 spam starts immediately
+    executeWindows10Install();
+    return true;
+}
+
+// ============================================
+// Run Outcome (feedback for the wait tuning)
+// After a payload the technician has RUN_OUTCOME_WINDOW to double
+// touch D7 if the run went wrong; otherwise it counts as good.
+// ============================================
+void beginRunOutcomeWindow() {
+    runOutcomePending = true;
+    runFinishedAt = millis();
+    resetTouchInput();
+    Log.println(F("Double touch D7 if this run FAILED"));
+}
+
+// Call while idle after a run
+void pollRunOutcome() {
+    if (!runOutcomePending) return;
+    
+    if (pollTouchInput() == TOUCH_DOUBLE) {
+        runOutcomePending = false;
+        setRunOutcome(false);
+        finishTuningRun(false);
+        if (lcdAvailable) {
+            showStatus(F("RUN FAILED"), F("Waits increased"));
+        }
+    } else if (millis() - runFinishedAt >= RUN_OUTCOME_WINDOW) {
+        runOutcomePending = false;
+        setRunOutcome(true);
+        finishTuningRun(true);
+    }
+}
+
+// Next run is starting - no failure reported means success
+void settleRunOutcome() {
+    if (runOutcomePending) {
+        runOutcomePending = false;
+        setRunOutcome(true);
+        finishTuningRun(true);
+    }
+}
+
+// ============================================
+// Run the payload selected at arming
+// Returns false if it stopped early
+// ============================================
+bool executeArmedPayload(bool resumeChain) {
+    beginRunTelemetry(armedPayload, armedProfile);
+    beginConsoleRun();
+    setLinkState(FRAME_STATE_RUNNING, armedPayload, armedProfile);
+    setLogRealtime(!DEMO_MODE);     // Drop log output rather than delay a key
+    bool completed = true;
+    
+    if (resumeChain) {
+        // Power came back after the chained reboot - straight to F12
+        LOG_INFO(MSG_CHAIN_RESUMED);
+        executeWindows10Install();
+        
+        if (lcdAvailable) {
+            showStatus(F("DONE!"), F("Win10 wipe done"));
+        }
+    } else if (armedPayload == PAYLOAD_CHAIN) {
+        // Both payloads in one run
+        DEBUG_PRINTLN(F("Executing chained BIOS password + Win10 install..."));
+        completed = executeChainedInstall();
+        if (completed && lcdAvailable) {
+            showStatus(F("DONE!"), F("Pass+Win10 done"));
+        }
+    } else if (armedPayload == PAYLOAD_SCRIPT) {
+        // Key script taught over the Serial console
+        DEBUG_PRINTLN(F("Replaying taught key script..."));
+        completed = replayKeyScript();
+        payloadExecuted = true;
+        if (completed && lcdAvailable) {
+            showStatus(F("DONE!"), F("Script replayed"));
+        }
+    } else if (armedPayload == PAYLOAD_WIN10) {
+        // Windows 10 Install mode
+        DEBUG_PRINTLN(F("Executing Windows 10 clean install..."));
+        executeWindows10Install();
+        
+        if (lcdAvailable) {
+            showStatus(F("DONE!"), F("Win10 wipe done"));
+        }
+    } else {
+        // BIOS Password Removal mode
+        DEBUG_PRINTLN(F("Executing BIOS password removal..."));
+        executeBIOSPasswordRemoval();
+        
+        if (lcdAvailable) {
+            showStatus(F("COMPLETE!"), F("Password removed"));
+        }
+    }
+    
+    if (isRunAborted()) {
+        // The payload returned at the abort - it never got to its end
+        completed = false;
+        payloadExecuted = true;
+        if (lcdAvailable) {
+            showStatus(F("ABORTED"), F("Serial console"));
+        }
+        LOG_INFO(MSG_RUN_ABORTED);
+    }
+    
+    setLinkState(FRAME_STATE_DONE, armedPayload, armedProfile);
+    setLogRealtime(false);
+    endRunTelemetry(completed);
+    return completed;
+}
+
+// ============================================
+// Run again from the Serial console ("arm", "go <token>")
+// Same as the armed run in setup(), without rewiring or rebooting.
+// The console already checked that D7 is out.
+// ============================================
+void executeConsoleRun() {
+    settleRunOutcome();
+    setWaitProfile(armedProfile);
+    
+    Log.print(F("\nConsole run: "));
+    Log.print(getPayloadName(armedPayload));
+    Log.print(F(" / "));
+    Log.println(getProfileName(armedProfile));
+    if (lcdAvailable) {
+        showStatus(F("!! ARMED !!"), F("From Serial..."));
+    }
+    blinkLED(3, 100);
+    
+    payloadExecuted = false;
+    executeArmedPayload(false);
+    beginRunOutcomeWindow();
+    ledOn();
+}
+
+// ============================================
+// D7 came out while a terminal was on the console: nothing runs by
+// itself, loop() waits for console commands
+// ============================================
+void enterConsoleIdle() {
+    armedPayload = wiredPayload();
+    setLinkState(FRAME_STATE_DONE, armedPayload, armedProfile);
+    payloadExecuted = true;
+    Log.println(F("\n  D7 removed - console attached, nothing runs until go/teach"));
+    if (lcdAvailable) {
+        showStatus(F("CONSOLE IDLE"), F("arm/go or teach"));
+    }
+}
+
+// ============================================
+// SAFETY ON: slow blink until D7 is removed
+// ============================================
+void waitForSafetyOff() {
+    setLinkState(FRAME_STATE_SAFE, armedPayload, armedProfile);
+    uint8_t page = 0;
+    while (true) {
+        ledOn();
+        delay(1000);
+        ledOff();
+        delay(1000);
+        
+        // Page through the tuned waits between reminders
+        if (lcdAvailable) {
+            LiquidCrystal_I2C& lcd = getLCD();
+            lcd.setCursor(0, 1);
+            if (page == 0) {
+                lcd.print(F("Remove D7 wire  "));
+            } else {
+                printTunedWaitLCD(page - 1);
+            }
+            page = (page + 1) % (WAIT_STEP_COUNT + 1);
+        }
+        
+        // Check if primary wire was removed
+        if (isSafetyOff()) {
+            Log.println(F("  D7 removed - ARMING!"));
+            return;
+        }
+        
+        pollSerialLink();
+    }
+}
+
+#if BATCH_MODE
+// ============================================
+// Batch Mode: next machine
+// Waits for the finished machine to be unplugged and the next one to
+// enumerate us, then checks the wires are still as they were armed.
+// Returns false (batch stops) if D7 went back in or D10 moved
+// ============================================
+bool waitForNextMachine() {
+    uint16_t machinesDone = loadMachineCount();
+    
+    if (lcdAvailable) {
+        LiquidCrystal_I2C& lcd = getLCD();
+        lcd.clear();
+        lcd.setCursor(0, 0);
+        lcd.print(F("DONE: "));
+        lcd.print(machinesDone);
+        lcd.print(F(" PCs"));
+        lcd.setCursor(0, 1);
+        lcd.print(F("Unplug -> next"));
+    }
+    Log.print(F("Batch: "));
+    Log.print(machinesDone);
+    Log.println(F(" machines done - unplug for next"));
+    
+    // Wait for this machine to let go of us
+    while (isUsbPowered() && isUsbConfigured()) {
+        if (isSafetyReconnected()) return false;
+        pollRunOutcome();
+        delay(20);
+    }
+    
+    if (lcdAvailable) {
+        showStatus(F("UNPLUGGED"), F("Plug next PC..."));
+    }
+    Log.println(F("Batch: unplugged, waiting for next target"));
+    
+    // Wait for the next target to power and configure us
+    unsigned long lastBlink = 0;
+    while (!(isUsbPowered() && isUsbConfigured())) {
+        if (isSafetyReconnected()) return false;
+        pollRunOutcome();
+        if (millis() - lastBlink > 500) {
+            lastBlink = millis();
+            digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+        }
+        delay(5);  // Enumeration happens during POST - react fast
+    }
+    
+    #if !PAYLOAD_MENU
+    // Same wires as armed, or nothing runs
+    if (wiredPayload() != armedPayload) {
+        if (lcdAvailable) {
+            showStatus(F("WIRES CHANGED"), F("D10 moved-stop"));
+        }
+        Log.println(F("Batch stopped - D10 changed since arming"));
+        return false;
+    }
+    #endif
+    
+    if (lcdAvailable) {
+        LiquidCrystal_I2C& lcd = getLCD();
+        lcd.clear();
+        lcd.setCursor(0, 0);
+        lcd.print(F("RE-ARMED"));
+        lcd.setCursor(0, 1);
+        lcd.print(F("Machine #"));
+        lcd.print(machinesDone + 1);
+    }
+    Log.print(F("Batch: re-armed for machine #"));
+    Log.println(machinesDone + 1);
+    return true;
+}
+#endif
+
 // ============================================
 // Setup
 // ============================================
@@ -1212,20 +1616,24 @@ void setup() {
     pinMode(SAFETY_PIN_2, INPUT_PULLUP);  // D10 - mode select
     pinMode(LED_PIN, OUTPUT);
     ledOff();
+    initTouchInput();
+    
+    // Station timing from EEPROM before anything presses a key
+    loadTimingConfig();
     
     // Initialize serial for debugging
     Serial.begin(SERIAL_BAUD_RATE);
     delay(100);  // Brief delay for serial
     
-    Serial.println(F("\n===================================="));
-    Serial.println(F(" BIOS/WIN10 MULTI-TOOL DEVICE"));
-    Serial.println(F(" D7 removed = BIOS password"));
-    Serial.println(F(" D7+D10 removed = Win10 install"));
+    Log.println(F("\n===================================="));
+    Log.println(F(" BIOS/WIN10 MULTI-TOOL DEVICE"));
+    Log.println(F(" D7 removed = BIOS password"));
+    Log.println(F(" D7+D10 removed = Win10 install"));
     #if DEMO_MODE
-    Serial.println(F("    *** DEMO MODE ACTIVE ***"));
-    Serial.println(F("  (No keystrokes will be sent)"));
+    Log.println(F("    *** DEMO MODE ACTIVE ***"));
+    Log.println(F("  (No keystrokes will be sent)"));
     #endif
-    Serial.println(F("====================================\n"));
+    Log.println(F("====================================\n"));
     
     // Check for I2C scan mode
     #if I2C_SCAN_MODE
@@ -1233,18 +1641,24 @@ void setup() {
         return;  // Never reaches here
     #endif
     
+    // Check for bench mode
+    #if BENCH_MODE
+        runBenchMode();
+        return;  // Never reaches here
+    #endif
+    
     // ==========================================
     // HARDWARE CHECKS
     // ==========================================
-    Serial.println(F("Running hardware checks..."));
+    Log.println(F("Running hardware checks..."));
     
     // Check 1: Try to initialize display
     lcdAvailable = initDisplay();
     
     if (!lcdAvailable) {
         // LCD not found - check if it's wiring or wrong address
-        Serial.println(F("LCD NOT FOUND!"));
-        Serial.println(F("Checking I2C bus..."));
+        Log.println(F("LCD NOT FOUND!"));
+        Log.println(F("Checking I2C bus..."));
         
         Wire.begin();
         bool foundAny = false;
@@ -1255,38 +1669,46 @@ void setup() {
             if (Wire.endTransmission() == 0) {
                 foundAny = true;
                 foundAddr = addr;
-                Serial.print(F("  Found device at 0x"));
-                Serial.println(addr, HEX);
+                Log.print(F("  Found device at 0x"));
+                Log.println(addr, HEX);
             }
         }
         
         if (!foundAny) {
             // No I2C devices at all - wiring issue
-            Serial.println(F("\nERROR E01: LCD NOT CONNECTED"));
-            Serial.println(F("Check wiring:"));
-            Serial.println(F("  SDA -> Pin 2"));
-            Serial.println(F("  SCL -> Pin 3"));
-            Serial.println(F("  VCC -> 5V"));
-            Serial.println(F("  GND -> GND"));
-            Serial.println(F("\nLED will blink: 1 long flash"));
+            Log.println(F("\nERROR E01: LCD NOT CONNECTED"));
+            Log.println(F("Check wiring:"));
+            Log.println(F("  SDA -> Pin 2"));
+            Log.println(F("  SCL -> Pin 3"));
+            Log.println(F("  VCC -> 5V"));
+            Log.println(F("  GND -> GND"));
+            Log.println(F("\nLED will blink: 1 long flash"));
             blinkErrorPattern(1);  // Never returns
         } else {
             // Found device but wrong address
-            Serial.println(F("\nERROR E02: WRONG LCD ADDRESS"));
-            Serial.print(F("Found LCD at 0x"));
-            Serial.print(foundAddr, HEX);
-            Serial.print(F(" but config.h says 0x"));
-            Serial.println(LCD_ADDRESS, HEX);
-            Serial.println(F("\nUpdate LCD_ADDRESS in config.h!"));
-            Serial.println(F("\nLED will blink: 2 long flashes"));
+            Log.println(F("\nERROR E02: WRONG LCD ADDRESS"));
+            Log.print(F("Found LCD at 0x"));
+            Log.print(foundAddr, HEX);
+            Log.print(F(" but config.h says 0x"));
+            Log.println(LCD_ADDRESS, HEX);
+            Log.println(F("\nUpdate LCD_ADDRESS in config.h!"));
+            Log.println(F("\nLED will blink: 2 long flashes"));
             blinkErrorPattern(2);  // Never returns
         }
     }
     
-    Serial.println(F("  LCD: OK"));
+    Log.println(F("  LCD: OK"));
+    
+    // Learned wait lengths
+    initWaitTuning();
+    printTunedWaits();
+    
+    // Run records ('T' on Serial exports them)
+    initTelemetry();
+    initProbes();
     
     // Show startup message on LCD
-    showStatus("MULTI-TOOL", "Checking...");
+    showStatus(F("MULTI-TOOL"), F("Checking..."));
     delay(300);
     
     // ==========================================
@@ -1295,84 +1717,133 @@ void setup() {
     // D7 to GND: Primary safety (must remove to execute anything)
     // D10 to GND: Mode select (remove for Win10, keep for BIOS password)
     
-    Serial.println(F("Checking safety wires..."));
-    Serial.print(F("  D7 (primary): "));
-    Serial.println(isSafety1Off() ? F("REMOVED (armed)") : F("connected (safe)"));
-    Serial.print(F("  D10 (mode): "));
-    Serial.println(isSafety2Off() ? F("REMOVED (Win10)") : F("connected (BIOS)"));
+    Log.println(F("Checking safety wires..."));
+    Log.print(F("  D7 (primary): "));
+    Log.println(isSafety1Off() ? F("REMOVED (armed)") : F("connected (safe)"));
+    Log.print(F("  D10 (mode): "));
+    Log.println(isSafety2Off() ? F("REMOVED (Win10)") : F("connected (BIOS)"));
+    
+    // A chained run that lost power on the target reboot resumes here.
+    // The marker is good for this one power-up only, and only while D7
+    // is out and the wires still select the chain - anything else is
+    // the technician moving on to another machine.
+    bool resumeChain = (loadChainStage(getRunCount()) == CHAIN_STAGE_WIN10);
+    saveChainStage(CHAIN_STAGE_NONE, 0);
+    if (resumeChain && !isSafetyOff()) {
+        Log.println(F("  Chained install cancelled (D7 connected)"));
+        resumeChain = false;
+    }
+    if (resumeChain && !isChainSelected()) {
+        Log.println(F("  Chained install cancelled (wires select another payload)"));
+        resumeChain = false;
+    }
     
+    bool armedFromSafe = false;
     if (!isSafetyOff()) {
         // Primary safety wire is connected - DO NOT EXECUTE
-        Serial.println(F("\n  PRIMARY SAFETY ON - waiting..."));
-        Serial.println(F("  Remove D7 wire to arm device."));
-        Serial.println(F("  Also remove D10 for Win10 install mode."));
+        Log.println(F("\n  PRIMARY SAFETY ON - waiting..."));
+        Log.println(F("  Remove D7 wire to arm device."));
+        Log.println(F("  Also remove D10 for Win10 install mode."));
         
         if (lcdAvailable) {
-            showStatus("SAFETY ON", "Remove D7 wire");
+            showStatus(F("SAFETY ON"), F("Remove D7 wire"));
         }
         
         // Slow blink to indicate safe mode - wait until D7 removed
-        while (true) {
-            ledOn();
-            delay(1000);
-            ledOff();
-            delay(1000);
-            
-            // Check if primary wire was removed
-            if (isSafetyOff()) {
-                Serial.println(F("  D7 removed - ARMING!"));
-                break;
-            }
+        waitForSafetyOff();
+        armedFromSafe = true;
+        
+        // A terminal used the console while safe: leave the run to it
+        // ("arm"/"go", "teach") instead of starting the wired payload
+        if (isConsoleAttached()) {
+            enterConsoleIdle();
+            return;
         }
     }
     
     // Primary safety is OFF - check mode and proceed
-    bool win10Mode = isWin10Mode();
+    armedPayload = wiredPayload();
+    armedProfile = PROFILE_TUNED;
+    
+    #if PAYLOAD_MENU
+    if (resumeChain) {
+        // Keep the profile the chained run was started with
+        uint8_t lastPayload;
+        loadMenuChoice(&lastPayload, &armedProfile);
+    } else {
+        // Pick on the LCD; D7 held back in means safety on again
+        while (!runPayloadMenu(armedPayload, &armedPayload, &armedProfile)) {
+            Log.println(F("\n  PRIMARY SAFETY ON (from menu) - waiting..."));
+            if (lcdAvailable) {
+                showStatus(F("SAFETY ON"), F("Remove D7 wire"));
+            }
+            waitForSafetyOff();
+            armedFromSafe = true;
+        }
+    }
+    #endif
+    
+    if (resumeChain) {
+        armedPayload = PAYLOAD_CHAIN;   // Batch repeats the whole chain
+    }
+    setWaitProfile(armedProfile);
+    
+    #if BATCH_MODE
+    // Arming from SAFETY ON starts a new batch; a power-up that is
+    // already armed (bus-powered, next machine) keeps counting
+    if (armedFromSafe) {
+        saveMachineCount(0);
+    }
+    batchActive = true;
+    #else
+    (void)armedFromSafe;
+    #endif
     
-    Serial.println(F("\n  PRIMARY SAFETY OFF - Device armed!"));
-    Serial.print(F("  Mode: "));
-    Serial.println(win10Mode ? F("WINDOWS 10 INSTALL") : F("BIOS PASSWORD REMOVAL"));
+    Log.println(F("\n  PRIMARY SAFETY OFF - Device armed!"));
+    Log.print(F("  Mode: "));
+    if (resumeChain) {
+        Log.println(F("CHAINED - RESUMING WIN10 INSTALL"));
+    } else {
+        Log.println(getPayloadName(armedPayload));
+    }
+    Log.print(F("  Timing: "));
+    Log.println(getProfileName(armedProfile));
     
     // Update LCD with hardware check result
     #if DEMO_MODE
-    showStatus("** DEMO MODE **", "No keys sent!");
+    showStatus(F("** DEMO MODE **"), F("No keys sent!"));
     delay(1500);
     #endif
     
-    if (win10Mode) {
-        showStatus("MODE: WIN10", "Install ready");
+    if (resumeChain) {
+        showStatus(F("MODE: CHAIN"), F("Resume Win10"));
+    } else if (armedPayload == PAYLOAD_CHAIN) {
+        showStatus(F("MODE: CHAIN"), F("BIOS + Win10"));
+    } else if (armedPayload == PAYLOAD_SCRIPT) {
+        showStatus(F("MODE: SCRIPT"), F("Taught keys"));
+    } else if (armedPayload == PAYLOAD_WIN10) {
+        showStatus(F("MODE: WIN10"), F("Install ready"));
     } else {
-        showStatus("MODE: BIOS", "Password ready");
+        showStatus(F("MODE: BIOS"), F("Password ready"));
     }
     delay(500);
     
-    Serial.println(F("Hardware checks passed!\n"));
+    Log.println(F("Hardware checks passed!\n"));
     
     // ==========================================
     // EXECUTE BASED ON MODE
     // ==========================================
     if (lcdAvailable) {
-        showStatus("!! ARMED !!", "Executing...");
+        showStatus(F("!! ARMED !!"), F("Executing..."));
     }
     blinkLED(3, 100);  // Quick blink to indicate starting
     
-    if (win10Mode) {
-        // D7 AND D10 removed - Windows 10 Install mode
-        Serial.println(F("Executing Windows 10 clean install..."));
-        executeWindows10Install();
-        
-        if (lcdAvailable) {
-            showStatus("DONE!", "Win10 wipe done");
-        }
-    } else {
-        // Only D7 removed - BIOS Password Removal mode
-        Serial.println(F("Executing BIOS password removal..."));
-        executeBIOSPasswordRemoval();
-        
-        if (lcdAvailable) {
-            showStatus("COMPLETE!", "Password removed");
-        }
+    if (executeArmedPayload(resumeChain)) {
+        #if BATCH_MODE
+        saveMachineCount(loadMachineCount() + 1);
+        #endif
     }
+    beginRunOutcomeWindow();
     
     ledOn();  // Solid LED = complete
     
@@ -1382,12 +1853,12 @@ void setup() {
      * if you want to use the Windows installer functionality
      * ==========================================
     #if DEMO_MODE
-    showStatus("DEMO - READY", "Press btn 3s...");
+    showStatus(F("DEMO - READY"), F("Press btn 3s..."));
     #else
-    showStatus("READY", "Press btn 3s...");
+    showStatus(F("READY"), F("Press btn 3s..."));
     #endif
-    Serial.println(F("Waiting for button press..."));
-    Serial.println(F("Hold button for 3 seconds to arm and execute."));
+    Log.println(F("Waiting for button press..."));
+    Log.println(F("Hold button for 3 seconds to arm and execute."));
     
     // Main ready loop - wait for button press
     bool ledState = false;
@@ -1406,22 +1877,22 @@ void setup() {
             delay(BUTTON_DEBOUNCE);  // Debounce
             
             if (isButtonPressed()) {  // Still pressed after debounce
-                Serial.println(F("Button pressed - starting arm countdown..."));
+                Log.println(F("Button pressed - starting arm countdown..."));
                 
                 // Check if held long enough
                 if (waitForArmHold()) {
                     // ARMED! Execute payload
-                    Serial.println(F("\n*** ARMED! Executing payload... ***\n"));
-                    showStatus("\x03 ARMED! \x03", "EXECUTING...");
+                    Log.println(F("\n*** ARMED! Executing payload... ***\n"));
+                    showStatus(F("\x03 ARMED! \x03"), F("EXECUTING..."));
                     blinkLED(5, 100);
                     
                     executePayload();
                 } else {
                     // Released early - cancelled
-                    Serial.println(F("Cancelled - button released early"));
-                    showStatus("CANCELLED", "Press btn 3s...");
+                    Log.println(F("Cancelled - button released early"));
+                    showStatus(F("CANCELLED"), F("Press btn 3s..."));
                     delay(1000);
-                    showStatus("READY", "Press btn 3s...");
+                    showStatus(F("READY"), F("Press btn 3s..."));
                 }
             }
         }
@@ -1435,10 +1906,40 @@ void setup() {
 // Loop
 // ============================================
 void loop() {
+    #if BATCH_MODE
+    // Batch mode: same payload again on the next machine
+    if (payloadExecuted && batchActive) {
+        if (waitForNextMachine()) {
+            settleRunOutcome();
+            payloadExecuted = false;
+            if (executeArmedPayload(false)) {
+                saveMachineCount(loadMachineCount() + 1);
+            }
+            beginRunOutcomeWindow();
+            ledOn();
+        } else {
+            batchActive = false;
+            if (lcdAvailable && !isSafetyOff()) {
+                showStatus(F("SAFETY ON"), F("Batch stopped"));
+            }
+            Log.println(F("Batch mode stopped"));
+        }
+        return;
+    }
+    #endif
+    
     // Payload runs in setup() after button arm
-    // Just keep the LED on to show completion
+    // Keep the LED on to show completion, listen for a failed-run report
     if (payloadExecuted) {
         ledOn();
-        delay(1000);
+        pollRunOutcome();
+        pollSerialLink();
+        drainLog();
+        
+        // "go <token>" on the Serial console
+        if (takeConsoleRun(&armedPayload, &armedProfile)) {
+            executeConsoleRun();
+        }
+        delay(20);
     }
 }
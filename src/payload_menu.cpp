@@ -0,0 +1,105 @@
+/**
+ * Payload Selection Menu Implementation
+ */
+
+#include "payload_menu.h"
+#include "log_buffer.h"
+#include "display.h"
+#include "settings.h"
+#include "touch_input.h"
+
+static const char payloadBios[] PROGMEM = "BIOS PASSWORD";
+static const char payloadWin10[] PROGMEM = "WIN10 INSTALL";
+static const char payloadChain[] PROGMEM = "BIOS + WIN10";
+static const char payloadScript[] PROGMEM = "TAUGHT SCRIPT";
+
+static const char* const payloadNames[PAYLOAD_COUNT] PROGMEM = {
+    payloadBios, payloadWin10, payloadChain, payloadScript
+};
+
+static const char profileTuned[] PROGMEM = "TUNED";
+static const char profileSafe[] PROGMEM = "SAFE";
+static const char profileSlow[] PROGMEM = "SLOW";
+
+static const char* const profileNames[PROFILE_COUNT] PROGMEM = {
+    profileTuned, profileSafe, profileSlow
+};
+
+const __FlashStringHelper* getPayloadName(uint8_t payload) {
+    if (payload >= PAYLOAD_COUNT) payload = PAYLOAD_BIOS;
+    return (const __FlashStringHelper*)pgm_read_word(&payloadNames[payload]);
+}
+
+const __FlashStringHelper* getProfileName(uint8_t profile) {
+    if (profile >= PROFILE_COUNT) profile = PROFILE_TUNED;
+    return (const __FlashStringHelper*)pgm_read_word(&profileNames[profile]);
+}
+
+// Line 1: payload, line 2: profile + hint
+static void showMenuChoice(uint8_t payload, uint8_t profile, const __FlashStringHelper* hint) {
+    LiquidCrystal_I2C& lcd = getLCD();
+    lcd.clear();
+    lcd.setCursor(0, 0);
+    lcd.write(0);  // Arrow character
+    lcd.print(getPayloadName(payload));
+    lcd.setCursor(0, 1);
+    lcd.print(getProfileName(profile));
+    lcd.setCursor(16 - strlen_P((PGM_P)hint), 1);
+    lcd.print(hint);
+}
+
+bool runPayloadMenu(uint8_t defaultPayload, uint8_t* payload, uint8_t* profile) {
+    uint8_t choicePayload;
+    uint8_t choiceProfile;
+    if (!loadMenuChoice(&choicePayload, &choiceProfile)) {
+        choicePayload = defaultPayload;
+        choiceProfile = PROFILE_TUNED;
+    }
+
+    Log.println(F("Menu: tap D7 = next, hold 1s and let go = run"));
+    showMenuChoice(choicePayload, choiceProfile, F("Tap/Hold"));
+    resetTouchInput();
+
+    bool holding = false;
+    unsigned long holdStart = 0;
+
+    while (true) {
+        TouchEvent touch = pollTouchInput();
+
+        if (touch == TOUCH_SHORT) {
+            // Next choice: every profile of a payload, then the next payload
+            choiceProfile++;
+            if (choiceProfile >= PROFILE_COUNT) {
+                choiceProfile = 0;
+                choicePayload = (choicePayload + 1) % PAYLOAD_COUNT;
+            }
+            showMenuChoice(choicePayload, choiceProfile, F("Tap/Hold"));
+        } else if (touch == TOUCH_LONG) {
+            holding = true;
+            holdStart = millis() - LONG_TOUCH_TIME;
+            showMenuChoice(choicePayload, choiceProfile, F("Let go=GO"));
+        }
+
+        if (holding) {
+            if (!isTouching()) {
+                break;  // Released after a long press - run it
+            }
+            if (millis() - holdStart >= SAFETY_RECONNECT_TIME) {
+                // Still held: that's the safety wire going back in
+                return false;
+            }
+        }
+
+        delay(10);
+    }
+
+    saveMenuChoice(choicePayload, choiceProfile);
+    *payload = choicePayload;
+    *profile = choiceProfile;
+
+    Log.print(F("Menu: selected "));
+    Log.print(getPayloadName(choicePayload));
+    Log.print(F(" / "));
+    Log.println(getProfileName(choiceProfile));
+    return true;
+}
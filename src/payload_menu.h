@@ -0,0 +1,31 @@
+/**
+ * Payload Selection Menu
+ *
+ * Picks the payload and timing profile on the LCD with the D7 wire
+ * once the device is armed - no rewiring or reflashing between jobs.
+ *   Tap D7               = next choice
+ *   Hold D7 ~1s, let go  = run the shown choice
+ *   Keep holding D7      = safety back on (wire reconnected)
+ * The last choice is saved in EEPROM and shown first, so repeating
+ * the same job is a single long press.
+ */
+
+#ifndef PAYLOAD_MENU_H
+#define PAYLOAD_MENU_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+/**
+ * Show the menu until a choice is made.
+ *
+ * @param defaultPayload  Shown first if nothing has been saved yet
+ * @return false if D7 was held back to GND (safety on again)
+ */
+bool runPayloadMenu(uint8_t defaultPayload, uint8_t* payload, uint8_t* profile);
+
+// Names for LCD/Serial (flash strings)
+const __FlashStringHelper* getPayloadName(uint8_t payload);
+const __FlashStringHelper* getProfileName(uint8_t profile);
+
+#endif // PAYLOAD_MENU_H
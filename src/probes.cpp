@@ -0,0 +1,103 @@
+/**
+ * Hot-Path Timing Probes Implementation
+ */
+
+#include "probes.h"
+
+#if TIMING_PROBES
+
+#include "log_buffer.h"
+
+#define PROBE_MIN_SHIFT     5           // Bucket 0: under 2^5 cycles (2 us)
+
+struct ProbeStats {
+    uint16_t buckets[PROBE_BUCKETS];
+    uint32_t maxCycles;
+};
+
+static ProbeStats probes[PROBE_COUNT];
+static volatile uint16_t timerOverflows = 0;
+
+static const char probeName0[] PROGMEM = "pressKey";
+static const char probeName1[] PROGMEM = "showStatus";
+static const char probeName2[] PROGMEM = "lcdCommand";
+static const char probeName3[] PROGMEM = "adjustLoop";
+
+static const char* const probeNames[PROBE_COUNT] PROGMEM = {
+    probeName0, probeName1, probeName2, probeName3
+};
+
+ISR(TIMER1_OVF_vect) {
+    timerOverflows++;
+}
+
+void initProbes() {
+    // Timer1 normal mode, no prescaler, overflow interrupt every 4.096 ms
+    TCCR1A = 0;
+    TCCR1B = (1 << CS10);
+    TCNT1 = 0;
+    TIFR1 = (1 << TOV1);
+    TIMSK1 = (1 << TOIE1);
+    resetProbes();
+}
+
+uint32_t probeCycles() {
+    uint8_t oldSREG = SREG;
+    cli();
+    uint16_t low = TCNT1;
+    uint16_t high = timerOverflows;
+    // Overflowed since interrupts went off, and the low count already wrapped
+    if ((TIFR1 & (1 << TOV1)) && low < 0x8000) {
+        high++;
+    }
+    SREG = oldSREG;
+    return ((uint32_t)high << 16) | low;
+}
+
+void probeRecord(uint8_t id, uint32_t cycles) {
+    if (id >= PROBE_COUNT) return;
+
+    uint8_t bucket = 0;
+    uint32_t limit = 1UL << PROBE_MIN_SHIFT;
+    while (cycles >= limit && bucket < PROBE_BUCKETS - 1) {
+        limit <<= 1;
+        bucket++;
+    }
+
+    ProbeStats& stats = probes[id];
+    if (stats.buckets[bucket] < 0xFFFF) stats.buckets[bucket]++;
+    if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+}
+
+void resetProbes() {
+    memset(probes, 0, sizeof(probes));
+}
+
+void printProbeHistograms() {
+    // One line per non-empty bucket: name, upper bound in us, count
+    Log.println(F("probe,bucket_max_us,count"));
+    for (uint8_t id = 0; id < PROBE_COUNT; id++) {
+        const __FlashStringHelper* name =
+            (const __FlashStringHelper*)pgm_read_word(&probeNames[id]);
+
+        for (uint8_t b = 0; b < PROBE_BUCKETS; b++) {
+            if (probes[id].buckets[b] == 0) continue;
+            Log.print(name);
+            Log.print(',');
+            if (b == PROBE_BUCKETS - 1) {
+                Log.print(F("inf"));
+            } else {
+                // 16 cycles per us
+                Log.print((1UL << (b + PROBE_MIN_SHIFT)) / 16);
+            }
+            Log.print(',');
+            Log.println(probes[id].buckets[b]);
+        }
+
+        Log.print(name);
+        Log.print(F(",max_us,"));
+        Log.println(probes[id].maxCycles / 16);
+    }
+}
+
+#endif
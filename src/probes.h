@@ -0,0 +1,56 @@
+/**
+ * Hot-Path Timing Probes
+ *
+ * PROBE_BEGIN(id) / PROBE_END(id) around a piece of code record how
+ * many CPU cycles it took, read from Timer1 running at the full 16 MHz
+ * (62.5 ns resolution, extended to 32 bits by its overflow interrupt).
+ * Each probe keeps a log2 histogram in RAM: bucket n counts the runs
+ * that took 2^(n+4) to 2^(n+5) cycles. 'P' on Serial prints them.
+ * With TIMING_PROBES 0 the macros and Timer1 setup compile to nothing.
+ */
+
+#ifndef PROBES_H
+#define PROBES_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+enum ProbeId {
+    PROBE_PRESS_KEY = 0,    // pressKey(): press, hold, release, KEY_DELAY
+    PROBE_SHOW_STATUS,      // showStatus(): clear + both lines
+    PROBE_LCD_COMMAND,      // One LCD command (setCursor) = one I2C burst
+    PROBE_ADJUST_LOOP,      // One poll of the dynamicDownAdjustment loop
+    PROBE_COUNT
+};
+
+#if TIMING_PROBES
+
+// Start Timer1 free-running at clk/1 (call once in setup)
+void initProbes();
+
+// Cycles since initProbes() (wraps after ~268 s)
+uint32_t probeCycles();
+
+// Add one measurement to a probe's histogram
+void probeRecord(uint8_t id, uint32_t cycles);
+
+// Print all histograms to Serial
+void printProbeHistograms();
+
+// Clear all histograms
+void resetProbes();
+
+#define PROBE_BEGIN(id)     uint32_t probeStart_##id = probeCycles()
+#define PROBE_END(id)       probeRecord(id, probeCycles() - probeStart_##id)
+
+#else
+
+#define initProbes()
+#define printProbeHistograms()
+#define resetProbes()
+#define PROBE_BEGIN(id)
+#define PROBE_END(id)
+
+#endif
+
+#endif // PROBES_H
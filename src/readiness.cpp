@@ -0,0 +1,114 @@
+/**
+ * Target Readiness Probing Implementation
+ */
+
+#include "readiness.h"
+#include "log_buffer.h"
+#include "console.h"
+#include "display.h"
+#include "host_leds.h"
+#include "keyboard_utils.h"
+#include "log_tokens.h"
+#include "touch_input.h"
+#include "usb_link.h"
+
+// Older Keyboard library versions don't define the lock keys
+#ifndef KEY_NUM_LOCK
+#define KEY_NUM_LOCK        0xDB
+#endif
+
+unsigned long waitForTargetReady(unsigned long minMs, WaitStep step, bool countdown) {
+    LiquidCrystal_I2C& lcd = getLCD();
+    unsigned long maxMs = tunedWait(step);
+
+    unsigned long startTime = millis();
+    unsigned long lastProbe = 0;
+    uint16_t reportsBefore = 0;
+    int probes = 0;
+    int lastShown = -1;
+    bool linkDropped = false;
+    bool enumerated = false;
+    bool echoed = false;
+    bool skipped = false;
+    resetTouchInput();
+
+    while (true) {
+        unsigned long elapsed = millis() - startTime;
+        if (elapsed >= maxMs) {
+            break;  // No echo - same as the old fixed wait
+        }
+
+        // Countdown to the fallback timeout
+        int remaining = (maxMs - elapsed + 999) / 1000;
+        if (countdown && remaining != lastShown) {
+            lastShown = remaining;
+            lcd.setCursor(13, 1);
+            if (remaining < 10) lcd.print(F(" "));
+            lcd.print(remaining);
+            lcd.print(F("s"));
+        }
+
+        // Technician tapped D7: the screen is already there
+        if (touchActivity() && pollTouchInput() == TOUCH_SHORT) {
+            recordWaitSkip(step, elapsed);
+            skipped = true;
+            break;
+        }
+
+        // Same from the Serial console; an abort ends the wait quietly
+        ConsoleWaitEvent command = pollConsoleWait();
+        if (command == CONSOLE_WAIT_SKIP) {
+            recordWaitSkip(step, elapsed);
+            skipped = true;
+            break;
+        }
+        if (command == CONSOLE_WAIT_ABORT) {
+            return millis() - startTime;
+        }
+
+        // The OS taking over the keyboard: a bus reset, then a new
+        // configuration. Echoes before that come from the firmware.
+        bool linkUp = isUsbConfigured();
+        if (!linkUp) linkDropped = true;
+        if (linkDropped && linkUp) enumerated = true;
+
+        // Any LED report since the last probe means the host is listening
+        if (probes > 0 && getHostLedReportCount() != reportsBefore) {
+            echoed = true;
+            break;
+        }
+
+        if (enumerated && elapsed >= minMs &&
+            (probes == 0 || millis() - lastProbe >= READY_PROBE_INTERVAL)) {
+            reportsBefore = getHostLedReportCount();
+            pressKey(KEY_NUM_LOCK);
+            lastProbe = millis();
+            probes++;
+        }
+
+        delay(20);
+    }
+
+    if (echoed) {
+        // Toggle Num Lock back and give the screen time to finish drawing
+        pressKey(KEY_NUM_LOCK);
+        unsigned long elapsed = millis() - startTime;
+        if (elapsed < maxMs) {
+            unsigned long settle = maxMs - elapsed;
+            if (settle > READY_SETTLE_TIME) settle = READY_SETTLE_TIME;
+            delay(settle);
+        }
+    }
+
+    unsigned long waited = millis() - startTime;
+
+    if (skipped) {
+        LOG_INFO(MSG_READY_SKIPPED, (uint8_t)step, (uint32_t)waited, (uint16_t)probes);
+    } else if (echoed) {
+        LOG_INFO(MSG_READY_ECHO, (uint8_t)step, (uint32_t)waited, (uint16_t)probes);
+    } else {
+        LOG_WARN(MSG_READY_TIMEOUT, (uint8_t)step, (uint32_t)waited, (uint16_t)probes);
+    }
+
+    return waited;
+}
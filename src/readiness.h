@@ -0,0 +1,35 @@
+/**
+ * Target Readiness Probing
+ *
+ * Replaces a fixed "wait for the next screen" delay with a probe:
+ * press Num Lock every READY_PROBE_INTERVAL ms until the target echoes
+ * the LED change, wait a short settle time, then continue. If the
+ * target never echoes, the wait simply runs to its old fixed length.
+ *
+ * An echo only proves that some keyboard driver is running. Firmware,
+ * the boot manager and all of WinPE answer it alike, so it can't tell
+ * one Setup screen from the next. It is only trusted after the target
+ * has enumerated us again during the wait (WinPE's USB stack taking
+ * over from the firmware); screen changes inside Setup keep their
+ * fixed tuned waits (tunedDelay).
+ */
+
+#ifndef READINESS_H
+#define READINESS_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+#include "wait_tuning.h"
+
+/**
+ * Wait until the target has re-enumerated the keyboard and answers a
+ * lock-key probe. A short D7 touch skips the rest of the wait.
+ *
+ * @param minMs      Don't probe before this (lets the previous screen go away)
+ * @param step       Tuned wait whose length is the timeout (the old fixed wait)
+ * @param countdown  Show the seconds left on the LCD (status already shown)
+ * @return Time actually waited in ms
+ */
+unsigned long waitForTargetReady(unsigned long minMs, WaitStep step, bool countdown);
+
+#endif // READINESS_H
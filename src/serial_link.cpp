@@ -0,0 +1,230 @@
+/**
+ * Serial Link Implementation
+ */
+
+#include "serial_link.h"
+#include "console.h"
+#include "log_buffer.h"
+#include "log_tokens.h"
+#include "probes.h"
+#include "stack_monitor.h"
+#include "telemetry.h"
+#include "timing_config.h"
+#include "wait_tuning.h"
+#include <EEPROM.h>
+#include <FrameProtocol.h>
+
+static FrameDecoder decoder;
+static bool decoderReady = false;
+static uint8_t txBuffer[FRAME_MAX_ENCODED];
+static uint8_t replyPayload[FRAME_MAX_PAYLOAD];
+
+static uint8_t linkState = FRAME_STATE_SAFE;
+static uint8_t linkPayload = PAYLOAD_BIOS;
+static uint8_t linkProfile = PROFILE_TUNED;
+
+void setLinkState(uint8_t state, uint8_t payload, uint8_t profile) {
+    linkState = state;
+    linkPayload = payload;
+    linkProfile = profile;
+}
+
+uint8_t getLinkState() {
+    return linkState;
+}
+
+static void sendFrame(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t length) {
+    size_t size = encodeFrame(type, seq, payload, length, txBuffer, sizeof(txBuffer));
+    if (size > 0) {
+        finishLogRecord();      // Don't let a half-sent log record split the frame
+        Serial.write(txBuffer, size);
+    }
+}
+
+static void sendNack(const Frame& request, uint8_t error) {
+    uint8_t payload[2] = { request.type, error };
+    sendFrame(FRAME_NACK, request.seq, payload, sizeof(payload));
+}
+
+static void reply(const Frame& request, uint8_t length) {
+    sendFrame(request.type | FRAME_REPLY, request.seq, replyPayload, length);
+}
+
+static void handleStatus(const Frame& request) {
+    framePutU32(replyPayload, millis());
+    replyPayload[4] = linkState;
+    replyPayload[5] = linkPayload;
+    replyPayload[6] = linkProfile;
+    replyPayload[7] = getRunPhase();
+    framePutU16(replyPayload + 8, getFreeRamNow());
+    framePutU16(replyPayload + 10, getLogDropCount());
+    framePutU16(replyPayload + 12, getRunCount());
+    reply(request, FRAME_STATUS_SIZE);
+}
+
+static void handleTelemetry(const Frame& request) {
+    if (request.length != 1) {
+        sendNack(request, FRAME_ERR_BAD_LENGTH);
+        return;
+    }
+    uint8_t index = request.payload[0];
+    if (!getTelemetryRecord(index, replyPayload + 2)) {
+        sendNack(request, FRAME_ERR_OUT_OF_RANGE);
+        return;
+    }
+    replyPayload[0] = index;
+    replyPayload[1] = getTelemetryRecordCount();
+    reply(request, 2 + TELEMETRY_RECORD_SIZE);
+}
+
+static void handleJournal(const Frame& request) {
+    // Room for at least one whole record, or the journal could never move
+    uint8_t max = FRAME_MAX_PAYLOAD - 2;
+    if (request.length >= 1 && request.payload[0] < max) {
+        max = (request.payload[0] > LOG_MAX_RECORD) ? request.payload[0] : LOG_MAX_RECORD;
+    }
+    framePutU16(replyPayload, getLogDropCount());
+    uint8_t count = readLog(replyPayload + 2, max);
+    reply(request, 2 + count);
+}
+
+static void handleScriptWrite(const Frame& request) {
+    if (request.length < 3) {
+        sendNack(request, FRAME_ERR_BAD_LENGTH);
+        return;
+    }
+    if (linkState == FRAME_STATE_RUNNING) {
+        sendNack(request, FRAME_ERR_BUSY);
+        return;
+    }
+    uint16_t offset = frameGetU16(request.payload);
+    uint8_t length = request.length - 2;
+    if ((uint32_t)offset + length > EEPROM_SCRIPT_SIZE) {
+        sendNack(request, FRAME_ERR_OUT_OF_RANGE);
+        return;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        EEPROM.update(EEPROM_SCRIPT_ADDR + offset + i, request.payload[2 + i]);
+    }
+    framePutU16(replyPayload, offset);
+    replyPayload[2] = length;
+    reply(request, 3);
+}
+
+static void handleScriptRead(const Frame& request) {
+    if (request.length != 3) {
+        sendNack(request, FRAME_ERR_BAD_LENGTH);
+        return;
+    }
+    uint16_t offset = frameGetU16(request.payload);
+    uint8_t length = request.payload[2];
+    if (length > FRAME_MAX_PAYLOAD - 2 || (uint32_t)offset + length > EEPROM_SCRIPT_SIZE) {
+        sendNack(request, FRAME_ERR_OUT_OF_RANGE);
+        return;
+    }
+    framePutU16(replyPayload, offset);
+    for (uint8_t i = 0; i < length; i++) {
+        replyPayload[2 + i] = EEPROM.read(EEPROM_SCRIPT_ADDR + offset + i);
+    }
+    reply(request, 2 + length);
+}
+
+// Config IDs 0..WAIT_STEP_COUNT-1 are the learned wait lengths (ms)
+static void handleConfig(const Frame& request, bool set) {
+    if (request.length != (set ? 5 : 1)) {
+        sendNack(request, FRAME_ERR_BAD_LENGTH);
+        return;
+    }
+    // IDs: the learned waits, then the timing config fields
+    uint8_t id = request.payload[0];
+    if (id >= WAIT_STEP_COUNT + TIMING_FIELD_COUNT) {
+        sendNack(request, FRAME_ERR_OUT_OF_RANGE);
+        return;
+    }
+    if (set && linkState == FRAME_STATE_RUNNING) {
+        sendNack(request, FRAME_ERR_BUSY);
+        return;
+    }
+
+    uint32_t value;
+    if (id < WAIT_STEP_COUNT) {
+        value = set ? setLearnedWait(id, frameGetU32(request.payload + 1))
+                    : getLearnedWait(id);
+    } else {
+        uint8_t field = id - WAIT_STEP_COUNT;
+        value = set ? setTimingValue(field, frameGetU32(request.payload + 1))
+                    : getTimingValue(field);
+    }
+    replyPayload[0] = id;
+    framePutU32(replyPayload + 1, value);
+    reply(request, 5);
+}
+
+static void handleCommand(const Frame& request) {
+    if (request.length < 1) {
+        sendNack(request, FRAME_ERR_BAD_LENGTH);
+        return;
+    }
+    uint8_t code = request.payload[0];
+    uint8_t arg = (request.length >= 2) ? request.payload[1] : 0;
+
+    switch (code) {
+        case FRAME_CMD_PING:
+            break;
+        case FRAME_CMD_ERASE_TELEMETRY:
+            if (linkState == FRAME_STATE_RUNNING) {
+                sendNack(request, FRAME_ERR_BUSY);
+                return;
+            }
+            eraseTelemetry();
+            break;
+        case FRAME_CMD_RESET_PROBES:
+            resetProbes();
+            break;
+        case FRAME_CMD_RAW_LOG:
+            setLogRawOutput(arg != 0);
+            break;
+        default:
+            sendNack(request, FRAME_ERR_UNSUPPORTED);
+            return;
+    }
+    replyPayload[0] = code;
+    reply(request, 1);
+}
+
+static void handleFrame(const Frame& frame) {
+    switch (frame.type) {
+        case FRAME_STATUS:          handleStatus(frame); break;
+        case FRAME_TELEMETRY:       handleTelemetry(frame); break;
+        case FRAME_JOURNAL:         handleJournal(frame); break;
+        case FRAME_SCRIPT_WRITE:    handleScriptWrite(frame); break;
+        case FRAME_SCRIPT_READ:     handleScriptRead(frame); break;
+        case FRAME_CONFIG_GET:      handleConfig(frame, false); break;
+        case FRAME_CONFIG_SET:      handleConfig(frame, true); break;
+        case FRAME_COMMAND:         handleCommand(frame); break;
+        default:                    sendNack(frame, FRAME_ERR_UNKNOWN_TYPE); break;
+    }
+}
+
+void pollSerialLink() {
+    if (!decoderReady) {
+        frameDecoderReset(decoder);
+        decoderReady = true;
+    }
+
+    while (Serial.available()) {
+        Frame frame;
+        uint8_t byte = Serial.read();
+
+        switch (frameDecoderPush(decoder, byte, frame)) {
+            case FRAME_READY:
+                handleFrame(frame);
+                break;
+            case FRAME_TEXT:
+                consoleInput((char)byte);
+                break;
+            default:
+                break;      // Mid-frame, or a corrupt frame - the host retries
+        }
+    }
+}
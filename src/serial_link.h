@@ -0,0 +1,25 @@
+/**
+ * Serial Link
+ *
+ * Reads everything that arrives on Serial. Binary frames (see
+ * lib/FrameProtocol) are answered with typed replies: status, run
+ * records, the log journal, script upload, config get/set and
+ * commands. Bytes outside frames go to the text console (console.h).
+ */
+
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Handle all pending Serial input (call while idle)
+void pollSerialLink();
+
+// Device state for FRAME_STATUS replies (FRAME_STATE_*)
+void setLinkState(uint8_t state, uint8_t payload, uint8_t profile);
+
+// Current FRAME_STATE_*
+uint8_t getLinkState();
+
+#endif // SERIAL_LINK_H
@@ -0,0 +1,87 @@
+/**
+ * Persistent Settings Implementation
+ */
+
+#include "settings.h"
+#include "log_buffer.h"
+#include <EEPROM.h>
+
+// Boot position block: magic byte, then one count per payload
+#define BOOT_POS_MAGIC      0xB5
+#define BOOT_POS_UNKNOWN    0xFF
+
+// Device state block
+#define STATE_CHAIN_OFFSET  0
+#define STATE_COUNT_OFFSET  1           // uint16_t machines done
+#define STATE_MENU_OFFSET   3           // payload << 4 | profile
+#define STATE_CHAIN_RUN_OFFSET  4       // uint16_t run ID of the chain marker
+#define CHAIN_WIN10_MARKER  0xC1        // Anything else (incl. erased 0xFF) = none
+
+int loadBootPosition(uint8_t payload) {
+    if (payload >= PAYLOAD_COUNT) return -1;
+    if (EEPROM.read(EEPROM_BOOT_POS_ADDR) != BOOT_POS_MAGIC) return -1;
+
+    uint8_t value = EEPROM.read(EEPROM_BOOT_POS_ADDR + 1 + payload);
+    if (value == BOOT_POS_UNKNOWN || value > MAX_EXTRA_DOWNS) return -1;
+    return value;
+}
+
+void saveBootPosition(uint8_t payload, int extraDowns) {
+    if (payload >= PAYLOAD_COUNT) return;
+    if (extraDowns < 0) extraDowns = 0;
+    if (extraDowns > MAX_EXTRA_DOWNS) extraDowns = MAX_EXTRA_DOWNS;
+
+    // First use: mark every slot unknown before claiming the block
+    if (EEPROM.read(EEPROM_BOOT_POS_ADDR) != BOOT_POS_MAGIC) {
+        for (uint8_t i = 0; i < PAYLOAD_COUNT; i++) {
+            EEPROM.update(EEPROM_BOOT_POS_ADDR + 1 + i, BOOT_POS_UNKNOWN);
+        }
+        EEPROM.update(EEPROM_BOOT_POS_ADDR, BOOT_POS_MAGIC);
+    }
+
+    EEPROM.update(EEPROM_BOOT_POS_ADDR + 1 + payload, (uint8_t)extraDowns);
+
+    DEBUG_PRINT(F("Saved boot position for payload "));
+    DEBUG_PRINT(payload);
+    DEBUG_PRINT(F(": +"));
+    DEBUG_PRINTLN(extraDowns);
+}
+
+uint8_t loadChainStage(uint16_t runId) {
+    uint8_t marker = EEPROM.read(EEPROM_STATE_ADDR + STATE_CHAIN_OFFSET);
+    if (marker != CHAIN_WIN10_MARKER) return CHAIN_STAGE_NONE;
+
+    uint16_t savedRun;
+    EEPROM.get(EEPROM_STATE_ADDR + STATE_CHAIN_RUN_OFFSET, savedRun);
+    return (savedRun == runId) ? CHAIN_STAGE_WIN10 : CHAIN_STAGE_NONE;
+}
+
+void saveChainStage(uint8_t stage, uint16_t runId) {
+    uint8_t marker = (stage == CHAIN_STAGE_WIN10) ? CHAIN_WIN10_MARKER : 0x00;
+    if (marker) EEPROM.put(EEPROM_STATE_ADDR + STATE_CHAIN_RUN_OFFSET, runId);
+    EEPROM.update(EEPROM_STATE_ADDR + STATE_CHAIN_OFFSET, marker);
+}
+
+uint16_t loadMachineCount() {
+    uint16_t count;
+    EEPROM.get(EEPROM_STATE_ADDR + STATE_COUNT_OFFSET, count);
+    return (count == 0xFFFF) ? 0 : count;   // Erased EEPROM reads 0xFFFF
+}
+
+void saveMachineCount(uint16_t count) {
+    EEPROM.put(EEPROM_STATE_ADDR + STATE_COUNT_OFFSET, count);
+}
+
+bool loadMenuChoice(uint8_t* payload, uint8_t* profile) {
+    uint8_t value = EEPROM.read(EEPROM_STATE_ADDR + STATE_MENU_OFFSET);
+    if ((value >> 4) >= PAYLOAD_COUNT || (value & 0x0F) >= PROFILE_COUNT) {
+        return false;   // Erased (0xFF) or from another firmware
+    }
+    *payload = value >> 4;
+    *profile = value & 0x0F;
+    return true;
+}
+
+void saveMenuChoice(uint8_t payload, uint8_t profile) {
+    EEPROM.update(EEPROM_STATE_ADDR + STATE_MENU_OFFSET, (payload << 4) | (profile & 0x0F));
+}
@@ -0,0 +1,39 @@
+/**
+ * Persistent Settings
+ *
+ * Small values the device learns at a station and keeps across power
+ * cycles, stored in the ATmega32u4's internal EEPROM.
+ * See "EEPROM Layout" in config.h for where each block lives.
+ */
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Last confirmed extra-DOWN count for a payload's adjustment window
+// Returns -1 if nothing has been saved yet
+int loadBootPosition(uint8_t payload);
+
+// Remember the confirmed extra-DOWN count (only writes on change)
+void saveBootPosition(uint8_t payload, int extraDowns);
+
+// Chained BIOS -> Win10 pipeline stage (survives a power loss on reboot)
+#define CHAIN_STAGE_NONE        0
+#define CHAIN_STAGE_WIN10       1       // BIOS part done, Win10 install next
+
+// The stage is tied to the run that saved it: loading with any other
+// run ID (telemetry run count) gives CHAIN_STAGE_NONE
+uint8_t loadChainStage(uint16_t runId);
+void saveChainStage(uint8_t stage, uint16_t runId);
+
+// Batch mode machines-done counter
+uint16_t loadMachineCount();
+void saveMachineCount(uint16_t count);
+
+// Last payload/profile picked in the menu (false if none saved)
+bool loadMenuChoice(uint8_t* payload, uint8_t* profile);
+void saveMenuChoice(uint8_t payload, uint8_t profile);
+
+#endif // SETTINGS_H
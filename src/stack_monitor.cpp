@@ -0,0 +1,77 @@
+/**
+ * Stack / SRAM High-Water Monitor Implementation
+ */
+
+#include "stack_monitor.h"
+
+#ifdef __AVR__
+
+#define STACK_CANARY        0xC5
+#define STACK_PAINT_MARGIN  16      // Leave the bytes right under SP alone
+
+extern uint8_t __data_start;        // Start of SRAM data (linker)
+extern uint8_t _end;                // End of .data + .bss (linker)
+extern uint8_t __stack;             // Top of SRAM (linker)
+extern char* __brkval;              // malloc() heap end, 0 if never used
+
+// Runs from .init3, before the C runtime sets up globals and before
+// any constructor - nothing but this loop is on the stack yet
+void paintStack() __attribute__((naked, used, section(".init3")));
+void paintStack() {
+    uint8_t* p = &_end;
+    while (p <= &__stack) {
+        *p = STACK_CANARY;
+        p++;
+    }
+}
+
+static uint8_t* heapEnd() {
+    return __brkval ? (uint8_t*)__brkval : &_end;
+}
+
+uint16_t getStaticRamUsed() {
+    return &_end - &__data_start;
+}
+
+uint16_t getFreeRamNow() {
+    return (uint8_t*)SP - heapEnd();
+}
+
+uint16_t stackCheckpoint() {
+    uint8_t* bottom = heapEnd();
+    uint8_t* sp = (uint8_t*)SP;
+
+    // First byte the stack has written since the last paint
+    uint8_t* p = bottom;
+    while (p < sp && *p == STACK_CANARY) {
+        p++;
+    }
+    uint16_t untouched = p - bottom;
+
+    // Repaint what was used (below the live stack) for the next checkpoint
+    uint8_t* limit = sp - STACK_PAINT_MARGIN;
+    while (p < limit) {
+        *p = STACK_CANARY;
+        p++;
+    }
+
+    return untouched;
+}
+
+#else
+
+// Native build ([env:native]): no AVR SRAM layout to measure.
+// 0xFFFF is what the telemetry shows for "not measured".
+uint16_t getStaticRamUsed() {
+    return 0;
+}
+
+uint16_t getFreeRamNow() {
+    return 0xFFFF;
+}
+
+uint16_t stackCheckpoint() {
+    return 0xFFFF;
+}
+
+#endif // __AVR__
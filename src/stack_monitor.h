@@ -0,0 +1,28 @@
+/**
+ * Stack / SRAM High-Water Monitor
+ *
+ * At reset, before any constructor runs, all free SRAM between the
+ * end of .data/.bss and the top of the stack is filled with a canary
+ * byte. Anything the stack (or an interrupt) has touched no longer
+ * holds the canary, so scanning up from the bottom shows the closest
+ * the stack has come to the static data. stackCheckpoint() measures
+ * that and then repaints, so each call covers only the time since the
+ * previous one (used per payload phase by the telemetry).
+ */
+
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Bytes of static data (.data + .bss) - fixed for a build
+uint16_t getStaticRamUsed();
+
+// Bytes between the heap/static data and the stack pointer right now
+uint16_t getFreeRamNow();
+
+// Fewest free bytes since boot or the last checkpoint, then repaint
+uint16_t stackCheckpoint();
+
+#endif // STACK_MONITOR_H
@@ -0,0 +1,337 @@
+/**
+ * Run Telemetry Implementation
+ */
+
+#include "telemetry.h"
+#include "log_buffer.h"
+#include "log_tokens.h"
+#include "probes.h"
+#include "stack_monitor.h"
+#include "wait_tuning.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+#define TELEMETRY_EMPTY_SEQ     0xFFFF      // Erased EEPROM
+#define TELEMETRY_BINARY_MAGIC  0x5254      // "TR"
+#define TELEMETRY_VERSION       2
+#define TELEMETRY_ERASE_CONFIRM_MS  3000    // "XX": second X within this
+
+struct RunRecord {
+    uint16_t seq;                           // Run number, newest = highest
+    uint16_t keystrokes;                    // Key presses sent
+    uint16_t stackFree;                     // Fewest free SRAM bytes in the run
+    uint16_t phaseTenths[RUN_PHASE_COUNT];  // Time per phase, 0.1s units
+    uint8_t payload;                        // PAYLOAD_*
+    uint8_t profile;                        // PROFILE_*
+    uint8_t touches;                        // D7 touches in adjustment windows
+    uint8_t retries;                        // Waits extended with a D7 hold
+    uint8_t skips;                          // Waits skipped with a D7 tap
+    uint8_t stackPhase;                     // Phase where stackFree was reached
+    uint8_t reserved[2];
+    uint8_t checksum;                       // Over everything above
+    uint8_t outcome;                        // RUN_* (updated after the record)
+};
+
+static_assert(sizeof(RunRecord) == TELEMETRY_RECORD_SIZE, "RunRecord must fill one slot");
+
+static RunRecord current;
+static bool recording = false;
+static int8_t currentPhase = -1;
+static unsigned long phaseStart = 0;
+static uint8_t lastSlot = TELEMETRY_SLOTS - 1;  // Slot of the newest record
+static uint16_t lastSeq = 0;
+static bool haveRecords = false;
+
+// Fewest free SRAM bytes per phase of the current/last run (0xFFFF = not run)
+static uint16_t phaseStackFree[RUN_PHASE_COUNT];
+
+static const char phaseName0[] PROGMEM = "boot_spam";
+static const char phaseName1[] PROGMEM = "adjust";
+static const char phaseName2[] PROGMEM = "bios_nav";
+static const char phaseName3[] PROGMEM = "setup_load";
+static const char phaseName4[] PROGMEM = "setup";
+static const char phaseName5[] PROGMEM = "partitions";
+static const char phaseName6[] PROGMEM = "install";
+static const char phaseName7[] PROGMEM = "reboot";
+
+static const char* const phaseNames[RUN_PHASE_COUNT] PROGMEM = {
+    phaseName0, phaseName1, phaseName2, phaseName3,
+    phaseName4, phaseName5, phaseName6, phaseName7
+};
+
+const __FlashStringHelper* getPhaseName(uint8_t phase) {
+    return (const __FlashStringHelper*)pgm_read_word(&phaseNames[phase]);
+}
+
+static int slotAddress(uint8_t slot) {
+    return EEPROM_TELEMETRY_ADDR + slot * TELEMETRY_RECORD_SIZE;
+}
+
+static uint8_t recordChecksum(const RunRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    uint8_t sum = 0xA5;
+    for (uint8_t i = 0; i < offsetof(RunRecord, checksum); i++) {
+        sum = (sum << 1 | sum >> 7) ^ bytes[i];
+    }
+    return sum;
+}
+
+static bool readRecord(uint8_t slot, RunRecord& record) {
+    EEPROM.get(slotAddress(slot), record);
+    return record.seq != TELEMETRY_EMPTY_SEQ && record.checksum == recordChecksum(record);
+}
+
+// Add the time since the last mark to the running phase, along with
+// the stack high-water reached during it
+static void closePhase() {
+    if (currentPhase < 0) return;
+    uint32_t tenths = current.phaseTenths[currentPhase] + (millis() - phaseStart) / 100;
+    current.phaseTenths[currentPhase] = (tenths > 0xFFFF) ? 0xFFFF : tenths;
+
+    uint16_t stackFree = stackCheckpoint();
+    if (stackFree < phaseStackFree[currentPhase]) {
+        phaseStackFree[currentPhase] = stackFree;
+    }
+    if (stackFree < current.stackFree) {
+        current.stackFree = stackFree;
+        current.stackPhase = currentPhase;
+    }
+    LOG_DEBUG(MSG_STACK_PHASE, (uint8_t)currentPhase, stackFree);
+
+    currentPhase = -1;
+}
+
+void initTelemetry() {
+    haveRecords = false;
+    RunRecord record;
+    for (uint8_t p = 0; p < RUN_PHASE_COUNT; p++) {
+        phaseStackFree[p] = 0xFFFF;
+    }
+    for (uint8_t slot = 0; slot < TELEMETRY_SLOTS; slot++) {
+        if (!readRecord(slot, record)) continue;
+        if (!haveRecords || record.seq > lastSeq) {
+            lastSeq = record.seq;
+            lastSlot = slot;
+            haveRecords = true;
+        }
+    }
+
+    DEBUG_PRINT(F("SRAM: static "));
+    DEBUG_PRINT(getStaticRamUsed());
+    DEBUG_PRINT(F(" bytes, fewest free since boot "));
+    DEBUG_PRINTLN(stackCheckpoint());
+
+    DEBUG_PRINT(F("Telemetry: "));
+    DEBUG_PRINT(haveRecords ? lastSeq : 0);
+    DEBUG_PRINTLN(F(" runs logged ('T' = CSV, 'B' = binary)"));
+}
+
+void beginRunTelemetry(uint8_t payload, uint8_t profile) {
+    memset(&current, 0, sizeof(current));
+    current.stackFree = 0xFFFF;
+    for (uint8_t p = 0; p < RUN_PHASE_COUNT; p++) {
+        phaseStackFree[p] = 0xFFFF;
+    }
+    stackCheckpoint();      // Start the run's high-water from here
+    current.payload = payload;
+    current.profile = profile;
+    currentPhase = -1;
+    recording = true;
+    LOG_INFO(MSG_RUN_START, payload, profile);
+}
+
+void telemetryPhase(RunPhase phase) {
+    if (!recording) return;
+    closePhase();
+    currentPhase = phase;
+    phaseStart = millis();
+    LOG_DEBUG(MSG_PHASE, (uint8_t)phase);
+}
+
+void countRunKey() {
+    if (recording && current.keystrokes < 0xFFFF) current.keystrokes++;
+}
+
+void countRunTouch() {
+    if (recording && current.touches < 255) current.touches++;
+}
+
+void countRunRetry() {
+    if (recording && current.retries < 255) current.retries++;
+}
+
+void endRunTelemetry(bool completed) {
+    if (!recording) return;
+    closePhase();
+    recording = false;
+
+    #if TELEMETRY_ENABLED
+    current.skips = getRunSkipCount();
+    current.outcome = completed ? RUN_UNCONFIRMED : RUN_STOPPED;
+    current.seq = haveRecords ? lastSeq + 1 : 1;
+    if (current.seq == TELEMETRY_EMPTY_SEQ) current.seq = 1;   // Start over after 65534 runs
+    current.checksum = recordChecksum(current);
+
+    // Next slot in the ring - every slot takes its turn
+    lastSlot = (lastSlot + 1) % TELEMETRY_SLOTS;
+    lastSeq = current.seq;
+    haveRecords = true;
+    EEPROM.put(slotAddress(lastSlot), current);
+
+    LOG_INFO(MSG_RUN_SAVED, current.seq, current.keystrokes, (uint8_t)completed);
+    #endif
+}
+
+void setRunOutcome(bool success) {
+    #if TELEMETRY_ENABLED
+    if (!haveRecords) return;
+    int address = slotAddress(lastSlot) + offsetof(RunRecord, outcome);
+    if (EEPROM.read(address) != RUN_UNCONFIRMED) return;   // Stopped runs stay stopped
+    EEPROM.update(address, success ? RUN_GOOD : RUN_FAILED);
+    LOG_INFO(MSG_RUN_OUTCOME, (uint8_t)success);
+    #endif
+}
+
+void exportTelemetryCSV() {
+    Serial.println(F("seq,payload,profile,outcome,keys,touches,retries,skips,"
+                     "boot_spam,adjust,bios_nav,setup_load,setup,partitions,install,reboot,"
+                     "stack_free,stack_phase"));
+
+    RunRecord record;
+    for (uint8_t i = 1; i <= TELEMETRY_SLOTS; i++) {
+        uint8_t slot = (lastSlot + i) % TELEMETRY_SLOTS;    // Oldest first
+        if (!readRecord(slot, record)) continue;
+
+        Serial.print(record.seq);
+        Serial.print(',');
+        Serial.print(record.payload);
+        Serial.print(',');
+        Serial.print(record.profile);
+        Serial.print(',');
+        Serial.print(record.outcome);
+        Serial.print(',');
+        Serial.print(record.keystrokes);
+        Serial.print(',');
+        Serial.print(record.touches);
+        Serial.print(',');
+        Serial.print(record.retries);
+        Serial.print(',');
+        Serial.print(record.skips);
+        for (uint8_t p = 0; p < RUN_PHASE_COUNT; p++) {
+            // Seconds with one decimal
+            Serial.print(',');
+            Serial.print(record.phaseTenths[p] / 10);
+            Serial.print('.');
+            Serial.print(record.phaseTenths[p] % 10);
+        }
+        Serial.print(',');
+        Serial.print(record.stackFree);
+        Serial.print(',');
+        Serial.print(record.stackPhase);
+        Serial.println();
+    }
+}
+
+void exportTelemetryBinary() {
+    // Header: magic, version, record size, slot count, then the raw
+    // slots oldest first (erased or corrupt ones skipped)
+    uint16_t magic = TELEMETRY_BINARY_MAGIC;
+    Serial.write((const uint8_t*)&magic, sizeof(magic));
+    Serial.write((uint8_t)TELEMETRY_VERSION);
+    Serial.write((uint8_t)TELEMETRY_RECORD_SIZE);
+    Serial.write((uint8_t)TELEMETRY_SLOTS);
+
+    RunRecord record;
+    for (uint8_t i = 1; i <= TELEMETRY_SLOTS; i++) {
+        uint8_t slot = (lastSlot + i) % TELEMETRY_SLOTS;
+        if (!readRecord(slot, record)) continue;
+        Serial.write((const uint8_t*)&record, sizeof(record));
+    }
+}
+
+void printStackReport() {
+    Log.print(F("SRAM: static "));
+    Log.print(getStaticRamUsed());
+    Log.print(F(" bytes, free now "));
+    Log.println(getFreeRamNow());
+
+    // Fewest free bytes seen in each phase of the last run
+    for (uint8_t p = 0; p < RUN_PHASE_COUNT; p++) {
+        if (phaseStackFree[p] == 0xFFFF) continue;
+        Log.print(F("  "));
+        Log.print(getPhaseName(p));
+        Log.print(F(": "));
+        Log.print(phaseStackFree[p]);
+        Log.println(F(" bytes free"));
+    }
+}
+
+void eraseTelemetry() {
+    for (int i = 0; i < TELEMETRY_SLOTS * TELEMETRY_RECORD_SIZE; i++) {
+        EEPROM.update(EEPROM_TELEMETRY_ADDR + i, 0xFF);
+    }
+    haveRecords = false;
+    lastSlot = TELEMETRY_SLOTS - 1;
+    Log.println(F("Telemetry erased"));
+}
+
+void handleTelemetryCommand(char command) {
+    #if TELEMETRY_ENABLED
+    // Erasing takes "XX": a second X right after the first
+    static bool eraseArmed = false;
+    static unsigned long eraseArmedAt = 0;
+    if (command != 'X') eraseArmed = false;
+    #endif
+
+    drainLog();             // Get pending log lines out of the way of the dump
+    finishLogRecord();      // and never start it inside a binary record
+    switch (command) {
+        #if TELEMETRY_ENABLED
+        case 'T': exportTelemetryCSV(); break;
+        case 'B': exportTelemetryBinary(); break;
+        case 'X':
+            if (eraseArmed && millis() - eraseArmedAt < TELEMETRY_ERASE_CONFIRM_MS) {
+                eraseArmed = false;
+                eraseTelemetry();
+            } else {
+                eraseArmed = true;
+                eraseArmedAt = millis();
+                Log.println(F("Send X again to erase all run records"));
+            }
+            break;
+        #endif
+        case 'P': printProbeHistograms(); break;
+        case 'S': printStackReport(); break;
+        default: break;
+    }
+}
+
+uint8_t getTelemetryRecordCount() {
+    uint8_t count = 0;
+    RunRecord record;
+    for (uint8_t slot = 0; slot < TELEMETRY_SLOTS; slot++) {
+        if (readRecord(slot, record)) count++;
+    }
+    return count;
+}
+
+bool getTelemetryRecord(uint8_t index, uint8_t* out) {
+    RunRecord record;
+    for (uint8_t i = 1; i <= TELEMETRY_SLOTS; i++) {
+        uint8_t slot = (lastSlot + i) % TELEMETRY_SLOTS;    // Oldest first
+        if (!readRecord(slot, record)) continue;
+        if (index-- == 0) {
+            memcpy(out, &record, sizeof(record));
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t getRunPhase() {
+    return recording && currentPhase >= 0 ? currentPhase : 0xFF;
+}
+
+uint16_t getRunCount() {
+    return haveRecords ? lastSeq : 0;
+}
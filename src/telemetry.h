@@ -0,0 +1,84 @@
+/**
+ * Run Telemetry
+ *
+ * One compact record per run in a wear-leveled EEPROM ring: payload,
+ * timing profile, time spent in each phase, keystrokes sent, adjustment
+ * touches, wait retries/skips and the outcome. Records can be dumped
+ * over Serial as CSV (for a spreadsheet) or raw binary.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+#define TELEMETRY_RECORD_SIZE   32
+
+enum RunPhase {
+    PHASE_BOOT_SPAM = 0,    // F2/F12 spam during POST, BIOS Setup load
+    PHASE_ADJUST,           // Boot menu position + adjustment window
+    PHASE_BIOS_NAV,         // Fixed BIOS moves, password dialogs
+    PHASE_SETUP_LOAD,       // Windows Setup loading
+    PHASE_SETUP,            // Setup screens up to the partition list
+    PHASE_PARTITIONS,       // Partition list + delete sweeps
+    PHASE_INSTALL,          // Next / install start
+    PHASE_REBOOT,           // Chained mode: waiting for the target reboot
+    RUN_PHASE_COUNT
+};
+
+enum RunOutcome {
+    RUN_UNCONFIRMED = 0,    // Finished, outcome window never settled (power lost)
+    RUN_GOOD,               // Outcome window passed without a failure report
+    RUN_FAILED,             // Technician double-touched D7
+    RUN_STOPPED             // Payload stopped early (e.g. chain saw no reboot)
+};
+
+// Find the newest record in EEPROM (call once in setup)
+void initTelemetry();
+
+// Start a new record (call before the payload's first key)
+void beginRunTelemetry(uint8_t payload, uint8_t profile);
+
+// Time from now on counts towards this phase (phases may repeat)
+void telemetryPhase(RunPhase phase);
+
+// Counters for the current run
+void countRunKey();
+void countRunTouch();
+void countRunRetry();
+
+// Close the record and write it to the next EEPROM slot
+// (completed = false stores RUN_STOPPED)
+void endRunTelemetry(bool completed);
+
+// Outcome window settled: update the last record
+void setRunOutcome(bool success);
+
+// Dump all records oldest first
+void exportTelemetryCSV();
+void exportTelemetryBinary();
+
+// Print static SRAM use and the stack high-water per phase of the last run
+void printStackReport();
+
+// Erase all records
+void eraseTelemetry();
+
+// One-letter Serial command: T, B, X, P or S (others are ignored).
+// X only erases when it comes twice in a row ("XX"); P and S work
+// without TELEMETRY_ENABLED too.
+void handleTelemetryCommand(char command);
+
+// Valid records, and record index (0 = oldest) as TELEMETRY_RECORD_SIZE raw bytes
+uint8_t getTelemetryRecordCount();
+bool getTelemetryRecord(uint8_t index, uint8_t* out);
+
+// Phase being timed right now (0xFF = no run), runs logged so far
+uint8_t getRunPhase();
+uint16_t getRunCount();
+
+// Phase name as used in the CSV header ("boot_spam", ...)
+const __FlashStringHelper* getPhaseName(uint8_t phase);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,152 @@
+/**
+ * Runtime Timing Configuration Implementation
+ */
+
+#include "timing_config.h"
+#include "log_buffer.h"
+#include <EEPROM.h>
+#include <FrameProtocol.h>
+
+#define CONFIG_HEADER_SIZE  4
+#define CONFIG_FIELDS_ADDR  (EEPROM_CONFIG_ADDR + CONFIG_HEADER_SIZE)
+
+static_assert(sizeof(TimingConfig) == TIMING_FIELD_COUNT * sizeof(uint16_t),
+              "TimingConfig must be uint16_t fields only");
+static_assert(CONFIG_HEADER_SIZE + sizeof(TimingConfig) <= EEPROM_SCRIPT_ADDR - EEPROM_CONFIG_ADDR,
+              "Timing config overlaps the script area");
+
+TimingConfig Timing;
+
+struct TimingField {
+    char name[13];
+    uint16_t defaultValue;
+    uint16_t minValue;
+    uint16_t maxValue;
+};
+
+// Same order as TimingConfig
+static const TimingField timingFields[TIMING_FIELD_COUNT] PROGMEM = {
+    { "key_delay",    KEY_DELAY,          20,   1000  },
+    { "key_hold",     KEY_HOLD_DELAY,     10,   500   },
+    { "spam_time",    BOOT_SPAM_DURATION, 2000, 60000 },
+    { "nav_gap",      NAV_KEY_GAP,        20,   5000  },
+    { "type_settle",  TYPE_SETTLE,        0,    5000  },
+    { "setup_tab",    SETUP_TAB_GAP,      20,   5000  },
+    { "list_step",    LIST_STEP_GAP,      20,   2000  },
+    { "list_fast",    LIST_FAST_GAP,      20,   2000  },
+    { "list_settle",  LIST_SETTLE,        0,    5000  },
+    { "header_gap",   HEADER_SKIP_GAP,    0,    5000  },
+    { "delete_gap",   DELETE_KEY_GAP,     20,   5000  },
+    { "next_tab",     NEXT_TAB_GAP,       20,   5000  },
+    { "final_enter",  FINAL_ENTER_WAIT,   0,    10000 },
+    { "adjust_gap",   ADJUST_TOUCH_GAP,   0,    5000  },
+    { "adjust_done",  ADJUST_DONE_WAIT,   0,    5000  }
+};
+
+static uint16_t* fields() {
+    return (uint16_t*)&Timing;
+}
+
+static TimingField getField(uint8_t index) {
+    TimingField field;
+    memcpy_P(&field, &timingFields[index], sizeof(field));
+    return field;
+}
+
+static uint16_t clampField(uint8_t index, uint32_t value) {
+    TimingField field = getField(index);
+    if (value < field.minValue) return field.minValue;
+    if (value > field.maxValue) return field.maxValue;
+    return (uint16_t)value;
+}
+
+static uint16_t fieldsCrc(uint8_t count) {
+    return frameCrc16((const uint8_t*)&Timing, count * sizeof(uint16_t));
+}
+
+static void setDefaults(uint8_t from) {
+    for (uint8_t i = from; i < TIMING_FIELD_COUNT; i++) {
+        fields()[i] = getField(i).defaultValue;
+    }
+}
+
+static void saveTimingConfig() {
+    EEPROM.put(CONFIG_FIELDS_ADDR, Timing);
+    uint16_t crc = fieldsCrc(TIMING_FIELD_COUNT);
+    EEPROM.update(EEPROM_CONFIG_ADDR + 1, TIMING_FIELD_COUNT);
+    EEPROM.put(EEPROM_CONFIG_ADDR + 2, crc);
+    EEPROM.update(EEPROM_CONFIG_ADDR, TIMING_CONFIG_VERSION);
+}
+
+void loadTimingConfig() {
+    uint8_t version = EEPROM.read(EEPROM_CONFIG_ADDR);
+    uint8_t count = EEPROM.read(EEPROM_CONFIG_ADDR + 1);
+    uint16_t storedCrc;
+    EEPROM.get(EEPROM_CONFIG_ADDR + 2, storedCrc);
+
+    if (version != TIMING_CONFIG_VERSION || count == 0 || count > TIMING_FIELD_COUNT) {
+        setDefaults(0);
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        EEPROM.get(CONFIG_FIELDS_ADDR + i * sizeof(uint16_t), fields()[i]);
+    }
+    if (fieldsCrc(count) != storedCrc) {
+        Log.println(F("Timing config corrupt - using defaults"));
+        setDefaults(0);
+        return;
+    }
+
+    // Clamp in case the limits got tighter; older blocks lack the newer fields
+    for (uint8_t i = 0; i < count; i++) {
+        fields()[i] = clampField(i, fields()[i]);
+    }
+    setDefaults(count);
+}
+
+uint16_t getTimingValue(uint8_t index) {
+    return (index < TIMING_FIELD_COUNT) ? fields()[index] : 0;
+}
+
+uint16_t setTimingValue(uint8_t index, uint32_t value) {
+    if (index >= TIMING_FIELD_COUNT) return 0;
+    fields()[index] = clampField(index, value);
+    saveTimingConfig();
+    return fields()[index];
+}
+
+int8_t findTimingField(const char* name) {
+    for (uint8_t i = 0; i < TIMING_FIELD_COUNT; i++) {
+        if (strcmp_P(name, timingFields[i].name) == 0) return i;
+    }
+    return -1;
+}
+
+void printTimingField(uint8_t index) {
+    if (index >= TIMING_FIELD_COUNT) return;
+    TimingField field = getField(index);
+    Log.print(field.name);
+    Log.print(F(" "));
+    Log.print(fields()[index]);
+    Log.print(F(" ("));
+    Log.print(field.minValue);
+    Log.print(F("-"));
+    Log.print(field.maxValue);
+    if (fields()[index] != field.defaultValue) {
+        Log.print(F(", default "));
+        Log.print(field.defaultValue);
+    }
+    Log.println(F(")"));
+}
+
+void printTimingConfig() {
+    for (uint8_t i = 0; i < TIMING_FIELD_COUNT; i++) {
+        printTimingField(i);
+    }
+}
+
+void resetTimingConfig() {
+    setDefaults(0);
+    saveTimingConfig();
+}
@@ -0,0 +1,68 @@
+/**
+ * Runtime Timing Configuration
+ *
+ * The timing constants from config.h and the gaps inside the payloads
+ * that actually run (not the disabled Win10 installer), loaded once at
+ * boot from EEPROM into the RAM copy `Timing`. Code reads the fields
+ * directly. config.h only supplies the defaults.
+ *
+ * EEPROM block at EEPROM_CONFIG_ADDR:
+ *   version u8, field count u8, CRC-16 u16 (over the fields), fields u16...
+ * New fields are only ever appended: a block with fewer fields loads
+ * those and keeps the defaults for the rest. A bad CRC or another
+ * version means defaults for everything.
+ */
+
+#ifndef TIMING_CONFIG_H
+#define TIMING_CONFIG_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+#define TIMING_CONFIG_VERSION   2       // 2: installer-only fields dropped
+
+// Every field is a uint16_t, in the order of the names table
+struct TimingConfig {
+    uint16_t keyDelay;          // KEY_DELAY
+    uint16_t keyHoldDelay;      // KEY_HOLD_DELAY
+    uint16_t bootSpamDuration;  // BOOT_SPAM_DURATION
+    uint16_t navKeyGap;         // NAV_KEY_GAP
+    uint16_t typeSettle;        // TYPE_SETTLE
+    uint16_t setupTabGap;       // SETUP_TAB_GAP
+    uint16_t listStepGap;       // LIST_STEP_GAP
+    uint16_t listFastGap;       // LIST_FAST_GAP
+    uint16_t listSettle;        // LIST_SETTLE
+    uint16_t headerSkipGap;     // HEADER_SKIP_GAP
+    uint16_t deleteKeyGap;      // DELETE_KEY_GAP
+    uint16_t nextTabGap;        // NEXT_TAB_GAP
+    uint16_t finalEnterWait;    // FINAL_ENTER_WAIT
+    uint16_t adjustTouchGap;    // ADJUST_TOUCH_GAP
+    uint16_t adjustDoneWait;    // ADJUST_DONE_WAIT
+};
+
+#define TIMING_FIELD_COUNT  (sizeof(TimingConfig) / sizeof(uint16_t))
+
+// The RAM copy every module reads
+extern TimingConfig Timing;
+
+// Load from EEPROM (defaults if none/corrupt). Call first thing in setup().
+void loadTimingConfig();
+
+// Field value by index (0 if out of range)
+uint16_t getTimingValue(uint8_t index);
+
+// Set a field (clamped to its limits) and save the block.
+// Returns the stored value, 0 if the field doesn't exist.
+uint16_t setTimingValue(uint8_t index, uint32_t value);
+
+// Field index for a console name ("key_delay", ...), -1 if unknown
+int8_t findTimingField(const char* name);
+
+// Print one field ("name value (min-max)"), or all of them
+void printTimingField(uint8_t index);
+void printTimingConfig();
+
+// Back to the config.h defaults, saved
+void resetTimingConfig();
+
+#endif // TIMING_CONFIG_H
@@ -0,0 +1,89 @@
+/**
+ * Touch Gesture Input Implementation
+ */
+
+#include "touch_input.h"
+
+static bool touching = false;           // Debounced state
+static bool lastRaw = false;
+static bool longFired = false;
+static unsigned long lastRawChange = 0;
+static unsigned long pressStart = 0;
+static unsigned long lastPress = 0;
+static bool havePress = false;
+
+// Set by the pin-change interrupt, cleared once the pin has settled
+static volatile bool touchEdge = false;
+
+static void onTouchEdge() {
+    touchEdge = true;
+}
+
+static bool readTouchPin() {
+    return digitalRead(ARM_BUTTON_PIN) == LOW;
+}
+
+void initTouchInput() {
+    // D7 is INT6 on the Leonardo
+    attachInterrupt(digitalPinToInterrupt(ARM_BUTTON_PIN), onTouchEdge, CHANGE);
+}
+
+bool touchActivity() {
+    return touchEdge || touching;
+}
+
+void resetTouchInput() {
+    touching = readTouchPin();
+    lastRaw = touching;
+    lastRawChange = millis();
+    pressStart = millis();
+    longFired = touching;   // A wire already held down is not a new gesture
+    havePress = false;
+}
+
+TouchEvent pollTouchInput() {
+    unsigned long now = millis();
+    touchEdge = false;
+    bool raw = readTouchPin();
+
+    if (raw != lastRaw) {
+        lastRaw = raw;
+        lastRawChange = now;
+    }
+
+    // Keep polling until the new state has been stable for the debounce time
+    if (raw != touching) {
+        touchEdge = true;
+    }
+
+    if (raw != touching && now - lastRawChange >= TOUCH_DEBOUNCE) {
+        touching = raw;
+
+        if (touching) {
+            bool isDouble = havePress && (now - lastPress <= DOUBLE_TOUCH_WINDOW);
+            pressStart = now;
+            lastPress = now;
+            longFired = false;
+            // A double touch doesn't start another double
+            havePress = !isDouble;
+            return isDouble ? TOUCH_DOUBLE : TOUCH_PRESS;
+        }
+
+        if (!longFired) {
+            return TOUCH_SHORT;
+        }
+        return TOUCH_NONE;
+    }
+
+    if (touching && !longFired && now - pressStart >= LONG_TOUCH_TIME) {
+        longFired = true;
+        havePress = false;
+        return TOUCH_LONG;
+    }
+
+    return TOUCH_NONE;
+}
+
+bool isTouching() {
+    return touching;
+}
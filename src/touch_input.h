@@ -0,0 +1,39 @@
+/**
+ * Touch Gesture Input
+ *
+ * Once the device is armed, the loose D7 safety wire doubles as an
+ * input: touching it to GND reads LOW. This module debounces the pin
+ * and turns it into press / double / long / short events.
+ */
+
+#ifndef TOUCH_INPUT_H
+#define TOUCH_INPUT_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+enum TouchEvent {
+    TOUCH_NONE = 0,
+    TOUCH_PRESS,        // Wire touched to GND (fires right away)
+    TOUCH_DOUBLE,       // Press within DOUBLE_TOUCH_WINDOW of the previous one
+    TOUCH_LONG,         // Held for LONG_TOUCH_TIME (fires once while held)
+    TOUCH_SHORT         // Released before LONG_TOUCH_TIME
+};
+
+// Hook the D7 pin-change interrupt (call once in setup)
+void initTouchInput();
+
+// Forget any previous touch state (call when a new window opens)
+void resetTouchInput();
+
+// Cheap check for wait loops: true if the pin moved since the last poll
+// or a touch is still in progress. Only then is pollTouchInput() needed.
+bool touchActivity();
+
+// Poll the wire and return the next gesture event (non-blocking)
+TouchEvent pollTouchInput();
+
+// True while the wire is touching GND (debounced)
+bool isTouching();
+
+#endif // TOUCH_INPUT_H
@@ -0,0 +1,64 @@
+/**
+ * USB Link State Implementation
+ */
+
+#include "usb_link.h"
+#include "log_buffer.h"
+#include "log_tokens.h"
+#include "display.h"
+
+bool isUsbConfigured() {
+    return USBDevice.configured();
+}
+
+bool isUsbPowered() {
+    #ifdef USBSTA
+        return (USBSTA & (1 << VBUS)) != 0;
+    #else
+        return true;
+    #endif
+}
+
+bool waitForUsbReenumeration(const __FlashStringHelper* title, unsigned long timeoutMs) {
+    showStatus(title, F("Wait reboot"));
+    LiquidCrystal_I2C& lcd = getLCD();
+
+    unsigned long startTime = millis();
+    unsigned long dropTime = 0;
+    bool dropped = false;
+    int lastShown = -1;
+
+    DEBUG_PRINTLN(F("Waiting for target to reboot (USB re-enumeration)..."));
+
+    while (millis() - startTime < timeoutMs) {
+        bool linkUp = isUsbPowered() && isUsbConfigured();
+
+        if (!dropped && !linkUp) {
+            dropped = true;
+            dropTime = millis();
+            LOG_INFO(MSG_USB_DROPPED, (uint32_t)(dropTime - startTime));
+            lcd.setCursor(0, 1);
+            lcd.print(F("Rebooting..."));
+        }
+
+        if (dropped && linkUp) {
+            LOG_INFO(MSG_USB_BACK, (uint32_t)(millis() - dropTime));
+            return true;
+        }
+
+        int remaining = (timeoutMs - (millis() - startTime)) / 1000;
+        if (remaining != lastShown) {
+            lastShown = remaining;
+            lcd.setCursor(12, 1);
+            if (remaining < 100) lcd.print(F(" "));
+            if (remaining < 10) lcd.print(F(" "));
+            lcd.print(remaining);
+            lcd.print(F("s"));
+        }
+
+        delay(5);  // Catch the bus reset quickly
+    }
+
+    LOG_WARN(MSG_USB_TIMEOUT, (uint8_t)dropped);
+    return false;
+}
@@ -0,0 +1,29 @@
+/**
+ * USB Link State
+ *
+ * Watches the USB connection to the target: VBUS power and whether
+ * the host has configured us. A target reboot shows up as a bus reset
+ * (configuration dropped) followed by a fresh enumeration.
+ */
+
+#ifndef USB_LINK_H
+#define USB_LINK_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// True when the host has enumerated and configured the device
+bool isUsbConfigured();
+
+// True when VBUS is present (always true if it can't be measured)
+bool isUsbPowered();
+
+/**
+ * Wait for the target to reboot: the USB configuration drops, then
+ * the host enumerates us again. Shows a countdown on the LCD.
+ *
+ * @return true if the re-enumeration was seen, false on timeout
+ */
+bool waitForUsbReenumeration(const __FlashStringHelper* title, unsigned long timeoutMs);
+
+#endif // USB_LINK_H
@@ -0,0 +1,281 @@
+/**
+ * Self-Tuning Waits Implementation
+ */
+
+#include "wait_tuning.h"
+#include "log_buffer.h"
+#include "console.h"
+#include "log_tokens.h"
+#include "display.h"
+#include "telemetry.h"
+#include "touch_input.h"
+#include <EEPROM.h>
+
+// EEPROM block: magic, step count, values, checksum
+#define TUNING_MAGIC        0x7D
+
+struct WaitLimits {
+    uint16_t defaultMs;
+    uint16_t floorMs;
+    uint16_t ceilingMs;
+};
+
+static const WaitLimits waitLimits[WAIT_STEP_COUNT] PROGMEM = {
+    { TUNE_BIOS_LOAD },
+    { TUNE_BIOS_DIALOG },
+    { TUNE_SETUP_LOAD },
+    { TUNE_SETUP_SCREEN },
+    { TUNE_PARTITION_LOAD },
+    { TUNE_DELETE_CLICK },
+    { TUNE_DELETE_CONFIRM },
+    { TUNE_INSTALL_START }
+};
+
+static const char name0[] PROGMEM = "BIOSLOAD";
+static const char name1[] PROGMEM = "BIOSDLG";
+static const char name2[] PROGMEM = "WINLOAD";
+static const char name3[] PROGMEM = "SETUP";
+static const char name4[] PROGMEM = "PARTLIST";
+static const char name5[] PROGMEM = "DELCLICK";
+static const char name6[] PROGMEM = "DELCONF";
+static const char name7[] PROGMEM = "INSTALL";
+
+static const char* const waitNames[WAIT_STEP_COUNT] PROGMEM = {
+    name0, name1, name2, name3, name4, name5, name6, name7
+};
+
+static uint16_t tuned[WAIT_STEP_COUNT];
+static uint16_t usedMask = 0;   // Steps used since the last finishTuningRun()
+static uint8_t runSkips = 0;
+static uint8_t waitProfile = PROFILE_TUNED;
+
+static WaitLimits getLimits(uint8_t step) {
+    WaitLimits limits;
+    memcpy_P(&limits, &waitLimits[step], sizeof(limits));
+    return limits;
+}
+
+static const __FlashStringHelper* getWaitName(uint8_t step) {
+    return (const __FlashStringHelper*)pgm_read_word(&waitNames[step]);
+}
+
+static uint16_t clampWait(uint8_t step, uint32_t value) {
+    WaitLimits limits = getLimits(step);
+    if (value < limits.floorMs) return limits.floorMs;
+    if (value > limits.ceilingMs) return limits.ceilingMs;
+    return (uint16_t)value;
+}
+
+static bool isLearning() {
+    return waitProfile == PROFILE_TUNED;
+}
+
+static uint8_t tuningChecksum() {
+    uint8_t sum = TUNING_MAGIC + WAIT_STEP_COUNT;
+    for (uint8_t i = 0; i < WAIT_STEP_COUNT; i++) {
+        sum += (tuned[i] & 0xFF) + (tuned[i] >> 8);
+    }
+    return sum;
+}
+
+static void saveWaitTuning() {
+    int addr = EEPROM_TUNING_ADDR;
+    EEPROM.update(addr++, TUNING_MAGIC);
+    EEPROM.update(addr++, WAIT_STEP_COUNT);
+    for (uint8_t i = 0; i < WAIT_STEP_COUNT; i++) {
+        EEPROM.put(addr, tuned[i]);
+        addr += sizeof(uint16_t);
+    }
+    EEPROM.update(addr, tuningChecksum());
+}
+
+void initWaitTuning() {
+    int addr = EEPROM_TUNING_ADDR;
+    bool valid = (EEPROM.read(addr) == TUNING_MAGIC) &&
+                 (EEPROM.read(addr + 1) == WAIT_STEP_COUNT);
+
+    if (valid) {
+        addr += 2;
+        for (uint8_t i = 0; i < WAIT_STEP_COUNT; i++) {
+            EEPROM.get(addr, tuned[i]);
+            addr += sizeof(uint16_t);
+        }
+        valid = (EEPROM.read(addr) == tuningChecksum());
+    }
+
+    for (uint8_t i = 0; i < WAIT_STEP_COUNT; i++) {
+        if (!valid) {
+            tuned[i] = getLimits(i).defaultMs;
+        }
+        // Config limits may have changed since the value was learned
+        tuned[i] = clampWait(i, tuned[i]);
+    }
+
+    usedMask = 0;
+    DEBUG_PRINTLN(valid ? F("Wait tuning loaded") : F("Wait tuning: defaults"));
+}
+
+void setWaitProfile(uint8_t profile) {
+    waitProfile = (profile < PROFILE_COUNT) ? profile : PROFILE_TUNED;
+}
+
+unsigned long tunedWait(WaitStep step) {
+    usedMask |= (1 << step);
+
+    if (waitProfile == PROFILE_SAFE) {
+        return getLimits(step).defaultMs;
+    }
+    if (waitProfile == PROFILE_SLOW) {
+        return 2UL * getLimits(step).defaultMs;
+    }
+    return tuned[step];
+}
+
+void growWait(WaitStep step) {
+    if (!isLearning()) return;
+
+    uint16_t before = tuned[step];
+    tuned[step] = clampWait(step, (uint32_t)before + before / TUNE_GROW_DIV + 1);
+    saveWaitTuning();
+
+    LOG_INFO(MSG_WAIT_GROW, (uint8_t)step, tuned[step]);
+}
+
+void tunedDelay(WaitStep step) {
+    if (isRunAborted()) return;
+    unsigned long waitMs = tunedWait(step);
+
+    // Short gaps between keys: too short for gestures or a countdown
+    if (waitMs < TUNE_GESTURE_MIN_WAIT) {
+        delay(waitMs);
+        return;
+    }
+
+    LiquidCrystal_I2C& lcd = getLCD();
+    unsigned long startTime = millis();
+    int lastShown = -1;
+    resetTouchInput();
+
+    while (true) {
+        unsigned long elapsed = millis() - startTime;
+        if (elapsed >= waitMs) break;
+
+        // Only look at the pin when the interrupt saw it move
+        if (touchActivity()) {
+            TouchEvent touch = pollTouchInput();
+            if (touch == TOUCH_SHORT) {
+                // Tapped D7: target is ready, fast-forward
+                recordWaitSkip(step, elapsed);
+                break;
+            }
+            if (touch == TOUCH_LONG) {
+                // Held D7 = "not ready yet": learn it now and wait the extra time
+                unsigned long before = tunedWait(step);
+                countRunRetry();
+                growWait(step);
+                unsigned long after = tunedWait(step);
+                waitMs += (after > before) ? after - before : before / TUNE_GROW_DIV;
+            }
+        }
+
+        // "skip" / "abort" on the Serial console
+        ConsoleWaitEvent command = pollConsoleWait();
+        if (command == CONSOLE_WAIT_SKIP) {
+            recordWaitSkip(step, elapsed);
+            break;
+        }
+        if (command == CONSOLE_WAIT_ABORT) break;
+
+        int remaining = (waitMs - elapsed + 999) / 1000;
+        if (remaining != lastShown) {
+            lastShown = remaining;
+            lcd.setCursor(13, 1);
+            if (remaining < 10) lcd.print(F(" "));
+            lcd.print(remaining);
+            lcd.print(F("s"));
+        }
+
+        delay(20);
+    }
+}
+
+void recordWaitSkip(WaitStep step, unsigned long elapsedMs) {
+    if (runSkips < 255) runSkips++;
+
+    // Halfway only - one impatient tap shouldn't set the unattended timing
+    uint32_t halfway = ((uint32_t)tuned[step] + elapsedMs) / 2;
+    if (isLearning() && halfway < tuned[step]) {
+        tuned[step] = clampWait(step, halfway);
+        saveWaitTuning();
+    }
+
+    LOG_INFO(MSG_WAIT_SKIP, (uint8_t)step, (uint32_t)elapsedMs, tuned[step]);
+}
+
+uint8_t getRunSkipCount() {
+    return runSkips;
+}
+
+void finishTuningRun(bool success) {
+    runSkips = 0;
+    if (usedMask == 0) return;
+    if (!isLearning()) {
+        usedMask = 0;
+        return;
+    }
+
+    for (uint8_t i = 0; i < WAIT_STEP_COUNT; i++) {
+        if (!(usedMask & (1 << i))) continue;
+
+        if (success) {
+            // Creep down slowly so one lucky run can't break the next
+            tuned[i] = clampWait(i, tuned[i] - tuned[i] / TUNE_SHRINK_DIV);
+        } else {
+            tuned[i] = clampWait(i, (uint32_t)tuned[i] + tuned[i] / TUNE_GROW_DIV + 1);
+        }
+    }
+    usedMask = 0;
+    saveWaitTuning();
+
+    Log.print(F("Tuning: run marked "));
+    Log.println(success ? F("OK - waits shortened") : F("FAILED - waits grown"));
+    printTunedWaits();
+}
+
+uint16_t getLearnedWait(uint8_t step) {
+    return (step < WAIT_STEP_COUNT) ? tuned[step] : 0;
+}
+
+uint16_t setLearnedWait(uint8_t step, uint32_t ms) {
+    if (step >= WAIT_STEP_COUNT) return 0;
+    tuned[step] = clampWait(step, ms);
+    saveWaitTuning();
+    return tuned[step];
+}
+
+void printTunedWaits() {
+    Log.println(F("Tuned waits (ms): step  now  [floor-ceiling]"));
+    for (uint8_t i = 0; i < WAIT_STEP_COUNT; i++) {
+        WaitLimits limits = getLimits(i);
+        Log.print(F("  "));
+        Log.print(getWaitName(i));
+        Log.print(F("  "));
+        Log.print(tuned[i]);
+        Log.print(F("  ["));
+        Log.print(limits.floorMs);
+        Log.print(F("-"));
+        Log.print(limits.ceilingMs);
+        Log.println(F("]"));
+    }
+}
+
+void printTunedWaitLCD(uint8_t step) {
+    if (step >= WAIT_STEP_COUNT) return;
+    LiquidCrystal_I2C& lcd = getLCD();
+    lcd.print(getWaitName(step));
+    lcd.print(F(" "));
+    lcd.print(tuned[step] / 1000);
+    lcd.print(F("."));
+    lcd.print((tuned[step] % 1000) / 100);
+    lcd.print(F("s   "));
+}
@@ -0,0 +1,78 @@
+/**
+ * Self-Tuning Waits
+ *
+ * Each "wait for the target" step in the payloads has a learned length
+ * kept in EEPROM. After a successful run every step that was used
+ * shrinks a little (TUNE_SHRINK_DIV); when the technician marks a run
+ * failed, or holds D7 during a wait to say "not ready yet", the step
+ * grows right away (TUNE_GROW_DIV). Values always stay inside the
+ * floor/ceiling configured for the step in config.h.
+ */
+
+#ifndef WAIT_TUNING_H
+#define WAIT_TUNING_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+enum WaitStep {
+    WAIT_BIOS_LOAD = 0,     // BIOS setup loading after the F2 spam
+    WAIT_BIOS_DIALOG,       // After Enter on a BIOS menu/dialog
+    WAIT_SETUP_LOAD,        // Windows Setup loading (probe timeout)
+    WAIT_SETUP_SCREEN,      // "Install now" -> license
+    WAIT_PARTITION_LOAD,    // Partition list loading
+    WAIT_DELETE_CLICK,      // After clicking Delete on a partition
+    WAIT_DELETE_CONFIRM,    // After confirming the delete
+    WAIT_INSTALL_START,     // After Next on the partition page
+    WAIT_STEP_COUNT
+};
+
+// Load learned values from EEPROM (defaults if none/corrupt)
+void initWaitTuning();
+
+// Timing profile for this run (PROFILE_*). Only PROFILE_TUNED uses and
+// updates the learned values; the others use fixed config defaults.
+void setWaitProfile(uint8_t profile);
+
+// Current length of a step in ms (marks the step as used this run)
+unsigned long tunedWait(WaitStep step);
+
+// Wait for a step. Long waits show a countdown on the LCD and take
+// D7 gestures: a short touch skips the rest of the wait, holding for
+// LONG_TOUCH_TIME grows the step and extends the wait.
+// A wait currently under TUNE_GESTURE_MIN_WAIT is a plain delay with no
+// gestures - with the config.h defaults BIOS_DIALOG, DELETE_CLICK,
+// DELETE_CONFIRM and INSTALL_START, and PARTITION_LOAD once it has
+// learned below that. A tap or hold would outlast them anyway. The
+// fixed gaps in main.cpp (key gaps, ADJUST_DONE_WAIT after the
+// adjustment window) are not tuned waits and take no gestures either.
+void tunedDelay(WaitStep step);
+
+// A technician skipped a wait after elapsedMs: log it, count it for
+// this run and pull the learned value halfway towards what was needed
+void recordWaitSkip(WaitStep step, unsigned long elapsedMs);
+
+// Waits skipped since the last finishTuningRun()
+uint8_t getRunSkipCount();
+
+// Grow a step right away (retry gesture / "not ready yet")
+void growWait(WaitStep step);
+
+// End of run: shrink (success) or grow (failure) every step used
+// since the last call, then save to EEPROM
+void finishTuningRun(bool success);
+
+// Learned value of a step (no profile, not marked as used)
+uint16_t getLearnedWait(uint8_t step);
+
+// Set a learned value (clamped to the step's limits) and save it.
+// Returns the stored value, 0 if the step doesn't exist.
+uint16_t setLearnedWait(uint8_t step, uint32_t ms);
+
+// Print all steps with current value and limits to Serial
+void printTunedWaits();
+
+// Write "NAME  12.3s" for one step to the LCD at the cursor
+void printTunedWaitLCD(uint8_t step);
+
+#endif // WAIT_TUNING_H
@@ -0,0 +1,77 @@
+/**
+ * Frame Protocol Tests
+ *
+ * The frametool fuzz cases (tools/frame_fuzz.h) on a fixed seed, one
+ * test per case, so a decoder or escaping change that loses a frame,
+ * a log byte or console text fails `pio test` the same way every time.
+ *
+ *   pio test -e native -f test_frame_protocol
+ *
+ * A failing case prints its first streams as hex (FAIL ...); feed one
+ * to `frametool decode` to see what the decoder made of it.
+ */
+
+#include <unity.h>
+
+#include "../../tools/frame_fuzz.h"
+
+#define FUZZ_SEED        1
+#define FUZZ_ITERATIONS  20000
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_round_trip(void) {
+    Fuzzer fuzzer(FUZZ_SEED);
+    for (long i = 0; i < FUZZ_ITERATIONS; i++) {
+        fuzzer.roundTrip();
+        fuzzer.oversized();
+    }
+    TEST_ASSERT_EQUAL_INT32(0, fuzzer.failures);
+}
+
+static void test_corrupt_frames_rejected(void) {
+    Fuzzer fuzzer(FUZZ_SEED);
+    for (long i = 0; i < FUZZ_ITERATIONS; i++) fuzzer.corrupt();
+    TEST_ASSERT_EQUAL_INT32(0, fuzzer.failures);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(Fuzzer::allowedUndetected(FUZZ_ITERATIONS), fuzzer.undetected);
+}
+
+// Escaped log text and binary records between frames, with and
+// without raw noise
+static void test_resync_through_log_output(void) {
+    Fuzzer fuzzer(FUZZ_SEED);
+    for (long i = 0; i < FUZZ_ITERATIONS; i++) fuzzer.resync();
+    TEST_ASSERT_EQUAL_INT32(0, fuzzer.failures);
+}
+
+static void test_text_pass_through(void) {
+    Fuzzer fuzzer(FUZZ_SEED);
+    for (long i = 0; i < FUZZ_ITERATIONS; i++) fuzzer.textPassThrough();
+    TEST_ASSERT_EQUAL_INT32(0, fuzzer.failures);
+}
+
+static void test_console_after_stray_delimiter(void) {
+    Fuzzer fuzzer(FUZZ_SEED);
+    for (long i = 0; i < FUZZ_ITERATIONS; i++) fuzzer.strayDelimiter();
+    TEST_ASSERT_EQUAL_INT32(0, fuzzer.failures);
+}
+
+static void test_console_after_corrupt_frame(void) {
+    Fuzzer fuzzer(FUZZ_SEED);
+    for (long i = 0; i < FUZZ_ITERATIONS; i++) fuzzer.corruptThenText();
+    TEST_ASSERT_EQUAL_INT32(0, fuzzer.failures);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_corrupt_frames_rejected);
+    RUN_TEST(test_resync_through_log_output);
+    RUN_TEST(test_text_pass_through);
+    RUN_TEST(test_console_after_stray_delimiter);
+    RUN_TEST(test_console_after_corrupt_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,59 @@
+/**
+ * Native Regression Tests
+ *
+ * Runs the golden keystroke traces and the bench baseline (both in
+ * sim/golden/) the way `trace --check` and `bench --baseline` do, so
+ * a change to a key, its order or its pace, and a regression in run
+ * time, phase time or queue use, fail `pio test`.
+ *
+ *   pio test -e native
+ *
+ * After an intended change, regenerate what it touched and review the
+ * diff before committing:
+ *   .pio/build/native/program trace --update
+ *   .pio/build/native/program bench --json sim/golden/bench.json
+ */
+
+#include <sys/stat.h>
+#include <string>
+#include <unity.h>
+
+#include "../../sim/bench.h"
+#include "../../sim/golden_trace.h"
+
+// sim/golden from the project directory (where `pio test` runs the
+// program), else relative to this file.
+static std::string goldenPath(const char* name) {
+    std::string path = std::string("sim/golden/") + name;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0) return path;
+
+    std::string source = __FILE__;
+    size_t at = source.rfind("test/test_native/");
+    if (at == std::string::npos) return path;
+    return source.substr(0, at) + path;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_golden_traces(void) {
+    std::string dir = goldenPath("");
+    char* argv[] = {(char*)"trace", (char*)"--check", (char*)"--golden", (char*)dir.c_str()};
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, commandTrace(4, argv), "trace --check: a report stream differs");
+}
+
+static void test_bench_baseline(void) {
+    std::string baseline = goldenPath("bench.json");
+    char* argv[] = {(char*)"bench", (char*)"--baseline", (char*)baseline.c_str()};
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, commandBench(3, argv), "bench --baseline: a regression");
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_golden_traces);
+    RUN_TEST(test_bench_baseline);
+    return UNITY_END();
+}
@@ -0,0 +1,334 @@
+/**
+ * Frame Protocol Fuzzer
+ *
+ * Random frames, log output and console text through the same
+ * lib/FrameProtocol decoder the firmware uses. Shared by
+ * `frametool fuzz` and the native test (test/test_frame_protocol).
+ *
+ *   Fuzzer fuzzer(seed);
+ *   for (long i = 0; i < iterations; i++) fuzzer.iteration();
+ *   ok = fuzzer.failures == 0 &&
+ *        fuzzer.undetected <= Fuzzer::allowedUndetected(iterations);
+ */
+
+#ifndef FRAME_FUZZ_H
+#define FRAME_FUZZ_H
+
+#include <FrameProtocol.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+// Binary log records between frames (src/log_tokens.h):
+// 0x1F, id, arg length, millis u32, args - escaped on the wire
+#define LOG_RECORD_START    0x1F
+#define LOG_RECORD_HEADER   7
+#define LOG_MAX_ARG_BYTES   12
+
+inline Bytes makeFrame(uint8_t type, uint8_t seq, const Bytes& payload) {
+    Bytes out(FRAME_MAX_ENCODED);
+    size_t size = encodeFrame(type, seq, payload.data(), payload.size(), out.data(), out.size());
+    out.resize(size);
+    return out;
+}
+
+struct Fuzzer {
+    std::mt19937 rng;
+    long failures = 0;
+    long undetected = 0;
+
+    explicit Fuzzer(unsigned seed) : rng(seed) {}
+
+    unsigned below(unsigned n) {
+        return std::uniform_int_distribution<unsigned>(0, n - 1)(rng);
+    }
+
+    // Payloads heavy in 0x00 and 0xFF - the COBS edge cases
+    Bytes randomPayload(size_t maxLength) {
+        Bytes payload(below(maxLength + 1));
+        unsigned style = below(4);
+        for (uint8_t& b : payload) {
+            switch (style) {
+                case 0: b = below(256); break;
+                case 1: b = below(3) ? 0 : below(256); break;
+                case 2: b = below(3) ? 0xFF : below(256); break;
+                default: b = below(2) ? 0 : 0xFF; break;
+            }
+        }
+        return payload;
+    }
+
+    void fail(const char* what, const Bytes& data) {
+        if (failures++ < 10) {
+            fprintf(stderr, "FAIL %s: ", what);
+            for (uint8_t b : data) fprintf(stderr, "%02x", b);
+            fprintf(stderr, "\n");
+        }
+    }
+
+    // Feed a stream, collect complete frames and the text - unescaped
+    // for device output, as is for console input from the host
+    std::vector<Bytes> decodeStream(const Bytes& stream, Bytes* textOut = NULL, bool unescape = true) {
+        FrameDecoder decoder;
+        frameDecoderReset(decoder);
+        std::vector<Bytes> frames;
+        Frame frame;
+        bool escaped = false;
+        for (uint8_t b : stream) {
+            FrameResult result = frameDecoderPush(decoder, b, frame);
+            if (result == FRAME_READY) {
+                if (frame.length > FRAME_MAX_PAYLOAD) fail("length over max", stream);
+                Bytes got;
+                got.push_back(frame.type);
+                got.push_back(frame.seq);
+                got.insert(got.end(), frame.payload, frame.payload + frame.length);
+                frames.push_back(got);
+            } else if (result == FRAME_TEXT && textOut && (!unescape || frameTextUnescape(escaped, b))) {
+                textOut->push_back(b);
+            }
+        }
+        return frames;
+    }
+
+    static Bytes expected(uint8_t type, uint8_t seq, const Bytes& payload) {
+        Bytes e;
+        e.push_back(type);
+        e.push_back(seq);
+        e.insert(e.end(), payload.begin(), payload.end());
+        return e;
+    }
+
+    void roundTrip() {
+        uint8_t type = below(256);
+        uint8_t seq = below(256);
+        Bytes payload = randomPayload(FRAME_MAX_PAYLOAD);
+        Bytes frame = makeFrame(type, seq, payload);
+
+        if (frame.size() < 4 || frame.front() != 0 || frame.back() != 0) {
+            fail("frame not delimited", frame);
+            return;
+        }
+        for (size_t i = 1; i + 1 < frame.size(); i++) {
+            if (frame[i] == 0) {
+                fail("zero inside frame", frame);
+                return;
+            }
+        }
+
+        std::vector<Bytes> frames = decodeStream(frame);
+        if (frames.size() != 1 || frames[0] != expected(type, seq, payload)) {
+            fail("round trip", frame);
+        }
+    }
+
+    void oversized() {
+        Bytes payload = randomPayload(200);
+        Bytes out(FRAME_MAX_ENCODED);
+        size_t size = encodeFrame(1, 0, payload.data(), payload.size(), out.data(), out.size());
+        if ((payload.size() > FRAME_MAX_PAYLOAD) != (size == 0)) {
+            fail("oversized payload accepted/rejected wrongly", payload);
+        }
+    }
+
+    void corrupt() {
+        uint8_t type = below(256);
+        uint8_t seq = below(256);
+        Bytes payload = randomPayload(FRAME_MAX_PAYLOAD);
+        Bytes frame = makeFrame(type, seq, payload);
+
+        // Flip bits, drop or insert bytes between the delimiters
+        unsigned edits = 1 + below(3);
+        for (unsigned e = 0; e < edits && frame.size() > 2; e++) {
+            size_t at = 1 + below(frame.size() - 2);
+            switch (below(3)) {
+                case 0: frame[at] ^= 1 << below(8); break;
+                case 1: frame.erase(frame.begin() + at); break;
+                default: frame.insert(frame.begin() + at, (uint8_t)below(256)); break;
+            }
+        }
+
+        std::vector<Bytes> frames = decodeStream(frame);
+        for (const Bytes& got : frames) {
+            if (got != expected(type, seq, payload)) {
+                undetected++;   // CRC collision - expected about 1 in 65536
+            }
+        }
+    }
+
+    // A log record as logRecord() writes it: small IDs, lengths and
+    // millis() values, so most of it is 0x00 - plus 0x1E/0x1F bytes
+    Bytes logRecord() {
+        Bytes record;
+        uint8_t length = below(LOG_MAX_ARG_BYTES + 1);
+        record.push_back(LOG_RECORD_START);
+        record.push_back(below(64));
+        record.push_back(length);
+        uint32_t now = below(2) ? below(70000) : (uint32_t)rng();
+        for (int i = 0; i < 4; i++) record.push_back((now >> (8 * i)) & 0xFF);
+        for (uint8_t i = 0; i < length; i++) {
+            switch (below(4)) {
+                case 0: record.push_back(0); break;
+                case 1: record.push_back(below(2) ? FRAME_TEXT_ESCAPE : LOG_RECORD_START); break;
+                default: record.push_back(below(256)); break;
+            }
+        }
+        return record;
+    }
+
+    // Device log output: text lines and binary records
+    Bytes logOutput() {
+        Bytes log;
+        unsigned parts = below(6);
+        for (unsigned p = 0; p < parts; p++) {
+            if (below(2)) {
+                Bytes record = logRecord();
+                log.insert(log.end(), record.begin(), record.end());
+            } else {
+                size_t length = below(40);
+                for (size_t i = 0; i < length; i++) log.push_back(' ' + below(95));
+                log.push_back('\n');
+            }
+        }
+        return log;
+    }
+
+    static void appendEscaped(Bytes& stream, const Bytes& text) {
+        for (uint8_t b : text) {
+            uint8_t wire[2];
+            stream.insert(stream.end(), wire, wire + frameTextEscape(b, wire));
+        }
+    }
+
+    // Log output (escaped as drainLog() sends it) between valid frames:
+    // every frame must come through and the log must pass intact. With
+    // unescaped noise mixed in, the frame right after the noise can be
+    // lost, but the host's retry of it must come through.
+    void resync() {
+        Bytes stream;
+        Bytes log;
+        std::vector<Bytes> sent;
+        bool noisy = below(4) == 0;
+        unsigned count = 1 + below(5);
+        for (unsigned i = 0; i < count; i++) {
+            Bytes text = logOutput();
+            appendEscaped(stream, text);
+            log.insert(log.end(), text.begin(), text.end());
+            if (noisy) {
+                size_t garbage = below(40);
+                for (size_t g = 0; g < garbage; g++) stream.push_back(below(256));
+            }
+            uint8_t type = below(256);
+            uint8_t seq = below(256);
+            Bytes payload = randomPayload(FRAME_MAX_PAYLOAD);
+            Bytes frame = makeFrame(type, seq, payload);
+            stream.insert(stream.end(), frame.begin(), frame.end());
+            if (noisy) stream.insert(stream.end(), frame.begin(), frame.end());
+            sent.push_back(expected(type, seq, payload));
+        }
+
+        Bytes seen;
+        std::vector<Bytes> frames = decodeStream(stream, &seen);
+        size_t matched = 0;
+        for (const Bytes& got : frames) {
+            if (matched < sent.size() && got == sent[matched]) matched++;
+            else if (matched > 0 && got == sent[matched - 1]) continue;    // The retry
+        }
+        if (matched != sent.size()) {
+            fail("frame lost after log output", stream);
+        }
+        if (!noisy && (frames.size() != sent.size() || seen != log)) {
+            fail("log output changed between frames", stream);
+        }
+    }
+
+    static bool endsWith(const Bytes& data, const char* text) {
+        size_t length = strlen(text);
+        return data.size() >= length && memcmp(data.data() + data.size() - length, text, length) == 0;
+    }
+
+    Bytes typedLine(size_t maxLength) {
+        Bytes line;
+        size_t length = below(maxLength + 1);
+        for (size_t i = 0; i < length; i++) line.push_back(' ' + below(95));
+        line.push_back('\n');
+        return line;
+    }
+
+    // A stray 0x00 from a terminal in the middle of a typed line. The
+    // console must get its text back at the next line end that can't be
+    // part of a frame: right away when the text after the zero starts
+    // like a command, at the latest FRAME_MAX_COBS bytes on.
+    void strayDelimiter() {
+        Bytes stream = typedLine(20);
+        size_t zeroAt = below(stream.size());
+        stream.insert(stream.begin() + zeroAt, FRAME_DELIMITER);
+        bool command = stream[zeroAt + 1] >= 'a' && stream[zeroAt + 1] <= 'z';
+
+        if (!command) {
+            while (stream.size() - zeroAt <= FRAME_MAX_COBS) {
+                Bytes line = typedLine(20);
+                stream.insert(stream.end(), line.begin(), line.end());
+            }
+        }
+        const char* abort = "abort\n";
+        stream.insert(stream.end(), abort, abort + strlen(abort));
+
+        Bytes seen;
+        decodeStream(stream, &seen, false);
+        if (!endsWith(seen, abort)) {
+            fail("console text lost after a stray 0x00", stream);
+        }
+    }
+
+    // A frame damaged on the wire (no 0x00 added or lost) must not take
+    // the console text after it
+    void corruptThenText() {
+        Bytes frame = makeFrame(below(256), below(256), randomPayload(FRAME_MAX_PAYLOAD));
+        size_t at = 1 + below(frame.size() - 2);
+        uint8_t flipped = frame[at] ^ (1 << below(8));
+        if (flipped != FRAME_DELIMITER) frame[at] = flipped;
+
+        Bytes stream = frame;
+        const char* abort = "abort\n";
+        stream.insert(stream.end(), abort, abort + strlen(abort));
+        Bytes seen;
+        decodeStream(stream, &seen, false);
+        if (!endsWith(seen, abort)) {
+            fail("console text lost after a corrupt frame", stream);
+        }
+    }
+
+    // Any byte value, escaped, comes back unchanged and opens no frame
+    void textPassThrough() {
+        Bytes text = below(2) ? logOutput() : randomPayload(64);
+        Bytes stream;
+        appendEscaped(stream, text);
+        Bytes seen;
+        std::vector<Bytes> frames = decodeStream(stream, &seen);
+        if (!frames.empty() || seen != text) {
+            fail("text not passed through", stream);
+        }
+    }
+
+    // One round of every case
+    void iteration() {
+        roundTrip();
+        oversized();
+        corrupt();
+        resync();
+        textPassThrough();
+        strayDelimiter();
+        corruptThenText();
+    }
+
+    // Undetected corruption should be CRC-16 collisions only
+    static long allowedUndetected(long iterations) {
+        return iterations / 10000 + 2;
+    }
+};
+
+
+#endif // FRAME_FUZZ_H
@@ -0,0 +1,148 @@
+/**
+ * Frame Protocol Host Tool
+ *
+ * Uses the same lib/FrameProtocol code as the firmware.
+ *
+ *   frametool encode <type> <seq> [payload hex]   Frame bytes as hex
+ *   frametool decode < capture.bin                Frames, text and log records
+ *   frametool fuzz [iterations] [seed]            Round-trip and corruption fuzzing
+ *
+ * Build (from the repo root):
+ *   g++ -std=c++11 -O2 -Ilib/FrameProtocol tools/frametool.cpp \
+ *       lib/FrameProtocol/FrameProtocol.cpp -o frametool
+ * Add -fsanitize=address,undefined -g when fuzzing after a change.
+ */
+
+#include "frame_fuzz.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+static void printHex(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        printf("%02x", data[i]);
+    }
+}
+
+static bool parseHex(const char* text, Bytes& out) {
+    size_t length = strlen(text);
+    if (length % 2) return false;
+    for (size_t i = 0; i < length; i += 2) {
+        char pair[3] = { text[i], text[i + 1], 0 };
+        char* end;
+        long value = strtol(pair, &end, 16);
+        if (*end) return false;
+        out.push_back((uint8_t)value);
+    }
+    return true;
+}
+
+// ===========================================
+// encode / decode
+// ===========================================
+
+static int commandEncode(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: frametool encode <type> <seq> [payload hex]\n");
+        return 2;
+    }
+    Bytes payload;
+    if (argc >= 3 && !parseHex(argv[2], payload)) {
+        fprintf(stderr, "bad payload hex\n");
+        return 2;
+    }
+    Bytes frame = makeFrame((uint8_t)strtol(argv[0], NULL, 0), (uint8_t)strtol(argv[1], NULL, 0), payload);
+    if (frame.empty()) {
+        fprintf(stderr, "payload too long (max %d bytes)\n", FRAME_MAX_PAYLOAD);
+        return 1;
+    }
+    printHex(frame.data(), frame.size());
+    printf("\n");
+    return 0;
+}
+
+static void printText(std::string& text) {
+    printf("text  %s\n", text.c_str());
+    text.clear();
+}
+
+static int commandDecode() {
+    FrameDecoder decoder;
+    frameDecoderReset(decoder);
+    Frame frame;
+    std::string text;
+    Bytes record;               // Log record being collected
+    bool escaped = false;
+    int bad = 0;
+
+    int c;
+    while ((c = getchar()) != EOF) {
+        uint8_t byte = (uint8_t)c;
+        switch (frameDecoderPush(decoder, byte, frame)) {
+            case FRAME_READY:
+                if (!text.empty()) printText(text);
+                printf("frame type=0x%02x seq=%u len=%u payload=", frame.type, frame.seq, frame.length);
+                printHex(frame.payload, frame.length);
+                printf("\n");
+                break;
+            case FRAME_BAD:
+                bad++;
+                break;
+            case FRAME_TEXT:
+                if (!frameTextUnescape(escaped, byte)) break;
+                if (!record.empty() || byte == LOG_RECORD_START) {
+                    record.push_back(byte);
+                    if (record.size() >= 3 && record.size() == (size_t)(LOG_RECORD_HEADER + record[2])) {
+                        if (!text.empty()) printText(text);
+                        printf("log   id=%u ms=%u args=", record[1], frameGetU32(record.data() + 3));
+                        printHex(record.data() + LOG_RECORD_HEADER, record[2]);
+                        printf("\n");
+                        record.clear();
+                    }
+                } else if (byte == '\n') {
+                    printText(text);
+                } else if (byte != '\r') {
+                    text += (char)byte;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (!text.empty()) printf("text  %s\n", text.c_str());
+    if (!record.empty()) printf("%u byte(s) of an unfinished log record\n", (unsigned)record.size());
+    if (bad) printf("%d corrupt frame(s) skipped\n", bad);
+    return 0;
+}
+
+// ===========================================
+// fuzz
+// ===========================================
+
+
+static int commandFuzz(int argc, char** argv) {
+    long iterations = (argc >= 1) ? atol(argv[0]) : 100000;
+    unsigned seed = (argc >= 2) ? (unsigned)atol(argv[1]) : std::random_device()();
+    Fuzzer fuzzer(seed);
+
+    for (long i = 0; i < iterations; i++) fuzzer.iteration();
+
+    long allowed = Fuzzer::allowedUndetected(iterations);
+    printf("fuzz: %ld iterations, seed %u, %ld failures, %ld undetected corruptions (max %ld)\n",
+           iterations, seed, fuzzer.failures, fuzzer.undetected, allowed);
+    return (fuzzer.failures == 0 && fuzzer.undetected <= allowed) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && !strcmp(argv[1], "encode")) return commandEncode(argc - 2, argv + 2);
+    if (argc >= 2 && !strcmp(argv[1], "decode")) return commandDecode();
+    if (argc >= 2 && !strcmp(argv[1], "fuzz")) return commandFuzz(argc - 2, argv + 2);
+
+    fprintf(stderr,
+            "usage: frametool encode <type> <seq> [payload hex]\n"
+            "       frametool decode < capture.bin\n"
+            "       frametool fuzz [iterations] [seed]\n");
+    return 2;
+}
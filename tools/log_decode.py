@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""
+Decode the device's Serial log.
+
+Plain text passes through unchanged. Binary records from the LOG_*
+macros (0x1F, id, arg bytes, millis, args) are turned back into text
+using the message table generated from src/log_messages.h, so the
+table always matches the source tree it is run from. Binary protocol
+frames (0x00 ... 0x00, lib/FrameProtocol) in the same stream are
+skipped, and the escaping of 0x00 in the log is undone.
+
+    python tools/log_decode.py capture.bin
+    python tools/log_decode.py --port /dev/ttyACM0   (needs pyserial)
+    python tools/log_decode.py --table               (print the table)
+    python tools/log_decode.py capture.bin --timeline run.json
+
+--timeline also writes the records as Chrome trace-event JSON
+(chrome://tracing, ui.perfetto.dev) with the tracks the log has: the
+run and its phases (MSG_PHASE is DEBUG level), the readiness and
+learned waits, and every other record as a point on a log track. The
+simulator's `run --timeline` adds keys, LCD, I2C and pins.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+RECORD_START = 0x1F
+FRAME_DELIMITER = 0x00
+TEXT_ESCAPE = 0x1E  # FRAME_TEXT_ESCAPE, then byte ^ 0x20
+TEXT_XOR = 0x20
+LEVEL_NAMES = {
+    "LOG_LEVEL_ERROR": "ERROR",
+    "LOG_LEVEL_WARN": "WARN",
+    "LOG_LEVEL_INFO": "INFO",
+    "LOG_LEVEL_DEBUG": "DEBUG",
+}
+
+# Format specifier -> struct code (AVR is little-endian)
+ARG_FORMATS = {
+    "%lu": "<I",
+    "%ld": "<i",
+    "%b": "<B",
+    "%u": "<H",
+    "%d": "<h",
+    "%w": "<B",
+}
+SPEC_RE = re.compile(r"%lu|%ld|%b|%u|%d|%w")
+
+
+def generate_table():
+    """Message table: list of (name, level, format) in ID order."""
+    source = (ROOT / "src" / "log_messages.h").read_text()
+    entries = re.findall(r'X\((\w+),\s*(\w+),\s*"((?:[^"\\]|\\.)*)"\)', source)
+    return [(name, LEVEL_NAMES.get(level, level), fmt) for name, level, fmt in entries]
+
+
+def wait_step_names():
+    source = (ROOT / "src" / "wait_tuning.cpp").read_text()
+    return re.findall(r'static const char name\d+\[\] PROGMEM = "([^"]*)";', source)
+
+
+def phase_names():
+    source = (ROOT / "src" / "telemetry.cpp").read_text()
+    return re.findall(r'static const char phaseName\d+\[\] PROGMEM = "([^"]*)";', source)
+
+
+def unpack_args(fmt, args):
+    """Argument values in format order, None if the sizes don't add up."""
+    values = []
+    offset = 0
+    for spec in SPEC_RE.findall(fmt):
+        code = ARG_FORMATS[spec]
+        if offset + struct.calcsize(code) > len(args):
+            return None
+        values += struct.unpack_from(code, args, offset)
+        offset += struct.calcsize(code)
+    return values if offset == len(args) else None
+
+
+def record_text(table, steps, msg_id, args):
+    name, level, fmt = table[msg_id]
+    values = unpack_args(fmt, args)
+    if values is None:
+        return f"{fmt}  [arg size mismatch: {name}, {args.hex()}]"
+
+    def substitute(match):
+        value = values.pop(0)
+        if match.group(0) == "%w" and value < len(steps):
+            return steps[value]
+        return str(value)
+
+    return SPEC_RE.sub(substitute, fmt)
+
+
+def format_record(table, steps, msg_id, timestamp, args):
+    if msg_id >= len(table):
+        return f"[{timestamp / 1000:10.3f}] ?????  unknown message {msg_id} ({args.hex()})"
+    level = table[msg_id][1]
+    return f"[{timestamp / 1000:10.3f}] {level:<5}  {record_text(table, steps, msg_id, args)}"
+
+
+class Decoder:
+    """Streaming decoder: feed() bytes, get complete output lines."""
+
+    def __init__(self, table, steps, timeline=None):
+        self.table = table
+        self.steps = steps
+        self.timeline = timeline
+        self.pending = bytearray()
+        self.text = bytearray()
+        self.in_frame = False
+        self.frame_length = 0
+        self.escaped = False
+
+    def unescape(self, data):
+        """Log bytes from the wire: frames dropped, escapes undone."""
+        for byte in data:
+            if self.in_frame:
+                if byte != FRAME_DELIMITER:
+                    self.frame_length += 1
+                elif self.frame_length:
+                    self.in_frame = False   # Back-to-back zeros are a gap
+            elif byte == FRAME_DELIMITER:
+                self.in_frame = True
+                self.frame_length = 0
+            elif self.escaped:
+                self.escaped = False
+                self.pending.append(byte ^ TEXT_XOR)
+            elif byte == TEXT_ESCAPE:
+                self.escaped = True
+            else:
+                self.pending.append(byte)
+
+    def feed(self, data):
+        self.unescape(data)
+        lines = []
+        while self.pending:
+            if self.pending[0] != RECORD_START:
+                byte = self.pending.pop(0)
+                if byte == ord("\n"):
+                    lines.append(self.text.decode("ascii", "replace").rstrip("\r"))
+                    self.text.clear()
+                else:
+                    self.text.append(byte)
+                continue
+
+            if len(self.pending) < 3:
+                break
+            length = self.pending[2]
+            size = 7 + length
+            if len(self.pending) < size:
+                break
+
+            msg_id = self.pending[1]
+            (timestamp,) = struct.unpack_from("<I", self.pending, 3)
+            args = bytes(self.pending[7:size])
+            del self.pending[:size]
+
+            # A record can land in the middle of a text line
+            if self.text:
+                lines.append(self.text.decode("ascii", "replace").rstrip("\r"))
+                self.text.clear()
+            lines.append(format_record(self.table, self.steps, msg_id, timestamp, args))
+            if self.timeline:
+                self.timeline.add(msg_id, timestamp, args)
+        return lines
+
+
+class Timeline:
+    """Chrome trace events from decoded records (timestamps in ms)."""
+
+    TRACKS = ["run", "phases", "waits", "log"]
+    WAIT_OUTCOMES = {
+        "MSG_READY_ECHO": "ready",
+        "MSG_READY_TIMEOUT": "timeout",
+        "MSG_READY_SKIPPED": "skipped",
+        "MSG_WAIT_SKIP": "skipped early",
+    }
+
+    def __init__(self, table, steps, phases):
+        self.table = table
+        self.steps = steps
+        self.phases = phases
+        self.events = []
+        self.run_start = None
+        self.phase = None       # (name, start)
+        self.last = 0
+
+    def span(self, track, name, start, end, args=None):
+        event = {"ph": "X", "pid": 1, "tid": self.TRACKS.index(track) + 1, "name": name,
+                 "ts": start * 1000, "dur": max(end - start, 0) * 1000}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def close_phase(self, at):
+        if self.phase:
+            self.span("phases", self.phase[0], self.phase[1], at)
+            self.phase = None
+
+    def add(self, msg_id, timestamp, args):
+        self.last = timestamp
+        if msg_id >= len(self.table):
+            return
+        name, level, fmt = self.table[msg_id]
+        values = unpack_args(fmt, args)
+
+        if name == "MSG_RUN_START":
+            self.run_start = timestamp
+        elif name == "MSG_RUN_SAVED":
+            self.close_phase(timestamp)
+            if self.run_start is not None:
+                self.span("run", "run", self.run_start, timestamp)
+                self.run_start = None
+        elif name == "MSG_PHASE" and values:
+            self.close_phase(timestamp)
+            phase = values[0]
+            self.phase = (self.phases[phase] if phase < len(self.phases) else f"phase {phase}", timestamp)
+        elif name in self.WAIT_OUTCOMES and values:
+            # Logged when the wait ends, with how long it took
+            step, waited = values[0], values[1]
+            step_name = self.steps[step] if step < len(self.steps) else f"step {step}"
+            self.span("waits", step_name, timestamp - waited, timestamp,
+                      {"outcome": self.WAIT_OUTCOMES[name], "ms": waited})
+        if name != "MSG_PHASE":
+            self.events.append({"ph": "i", "s": "t", "pid": 1, "tid": self.TRACKS.index("log") + 1,
+                                "name": record_text(self.table, self.steps, msg_id, args),
+                                "ts": timestamp * 1000, "args": {"level": level}})
+
+    def write(self, path):
+        # A capture that stops mid-run still shows what it has
+        self.close_phase(self.last)
+        if self.run_start is not None:
+            self.span("run", "run (unfinished)", self.run_start, self.last)
+            self.run_start = None
+
+        meta = [{"ph": "M", "pid": 1, "tid": 0, "name": "process_name", "args": {"name": "device log"}}]
+        for tid, track in enumerate(self.TRACKS, 1):
+            meta.append({"ph": "M", "pid": 1, "tid": tid, "name": "thread_name", "args": {"name": track}})
+            meta.append({"ph": "M", "pid": 1, "tid": tid, "name": "thread_sort_index",
+                         "args": {"sort_index": tid}})
+        with open(path, "w") as file:
+            json.dump({"displayTimeUnit": "ms", "traceEvents": meta + self.events}, file, indent=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="Raw Serial capture (default: stdin)")
+    parser.add_argument("--port", help="Read live from a serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--table", action="store_true", help="Print the message table and exit")
+    parser.add_argument("--timeline", metavar="FILE", help="Also write Chrome trace-event JSON")
+    options = parser.parse_args()
+    if options.timeline and options.port:
+        parser.error("--timeline needs a capture (the port never ends)")
+
+    table = generate_table()
+    if options.table:
+        for msg_id, (name, level, fmt) in enumerate(table):
+            print(f"{msg_id:3}  {level:<5}  {name:<20}  {fmt}")
+        return
+
+    steps = wait_step_names()
+    timeline = Timeline(table, steps, phase_names()) if options.timeline else None
+    decoder = Decoder(table, steps, timeline)
+
+    if options.port:
+        import serial  # pyserial
+
+        with serial.Serial(options.port, options.baud, timeout=0.1) as port:
+            while True:
+                for line in decoder.feed(port.read(256)):
+                    print(line, flush=True)
+
+    stream = open(options.capture, "rb") if options.capture else sys.stdin.buffer
+    with stream:
+        while True:
+            chunk = stream.read(4096)
+            if not chunk:
+                break
+            for line in decoder.feed(chunk):
+                print(line)
+    if decoder.text:
+        print(decoder.text.decode("ascii", "replace"))
+    if timeline:
+        timeline.write(options.timeline)
+
+
+if __name__ == "__main__":
+    main()